@@ -1,9 +1,71 @@
-QT += widgets
+QT += widgets concurrent
 CONFIG += c++17
 
-SOURCES += main.cpp
+# qmake CONFIG+=tracing : scoped spans, F12 perf overlay, Ctrl+Shift+T Chrome trace dump
+tracing: DEFINES += FITTRACK_TRACING
+# qmake CONFIG+=allocstats : per-action allocation counts (F11), FITTRACK_ALLOC_REPORT=<csv> on exit
+allocstats: DEFINES += FITTRACK_ALLOC_STATS
+
+SOURCES += main.cpp \
+    activityview.cpp \
+    allocstats.cpp \
+    analytics.cpp \
+    batchreport.cpp \
+    benchmark.cpp \
+    bulkentry.cpp \
+    bwtrend.cpp \
+    calories.cpp \
+    cipher.cpp \
+    crc32c.cpp \
+    datafile.cpp \
+    datparser.cpp \
+    fitfile.cpp \
+    geo.cpp \
+    heatmap.cpp \
+    historymodel.cpp \
+    leaderboard.cpp \
+    pdfreport.cpp \
+    progress.cpp \
+    records.cpp \
+    reportcharts.cpp \
+    reports.cpp \
+    routeimport.cpp \
+    samplestore.cpp \
+    securestore.cpp \
+    traceoverlay.cpp \
+    tracing.cpp \
+    trainingload.cpp
 
 HEADERS += \
-    # (if you move classes to headers list them here)
+    activityview.h \
+    allocstats.h \
+    analytics.h \
+    batchreport.h \
+    benchmark.h \
+    bulkentry.h \
+    bwtrend.h \
+    calories.h \
+    cipher.h \
+    crc32c.h \
+    datafile.h \
+    datparser.h \
+    fitfile.h \
+    geo.h \
+    heatmap.h \
+    historymodel.h \
+    leaderboard.h \
+    models.h \
+    pdfreport.h \
+    persistentvector.h \
+    progress.h \
+    records.h \
+    reportcharts.h \
+    reports.h \
+    routeimport.h \
+    samplestore.h \
+    securestore.h \
+    traceoverlay.h \
+    tracing.h \
+    trainingload.h
 
 RESOURCES += resources.qrc  # if you use a qrc file for :/gymbg.jpeg
@@ -0,0 +1,175 @@
+// activityview.cpp
+#include "activityview.h"
+#include "tracing.h"
+
+#include <QDialogButtonBox>
+#include <QGridLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPainter>
+#include <QProgressBar>
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+struct Lane { const char *name; const char *unit; double factor; QColor color; };
+// speed is stored in m/s and shown in km/h
+const Lane Lanes[SampleSeries::ChannelCount] = {
+    {"Heart rate", "bpm", 1.0, QColor("#EE6352")},
+    {"Speed", "km/h", 3.6, QColor("#FF5F1F")},
+    {"Cadence", "rpm", 1.0, QColor("#59CD90")},
+    {"Altitude", "m", 1.0, QColor("#3FA7D6")},
+};
+constexpr int LeftMargin = 52, LaneGap = 8, AxisHeight = 20;
+
+QString clock(qint64 seconds)
+{
+    return seconds >= 3600 ? QString("%1:%2:%3").arg(seconds / 3600).arg(seconds / 60 % 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'))
+                           : QString("%1:%2").arg(seconds / 60).arg(seconds % 60, 2, 10, QChar('0'));
+}
+
+} // namespace
+
+SampleChart::SampleChart(QWidget *parent) : QWidget(parent)
+{
+    setMinimumHeight(320);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+void SampleChart::setSamples(SampleSeries s)
+{
+    series = std::move(s);
+    envelopeColumns = -1;
+    update();
+}
+
+void SampleChart::buildEnvelopes(int columns)
+{
+    FT_TRACE_SCOPE("SampleChart::buildEnvelopes");
+    envelopeColumns = columns;
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const qint64 t0 = series.time.front(), span = qMax<qint64>(1, series.time.back() - t0);
+    for (int c = 0; c < SampleSeries::ChannelCount; ++c) {
+        envelope[c].assign(size_t(columns), {nan, nan});
+        if (!series.has(SampleSeries::Channel(c))) continue;
+        low[c] = std::numeric_limits<double>::max(); high[c] = std::numeric_limits<double>::lowest();
+        const std::vector<double> &v = series.values[c];
+        for (size_t i = 0; i < v.size(); ++i) {
+            if (std::isnan(v[i])) continue;
+            const double y = v[i] * Lanes[c].factor;
+            auto &e = envelope[c][size_t(qMin<qint64>(columns - 1, (series.time[i] - t0) * columns / span))];
+            if (std::isnan(e.first)) e = {float(y), float(y)};
+            else { e.first = qMin(e.first, float(y)); e.second = qMax(e.second, float(y)); }
+            low[c] = qMin(low[c], y); high[c] = qMax(high[c], y);
+        }
+        if (high[c] - low[c] < 1e-9) { low[c] -= 1; high[c] += 1; }
+    }
+}
+
+void SampleChart::paintEvent(QPaintEvent *)
+{
+    FT_TRACE_SCOPE("SampleChart::paint");
+    QPainter p(this);
+    p.fillRect(rect(), QColor(5, 18, 27));
+    int lanes = 0;
+    for (int c = 0; c < SampleSeries::ChannelCount; ++c) lanes += series.has(SampleSeries::Channel(c));
+    if (series.time.size() < 2 || !lanes) {
+        p.setPen(QColor("#b8c8d8"));
+        p.drawText(rect(), Qt::AlignCenter, "This activity has no sensor samples");
+        return;
+    }
+    const QRect plot = rect().adjusted(LeftMargin, 8, -12, -AxisHeight);
+    if (plot.width() != envelopeColumns) buildEnvelopes(plot.width());
+
+    const double laneH = (plot.height() - LaneGap * (lanes - 1)) / double(lanes);
+    double top = plot.top();
+    for (int c = 0; c < SampleSeries::ChannelCount; ++c) {
+        if (!series.has(SampleSeries::Channel(c))) continue;
+        const QRectF lane(plot.left(), top, plot.width(), laneH);
+        auto y = [&](double v) { return lane.bottom() - (v - low[c]) / (high[c] - low[c]) * lane.height(); };
+        p.setPen(QPen(QColor(20, 50, 70), 1));
+        p.drawLine(lane.bottomLeft(), lane.bottomRight());
+        p.setPen(QColor("#b8c8d8"));
+        p.drawText(QRectF(0, lane.top(), LeftMargin - 6, 16), Qt::AlignRight | Qt::AlignVCenter, QString::number(high[c], 'f', 0));
+        p.drawText(QRectF(0, lane.bottom() - 16, LeftMargin - 6, 16), Qt::AlignRight | Qt::AlignVCenter, QString::number(low[c], 'f', 0));
+        p.drawText(lane.adjusted(6, 2, 0, 0), Qt::AlignLeft | Qt::AlignTop, QString("%1 (%2)").arg(Lanes[c].name, Lanes[c].unit));
+
+        // one vertical stroke per column from its min to its max, joined to the next column
+        p.setPen(QPen(Lanes[c].color, 1.2));
+        const auto &env = envelope[c];
+        QPointF last(-1, 0);
+        for (size_t x = 0; x < env.size(); ++x) {
+            if (std::isnan(env[x].first)) continue;
+            const double px = plot.left() + double(x) + 0.5;
+            const QPointF lo(px, y(env[x].first)), hi(px, y(env[x].second));
+            if (last.x() >= 0 && px - last.x() <= 3) p.drawLine(last, QPointF(px, (lo.y() + hi.y()) / 2));
+            if (lo != hi) p.drawLine(lo, hi);
+            last = QPointF(px, (lo.y() + hi.y()) / 2);
+        }
+        top += laneH + LaneGap;
+    }
+
+    // time axis
+    p.setPen(QColor("#b8c8d8"));
+    const qint64 totalS = (series.time.back() - series.time.front()) / 1000;
+    for (int i = 0; i <= 4; ++i) {
+        const int x = plot.left() + plot.width() * i / 4;
+        p.drawText(QRect(x - 40, plot.bottom() + 2, 80, AxisHeight - 2), Qt::AlignCenter, clock(totalS * i / 4));
+    }
+}
+
+ActivityDialog::ActivityDialog(const CardioWorkout &w, SampleSeries samples, QWidget *parent) : QDialog(parent)
+{
+    setWindowTitle(QString("%1 - %2").arg(w.type, w.date));
+    resize(900, 680);
+    auto *lo = new QVBoxLayout(this);
+
+    QString head = QString("%1 km in %2 min, %3 km/h").arg(w.distance, 0, 'f', 2).arg(w.duration).arg(w.avgSpeed, 0, 'f', 1);
+    if (w.elevationGain > 0) head += QString(", %1 m climbed").arg(w.elevationGain, 0, 'f', 0);
+    if (w.heartRate.average) head += QString(", heart rate %1 avg / %2 max").arg(w.heartRate.average).arg(w.heartRate.maximum);
+    auto *headLbl = new QLabel(head);
+    headLbl->setStyleSheet("font-weight:900; font-size:14px;");
+    lo->addWidget(headLbl);
+
+    auto *chart = new SampleChart;
+    chart->setSamples(std::move(samples));
+    lo->addWidget(chart, 1);
+
+    auto *bottom = new QHBoxLayout;
+    if (w.heartRate.average) {
+        auto *zones = new QGridLayout;
+        static const char *names[5] = {"Z1 recovery (<60%)", "Z2 endurance (60-70%)", "Z3 tempo (70-80%)", "Z4 threshold (80-90%)", "Z5 maximum (90%+)"};
+        int total = 0;
+        for (int z = 0; z < 5; ++z) total += w.heartRate.zoneSeconds[z];
+        for (int z = 0; z < 5; ++z) {
+            zones->addWidget(new QLabel(names[z]), z, 0);
+            auto *bar = new QProgressBar;
+            bar->setRange(0, qMax(1, total));
+            bar->setValue(w.heartRate.zoneSeconds[z]);
+            bar->setFormat(clock(w.heartRate.zoneSeconds[z]));
+            zones->addWidget(bar, z, 1);
+        }
+        bottom->addLayout(zones, 1);
+    }
+    if (!w.splits.empty()) {
+        auto *splits = new QTableWidget(int(w.splits.size()), 2);
+        splits->setHorizontalHeaderLabels({"Km", "Split"});
+        splits->verticalHeader()->hide();
+        splits->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+        splits->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        for (size_t k = 0; k < w.splits.size(); ++k) {
+            splits->setItem(int(k), 0, new QTableWidgetItem(QString::number(k + 1)));
+            splits->setItem(int(k), 1, new QTableWidgetItem(w.splits[k] > 0 ? clock(w.splits[k]) : QString("-")));
+        }
+        splits->setMaximumHeight(170);
+        bottom->addWidget(splits, 1);
+    }
+    lo->addLayout(bottom);
+
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Close);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    lo->addWidget(buttons);
+}
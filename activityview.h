@@ -0,0 +1,37 @@
+#ifndef ACTIVITYVIEW_H
+#define ACTIVITYVIEW_H
+
+// FitTrack Pro - one imported activity: its sensor streams over time, heart-rate zones and km splits
+// The chart reduces each stream to a min/max envelope per pixel column once per width, so a
+// marathon's worth of samples repaints as cheaply as a short run.
+#include <QDialog>
+#include <QWidget>
+#include <utility>
+#include <vector>
+#include "models.h"
+#include "samplestore.h"
+
+// One lane per recorded channel, sharing the time axis
+class SampleChart : public QWidget {
+public:
+    explicit SampleChart(QWidget *parent = nullptr);
+    void setSamples(SampleSeries s);
+
+protected:
+    void paintEvent(QPaintEvent *) override;
+
+private:
+    void buildEnvelopes(int columns);
+
+    SampleSeries series;
+    std::vector<std::pair<float, float>> envelope[SampleSeries::ChannelCount]; // per column; NaN where empty
+    double low[SampleSeries::ChannelCount] = {}, high[SampleSeries::ChannelCount] = {};
+    int envelopeColumns = -1;
+};
+
+class ActivityDialog : public QDialog {
+public:
+    ActivityDialog(const CardioWorkout &w, SampleSeries samples, QWidget *parent = nullptr);
+};
+
+#endif // ACTIVITYVIEW_H
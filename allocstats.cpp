@@ -0,0 +1,237 @@
+// allocstats.cpp
+#include "allocstats.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+
+#ifdef FITTRACK_ALLOC_STATS
+#if defined(__GLIBC__)
+#include <cerrno>
+#include <malloc.h>
+#endif
+#endif
+
+namespace AllocStats {
+
+namespace {
+
+// Constant-initialized so allocations made before main() are counted safely
+std::atomic<quint64> gAllocs{0};
+std::atomic<quint64> gFrees{0};
+std::atomic<quint64> gBytes{0};
+std::atomic<qint64> gLive{0};
+std::atomic<qint64> gPeakMark{0}; // max live since the innermost open scope started
+
+void raisePeak(qint64 v)
+{
+    qint64 cur = gPeakMark.load(std::memory_order_relaxed);
+    while (v > cur && !gPeakMark.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+}
+
+std::mutex statsMutex;
+std::map<std::string, RegionStats> &statsTable()
+{
+    static std::map<std::string, RegionStats> table;
+    return table;
+}
+
+} // namespace
+
+// Called from the allocator hooks below: atomics only, never allocates
+inline void noteAlloc(size_t n)
+{
+    gAllocs.fetch_add(1, std::memory_order_relaxed);
+    gBytes.fetch_add(n, std::memory_order_relaxed);
+    raisePeak(gLive.fetch_add(qint64(n), std::memory_order_relaxed) + qint64(n));
+}
+
+inline void noteFree(size_t n)
+{
+    gFrees.fetch_add(1, std::memory_order_relaxed);
+    gLive.fetch_sub(qint64(n), std::memory_order_relaxed);
+}
+
+bool enabled()
+{
+#ifdef FITTRACK_ALLOC_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+Counters current()
+{
+    Counters c;
+    c.allocs = gAllocs.load(std::memory_order_relaxed);
+    c.frees = gFrees.load(std::memory_order_relaxed);
+    c.bytes = gBytes.load(std::memory_order_relaxed);
+    c.live = gLive.load(std::memory_order_relaxed);
+    return c;
+}
+
+Scope::Scope(const char *n) : name(n), start(current())
+{
+    outerPeak = gPeakMark.exchange(start.live, std::memory_order_relaxed);
+}
+
+Scope::~Scope()
+{
+    const Counters end = current();
+    const qint64 peak = gPeakMark.load(std::memory_order_relaxed);
+    raisePeak(outerPeak); // an enclosing scope keeps the higher of both marks
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    RegionStats &r = statsTable()[name];
+    if (r.name.isEmpty()) r.name = QString::fromUtf8(name);
+    r.calls++;
+    r.lastAllocs = end.allocs - start.allocs;
+    r.lastBytes = end.bytes - start.bytes;
+    r.allocs += r.lastAllocs;
+    r.frees += end.frees - start.frees;
+    r.bytes += r.lastBytes;
+    r.maxPeak = qMax(r.maxPeak, peak - start.live);
+}
+
+std::vector<RegionStats> regions()
+{
+    std::vector<RegionStats> out;
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        for (auto &kv : statsTable()) out.push_back(kv.second);
+    }
+    std::sort(out.begin(), out.end(), [](const RegionStats &a, const RegionStats &b) { return a.bytes > b.bytes; });
+    return out;
+}
+
+void reset()
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    statsTable().clear();
+}
+
+bool writeReport(const QString &path, QString *error)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+    QTextStream out(&f);
+    out << "region,calls,allocs,frees,bytes,allocs_per_call,bytes_per_call,max_peak_bytes,last_allocs,last_bytes\n";
+    for (const RegionStats &r : regions()) {
+        const double calls = qMax<quint64>(1, r.calls);
+        out << r.name << "," << r.calls << "," << r.allocs << "," << r.frees << "," << r.bytes << ","
+            << QString::number(r.allocs / calls, 'f', 1) << "," << QString::number(r.bytes / calls, 'f', 0) << ","
+            << r.maxPeak << "," << r.lastAllocs << "," << r.lastBytes << "\n";
+    }
+    const Counters c = current();
+    out << "#process," << 0 << "," << c.allocs << "," << c.frees << "," << c.bytes << ",,,," << c.live << ",\n";
+    out.flush();
+    return true;
+}
+
+} // namespace AllocStats
+
+#ifdef FITTRACK_ALLOC_STATS
+#if defined(__GLIBC__)
+// Interpose the C allocator so QString/QList (QArrayData uses malloc) are counted as well as new.
+// Sizes come from malloc_usable_size, so no header is needed and memalign'd blocks free correctly.
+extern "C" {
+void *__libc_malloc(size_t n);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *p, size_t n);
+void *__libc_memalign(size_t align, size_t n);
+void __libc_free(void *p);
+
+void *malloc(size_t n) noexcept
+{
+    void *p = __libc_malloc(n);
+    if (p) AllocStats::noteAlloc(malloc_usable_size(p));
+    return p;
+}
+
+void *calloc(size_t n, size_t size) noexcept
+{
+    void *p = __libc_calloc(n, size);
+    if (p) AllocStats::noteAlloc(malloc_usable_size(p));
+    return p;
+}
+
+void *realloc(void *p, size_t n) noexcept
+{
+    const size_t old = p ? malloc_usable_size(p) : 0;
+    void *q = __libc_realloc(p, n);
+    if (q || n == 0) {
+        if (p) AllocStats::noteFree(old);
+        if (q) AllocStats::noteAlloc(malloc_usable_size(q));
+    }
+    return q;
+}
+
+void *memalign(size_t align, size_t n) noexcept
+{
+    void *p = __libc_memalign(align, n);
+    if (p) AllocStats::noteAlloc(malloc_usable_size(p));
+    return p;
+}
+
+void *aligned_alloc(size_t align, size_t n) noexcept { return memalign(align, n); }
+
+int posix_memalign(void **out, size_t align, size_t n) noexcept
+{
+    void *p = memalign(align, n);
+    if (!p) return ENOMEM;
+    *out = p;
+    return 0;
+}
+
+void free(void *p) noexcept
+{
+    if (!p) return;
+    AllocStats::noteFree(malloc_usable_size(p));
+    __libc_free(p);
+}
+}
+#else
+// Portable fallback: size header in front of every operator new block
+namespace {
+constexpr size_t kHeader = alignof(std::max_align_t);
+
+void *countedAlloc(size_t n)
+{
+    void *raw = std::malloc(n + kHeader);
+    if (!raw) return nullptr;
+    *static_cast<size_t *>(raw) = n;
+    AllocStats::noteAlloc(n);
+    return static_cast<char *>(raw) + kHeader;
+}
+
+void countedFree(void *p)
+{
+    if (!p) return;
+    char *raw = static_cast<char *>(p) - kHeader;
+    AllocStats::noteFree(*reinterpret_cast<size_t *>(raw));
+    std::free(raw);
+}
+} // namespace
+
+void *operator new(size_t n) { if (void *p = countedAlloc(n)) return p; throw std::bad_alloc(); }
+void *operator new[](size_t n) { if (void *p = countedAlloc(n)) return p; throw std::bad_alloc(); }
+void *operator new(size_t n, const std::nothrow_t &) noexcept { return countedAlloc(n); }
+void *operator new[](size_t n, const std::nothrow_t &) noexcept { return countedAlloc(n); }
+void operator delete(void *p) noexcept { countedFree(p); }
+void operator delete[](void *p) noexcept { countedFree(p); }
+void operator delete(void *p, size_t) noexcept { countedFree(p); }
+void operator delete[](void *p, size_t) noexcept { countedFree(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { countedFree(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { countedFree(p); }
+#endif
+#endif
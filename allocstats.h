@@ -0,0 +1,64 @@
+#ifndef ALLOCSTATS_H
+#define ALLOCSTATS_H
+
+// FitTrack Pro - allocation accounting (build with "qmake CONFIG+=allocstats")
+// FT_ALLOC_SCOPE("name") attributes allocations, bytes and peak live memory made while the
+// scope is open (on any thread) to the named region. On glibc malloc/free are interposed so
+// Qt containers are counted too; elsewhere only global operator new/delete are.
+// Without FITTRACK_ALLOC_STATS the macro expands to nothing.
+#include <QString>
+#include <QtGlobal>
+#include <vector>
+
+namespace AllocStats {
+
+struct Counters {
+    quint64 allocs = 0;
+    quint64 frees = 0;
+    quint64 bytes = 0; // total allocated
+    qint64 live = 0;   // currently allocated
+};
+
+struct RegionStats {
+    QString name;
+    quint64 calls = 0;
+    quint64 allocs = 0;
+    quint64 frees = 0;
+    quint64 bytes = 0;
+    qint64 maxPeak = 0;  // highest live growth over the region's starting point
+    quint64 lastAllocs = 0;
+    quint64 lastBytes = 0;
+};
+
+bool enabled(); // compiled into this build
+Counters current();
+std::vector<RegionStats> regions(); // sorted by bytes, descending
+void reset();
+
+// CSV, one row per region; diff two of these across releases
+bool writeReport(const QString &path, QString *error = nullptr);
+
+class Scope {
+public:
+    explicit Scope(const char *n);
+    ~Scope();
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *name;
+    Counters start;
+    qint64 outerPeak;
+};
+
+} // namespace AllocStats
+
+#ifdef FITTRACK_ALLOC_STATS
+#define FT_ALLOC_CONCAT2(a, b) a##b
+#define FT_ALLOC_CONCAT(a, b) FT_ALLOC_CONCAT2(a, b)
+#define FT_ALLOC_SCOPE(name) AllocStats::Scope FT_ALLOC_CONCAT(ftAllocScope_, __LINE__)(name)
+#else
+#define FT_ALLOC_SCOPE(name) ((void)0)
+#endif
+
+#endif // ALLOCSTATS_H
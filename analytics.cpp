@@ -0,0 +1,81 @@
+// analytics.cpp
+#include "analytics.h"
+
+#include <QMap>
+
+GoalStatus goalStatus(const Goal &g)
+{
+    GoalStatus st;
+    st.pct = g.target > 0 ? qMin(100, (int)(g.progress * 100 / g.target)) : 0;
+    st.done = st.pct >= 100;
+    return st;
+}
+
+WeeklySummary computeWeeklySummary(const UserProfile &user, const PersistentVector<CardioWorkout> &cardio,
+                                   const PersistentVector<StrengthWorkout> &strength, const PersistentVector<BodyweightLog> &weightLogs,
+                                   const PersistentVector<Goal> &goals, const QDate &today)
+{
+    WeeklySummary s;
+    s.weekEnd = today;
+    s.weekStart = today.addDays(-6); // include today, last 7 days (6 days ago..today)
+
+    for (auto &w : cardio) {
+        s.cardioCount++;
+        s.cardioKmTotal += w.distance;
+        s.cardioCaloriesTotal += w.calories;
+        QDate d = QDate::fromString(w.date, "yyyy-MM-dd");
+        if (!d.isValid()) continue;
+        int days = d.daysTo(today); // days from that day to today (0 = today)
+        if (days >= 0 && days < 7) {
+            s.cardioPerDay[6 - days] += w.distance;
+            s.cardioSessionsWeek++;
+            s.cardioMinutesWeek += w.duration;
+            s.cardioKmWeek += w.distance;
+            s.cardioCaloriesWeek += w.calories;
+        }
+    }
+
+    for (auto &w : strength) {
+        const double vol = w.totalVolume;
+        s.strengthCount++;
+        s.strengthVolumeTotal += vol;
+        s.strengthCaloriesTotal += w.calories;
+        QDate d = QDate::fromString(w.date, "yyyy-MM-dd");
+        if (!d.isValid()) continue;
+        int days = d.daysTo(today);
+        if (days >= 0 && days < 7) {
+            s.strengthPerDay[6 - days] += vol; // per-day volume (kg)
+            s.strengthWorkoutsWeek++;
+            s.strengthVolumeWeek += vol;
+            s.strengthCaloriesWeek += w.calories;
+        }
+    }
+
+    // Bodyweight: latest entry per date, then fill the last 7 days
+    QMap<QDate,double> weightByDate;
+    for (auto &b : weightLogs) {
+        QDate d = QDate::fromString(b.date, "yyyy-MM-dd");
+        if (!d.isValid()) continue;
+        weightByDate[d] = b.weight; // overwrite ensures latest for that date
+    }
+    int logged = 0;
+    for (int i = 0; i < 7; ++i) {
+        QDate d = today.addDays(i - 6); // i=0 => 6 days ago, i=6 => today
+        s.weightPerDay[i] = weightByDate.value(d, 0.0);
+        if (s.weightPerDay[i] > 0) { s.weightWeekAvg += s.weightPerDay[i]; logged++; }
+    }
+    if (logged > 0) s.weightWeekAvg /= logged;
+    s.currentWeight = user.weight > 0 ? user.weight : (weightLogs.empty() ? 0.0 : weightLogs.back().weight);
+
+    // Goals: the last cardio_km goal sets the weekly km target, strength goals the workout count
+    for (auto &g : goals) if (g.type == "cardio_km") s.cardioTarget = g.target > 0 ? g.target : s.cardioTarget;
+    s.cardioPct = s.cardioTarget > 0 ? qBound(0, (int)qRound(s.cardioKmWeek * 100.0 / s.cardioTarget), 100) : 0;
+    for (auto &g : goals) if (g.type == "strength_exercise") { s.strengthTarget = qMax(1, g.target > 0 ? (int)g.target : s.strengthTarget); }
+    s.strengthPct = s.strengthTarget > 0 ? qBound(0, (int)qRound((s.strengthWorkoutsWeek * 100.0) / (double)s.strengthTarget), 100) : 0;
+    return s;
+}
+
+WeeklySummary computeWeeklySummary(const UserData &data, const QDate &today)
+{
+    return computeWeeklySummary(data.profile, data.cardio, data.strength, data.weightLogs, data.goals, today);
+}
@@ -0,0 +1,50 @@
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+// FitTrack Pro - dashboard aggregates, shared by refreshDashboard() and the headless batch report
+#include <QDate>
+#include <QVector>
+#include "models.h"
+
+// Last 7 days ending at `today` (index 0 = 6 days ago, 6 = today) plus lifetime totals
+struct WeeklySummary {
+    QDate weekStart, weekEnd;
+    QVector<double> cardioPerDay = QVector<double>(7, 0.0);   // km
+    QVector<double> strengthPerDay = QVector<double>(7, 0.0); // volume kg
+    QVector<double> weightPerDay = QVector<double>(7, 0.0);   // 0 = no weigh-in that day
+
+    int cardioSessionsWeek = 0;
+    int cardioMinutesWeek = 0;
+    double cardioKmWeek = 0.0;
+    double cardioCaloriesWeek = 0.0;
+    double cardioTarget = 20.0;
+    int cardioPct = 0;
+
+    int strengthWorkoutsWeek = 0;
+    double strengthVolumeWeek = 0.0;
+    double strengthCaloriesWeek = 0.0;
+    int strengthTarget = 3;
+    int strengthPct = 0;
+
+    double currentWeight = 0.0;
+    double weightWeekAvg = 0.0; // mean of the logged days, 0 if none
+
+    int cardioCount = 0;
+    double cardioKmTotal = 0.0, cardioCaloriesTotal = 0.0;
+    int strengthCount = 0;
+    double strengthVolumeTotal = 0.0, strengthCaloriesTotal = 0.0;
+};
+
+struct GoalStatus {
+    int pct = 0;
+    bool done = false;
+};
+
+GoalStatus goalStatus(const Goal &g);
+
+WeeklySummary computeWeeklySummary(const UserProfile &user, const PersistentVector<CardioWorkout> &cardio,
+                                   const PersistentVector<StrengthWorkout> &strength, const PersistentVector<BodyweightLog> &weightLogs,
+                                   const PersistentVector<Goal> &goals, const QDate &today);
+WeeklySummary computeWeeklySummary(const UserData &data, const QDate &today);
+
+#endif // ANALYTICS_H
@@ -0,0 +1,166 @@
+// batchreport.cpp
+#include "batchreport.h"
+#include "analytics.h"
+#include "datparser.h"
+#include "pdfreport.h"
+#include "reports.h"
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <atomic>
+
+namespace {
+
+struct MemberReport {
+    bool locked = false; // encrypted files, nothing to report without the member's password
+    WeeklySummary summary;
+    double targetBodyweight = 0.0;
+    int goalsDone = 0;
+    int goalsTotal = 0;
+    QStringList goals; // "name=NN%"
+};
+
+QString csvField(const QString &v)
+{
+    if (!v.contains(',') && !v.contains('"') && !v.contains('\n')) return v;
+    return QString("\"") + QString(v).replace("\"", "\"\"") + "\"";
+}
+
+MemberReport buildReport(const UserAccount &account, const QString &dir, const QDate &weekEnd)
+{
+    // files are read sequentially here: the member pool is the only source of parallelism
+    const UserData data = DatParser::loadUserData(account.username, dir, false);
+    MemberReport r;
+    if (data.locked) { r.locked = true; return r; }
+    r.summary = computeWeeklySummary(data, weekEnd);
+    r.targetBodyweight = data.profile.targetBodyweight;
+    for (const Goal &g : data.goals) {
+        const GoalStatus st = goalStatus(g);
+        r.goalsTotal++;
+        if (st.done) r.goalsDone++;
+        r.goals << QString("%1=%2%").arg(g.name).arg(st.pct);
+    }
+    return r;
+}
+
+} // namespace
+
+int runBatchReport(const QStringList &args)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("FitTrack Pro weekly batch report");
+    parser.addHelpOption();
+    QCommandLineOption reportOpt("batch-report", "Write the consolidated CSV report to <file>.", "file");
+    QCommandLineOption dirOpt("data-dir", "Directory holding users.dat and the per-user .dat files.", "dir", ".");
+    QCommandLineOption weekOpt("week-ending", "Last day of the reported week (yyyy-MM-dd, default today).", "date");
+    QCommandLineOption threadsOpt("threads", "Worker threads (default: one per core).", "n");
+    parser.addOptions({reportOpt, dirOpt, weekOpt, threadsOpt});
+    parser.process(args);
+
+    QTextStream err(stderr);
+    const QString dir = parser.value(dirOpt);
+    const QDate weekEnd = parser.isSet(weekOpt) ? QDate::fromString(parser.value(weekOpt), "yyyy-MM-dd") : QDate::currentDate();
+    if (!weekEnd.isValid()) { err << "batch: invalid --week-ending, expected yyyy-MM-dd\n"; return 1; }
+
+    const std::vector<UserAccount> accounts = DatParser::loadUserIndex(dir);
+    if (accounts.empty()) { err << "batch: no users in " << QDir(dir).filePath("users.dat") << "\n"; return 1; }
+
+    QThreadPool pool;
+    if (parser.isSet(threadsOpt)) pool.setMaxThreadCount(qMax(1, parser.value(threadsOpt).toInt()));
+
+    QElapsedTimer timer; timer.start();
+    std::vector<MemberReport> reports(accounts.size());
+    QList<int> indices;
+    for (int i = 0; i < (int)accounts.size(); ++i) indices << i;
+    QtConcurrent::blockingMap(&pool, indices, [&](int i) { reports[i] = buildReport(accounts[i], dir, weekEnd); });
+    const qint64 computeMs = timer.elapsed();
+
+    QFile f(parser.value(reportOpt));
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) { err << "batch: cannot write " << f.fileName() << ": " << f.errorString() << "\n"; return 1; }
+    QTextStream out(&f);
+    out << "username,name,week_start,week_end,cardio_sessions,cardio_minutes,cardio_km,cardio_kcal,cardio_target_km,cardio_goal_pct,"
+           "strength_workouts,strength_volume_kg,strength_kcal,strength_target,strength_goal_pct,"
+           "bodyweight_kg,bodyweight_week_avg_kg,target_bodyweight_kg,goals_completed,goals_total,goals\n";
+    int skipped = 0;
+    for (size_t i = 0; i < accounts.size(); ++i) {
+        if (reports[i].locked) { skipped++; continue; }
+        const WeeklySummary &s = reports[i].summary;
+        out << csvField(accounts[i].username) << "," << csvField(accounts[i].name) << ","
+            << s.weekStart.toString("yyyy-MM-dd") << "," << s.weekEnd.toString("yyyy-MM-dd") << ","
+            << s.cardioSessionsWeek << "," << s.cardioMinutesWeek << "," << QString::number(s.cardioKmWeek, 'f', 2) << ","
+            << (int)s.cardioCaloriesWeek << "," << QString::number(s.cardioTarget, 'f', 1) << "," << s.cardioPct << ","
+            << s.strengthWorkoutsWeek << "," << (int)s.strengthVolumeWeek << "," << (int)s.strengthCaloriesWeek << ","
+            << s.strengthTarget << "," << s.strengthPct << ","
+            << QString::number(s.currentWeight, 'f', 1) << "," << QString::number(s.weightWeekAvg, 'f', 1) << ","
+            << QString::number(reports[i].targetBodyweight, 'f', 1) << ","
+            << reports[i].goalsDone << "," << reports[i].goalsTotal << "," << csvField(reports[i].goals.join("; ")) << "\n";
+    }
+    out.flush();
+
+    err << QString("batch: %1 members (%2 encrypted, skipped), week %3..%4, %5 threads, %6 ms -> %7\n")
+               .arg(accounts.size()).arg(skipped).arg(weekEnd.addDays(-6).toString("yyyy-MM-dd"), weekEnd.toString("yyyy-MM-dd"))
+               .arg(pool.maxThreadCount()).arg(computeMs).arg(QFileInfo(f).absoluteFilePath());
+    return 0;
+}
+
+int runBatchPdf(const QStringList &args)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("FitTrack Pro monthly PDF reports");
+    parser.addHelpOption();
+    QCommandLineOption pdfOpt("batch-pdf", "Write one PDF per member into <dir>.", "dir");
+    QCommandLineOption dirOpt("data-dir", "Directory holding users.dat and the per-user .dat files.", "dir", ".");
+    QCommandLineOption monthOpt("month", "Reported month (yyyy-MM, default the last full month).", "month");
+    QCommandLineOption threadsOpt("threads", "Worker threads (default: one per core).", "n");
+    parser.addOptions({pdfOpt, dirOpt, monthOpt, threadsOpt});
+    parser.process(args);
+
+    QTextStream err(stderr);
+    const QString dir = parser.value(dirOpt);
+    const QDate today = QDate::currentDate();
+    const QDate from = parser.isSet(monthOpt) ? QDate::fromString(parser.value(monthOpt) + "-01", "yyyy-MM-dd")
+                                              : QDate(today.year(), today.month(), 1).addMonths(-1);
+    if (!from.isValid()) { err << "batch: invalid --month, expected yyyy-MM\n"; return 1; }
+    const QDate to = from.addMonths(1).addDays(-1);
+
+    const QDir outDir(parser.value(pdfOpt));
+    if (!QDir().mkpath(outDir.path())) { err << "batch: cannot create " << outDir.absolutePath() << "\n"; return 1; }
+    const std::vector<UserAccount> accounts = DatParser::loadUserIndex(dir);
+    if (accounts.empty()) { err << "batch: no users in " << QDir(dir).filePath("users.dat") << "\n"; return 1; }
+
+    QThreadPool pool;
+    if (parser.isSet(threadsOpt)) pool.setMaxThreadCount(qMax(1, parser.value(threadsOpt).toInt()));
+
+    QElapsedTimer timer; timer.start();
+    std::vector<QString> errors(accounts.size());
+    std::atomic<int> failed{0}, skipped{0};
+    QList<int> indices;
+    for (int i = 0; i < (int)accounts.size(); ++i) indices << i;
+    QtConcurrent::blockingMap(&pool, indices, [&](int i) {
+        UserData data = DatParser::loadUserData(accounts[i].username, dir, false);
+        if (data.locked) { errors[i] = "data files are encrypted, skipped"; skipped++; return; }
+        PdfReportInput in;
+        in.profile = data.profile;
+        in.profile.username = accounts[i].username;
+        if (in.profile.name.isEmpty()) in.profile.name = accounts[i].name;
+        in.goals = std::move(data.goals);
+        in.generated = today;
+        const ReportSnapshot snap{std::move(data.cardio), std::move(data.strength), std::move(data.weightLogs)};
+        Reports::compute(snap, from, to, in.data);
+        if (!PdfReport::write(in, outDir.filePath(accounts[i].username + ".pdf"), &errors[i])) failed++;
+    });
+    const qint64 ms = timer.elapsed();
+
+    for (size_t i = 0; i < accounts.size(); ++i)
+        if (!errors[i].isEmpty()) err << "batch: " << accounts[i].username << ": " << errors[i] << "\n";
+    err << QString("batch: %1 PDFs for %2, %3 failed, %4 encrypted, %5 threads, %6 ms -> %7\n")
+               .arg(int(accounts.size()) - failed.load() - skipped.load()).arg(from.toString("yyyy-MM")).arg(failed.load()).arg(skipped.load())
+               .arg(pool.maxThreadCount()).arg(ms).arg(outDir.absolutePath());
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,17 @@
+#ifndef BATCHREPORT_H
+#define BATCHREPORT_H
+
+// FitTrack Pro - headless reports for every member listed in users.dat
+// FittrackPro --batch-report <out.csv> [--data-dir DIR] [--week-ending yyyy-MM-dd] [--threads N]
+// FittrackPro --batch-pdf <out-dir> [--data-dir DIR] [--month yyyy-MM] [--threads N]
+#include <QStringList>
+
+// Loads each member on a thread pool, computes the dashboard aggregates and goal status,
+// and writes one CSV row per member. Returns the process exit code.
+int runBatchReport(const QStringList &args);
+
+// One monthly PDF per member (<out-dir>/<username>.pdf), a member per pool thread at a time, so the
+// run scales with cores and holds at most one member's data per thread. Needs a QGuiApplication.
+int runBatchPdf(const QStringList &args);
+
+#endif // BATCHREPORT_H
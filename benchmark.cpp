@@ -0,0 +1,451 @@
+// benchmark.cpp
+#include "benchmark.h"
+#include "cipher.h"
+#include "crc32c.h"
+#include "datafile.h"
+#include "datparser.h"
+#include "fitfile.h"
+#include "geo.h"
+#include "routeimport.h"
+#include "securestore.h"
+#include "tracing.h"
+
+#include <QDate>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <QTimeZone>
+#include <QTextStream>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+namespace {
+
+const QString kBenchUser = "bench_user";
+
+} // namespace
+
+// Same on-disk format saveData() produces
+void writeBenchAccount(const QString &dir, const QString &username, int cardioRows)
+{
+    QRandomGenerator rng(42);
+    const QDate start = QDate::currentDate().addDays(-cardioRows);
+    const QStringList types = {"Running","Cycling","Swimming","Walking"};
+    const QStringList lifts = {"Bench Press","Squat","Deadlift","Overhead Press","Barbell Row"};
+
+    QFile pf(DatParser::userFilePath(dir, "profile_", username)); pf.open(QIODevice::WriteOnly);
+    QTextStream(&pf) << "Male|80.5|75|180|30\n";
+    pf.close();
+
+    QFile cf(DatParser::userFilePath(dir, "cardio_", username)); cf.open(QIODevice::WriteOnly);
+    QTextStream co(&cf);
+    for (int i = 0; i < cardioRows; ++i) {
+        int dur = 10 + rng.bounded(110);
+        double dist = rng.bounded(4000) / 100.0;
+        co << start.addDays(i).toString("yyyy-MM-dd") << "|" << types[rng.bounded(types.size())] << "|" << dur << "|" << dist
+           << "|" << dur * 9.1 << "|" << dist * 60.0 / dur << "\n";
+    }
+    cf.close();
+
+    QFile sf(DatParser::userFilePath(dir, "strength_", username)); sf.open(QIODevice::WriteOnly);
+    QTextStream so(&sf);
+    for (int i = 0; i < cardioRows / 4; ++i) {
+        so << start.addDays(i).toString("yyyy-MM-dd") << "|" << 300 + rng.bounded(200) << "|";
+        for (int e = 0; e < 4; ++e) {
+            so << lifts[rng.bounded(lifts.size())] << ":";
+            for (int s = 0; s < 4; ++s) { so << 5 + rng.bounded(8) << "x" << 20 + rng.bounded(300) / 2.0; if (s < 3) so << ","; }
+            if (e < 3) so << ";";
+        }
+        so << "\n";
+    }
+    sf.close();
+
+    QFile wf(DatParser::userFilePath(dir, "weight_", username)); wf.open(QIODevice::WriteOnly);
+    QTextStream wo(&wf);
+    for (int i = 0; i < cardioRows / 2; ++i) wo << start.addDays(i).toString("yyyy-MM-dd") << "|" << 75 + rng.bounded(100) / 10.0 << "\n";
+    wf.close();
+
+    QFile gf(DatParser::userFilePath(dir, "goals_", username)); gf.open(QIODevice::WriteOnly);
+    QTextStream go(&gf);
+    for (int i = 0; i < 50; ++i) go << "Goal " << i << "|strength_exercise|1|0|0|0|Squat|100|3|5\n";
+    gf.close();
+}
+
+namespace {
+
+// Median wall time over a few runs, in milliseconds
+double timeLoader(const std::function<UserData()> &load, UserData &last)
+{
+    std::vector<double> ms;
+    for (int i = 0; i < 5; ++i) {
+        QElapsedTimer t; t.start();
+        last = load();
+        ms.push_back(t.nsecsElapsed() / 1e6);
+    }
+    std::sort(ms.begin(), ms.end());
+    return ms[ms.size() / 2];
+}
+
+// Median wall time of fn over a few runs, in milliseconds
+double timeMs(const std::function<void()> &fn, int runs = 5)
+{
+    std::vector<double> ms;
+    for (int i = 0; i < runs; ++i) {
+        QElapsedTimer t; t.start();
+        fn();
+        ms.push_back(t.nsecsElapsed() / 1e6);
+    }
+    std::sort(ms.begin(), ms.end());
+    return ms[ms.size() / 2];
+}
+
+double mbPerSec(qint64 bytes, double ms) { return bytes / 1048576.0 / (qMax(ms, 1e-3) / 1000.0); }
+
+size_t setCount(const UserData &d)
+{
+    size_t n = 0;
+    for (auto &w : d.strength) for (auto &e : w.exercises) n += e.sets.size();
+    return n;
+}
+
+// Field by field: two loaders agree only if every record reads back the same
+bool sameData(const UserData &a, const UserData &b)
+{
+    const UserProfile &p = a.profile, &q = b.profile;
+    if (a.hasProfile != b.hasProfile || p.gender != q.gender || p.weight != q.weight || p.targetBodyweight != q.targetBodyweight
+        || p.height != q.height || p.age != q.age)
+        return false;
+    if (a.cardio.size() != b.cardio.size() || a.strength.size() != b.strength.size()
+        || a.weightLogs.size() != b.weightLogs.size() || a.goals.size() != b.goals.size())
+        return false;
+    for (auto x = a.cardio.begin(), y = b.cardio.begin(); x != a.cardio.end(); ++x, ++y)
+        if (x->date != y->date || x->type != y->type || x->duration != y->duration || x->distance != y->distance
+            || x->calories != y->calories || x->avgSpeed != y->avgSpeed)
+            return false;
+    for (auto x = a.strength.begin(), y = b.strength.begin(); x != a.strength.end(); ++x, ++y) {
+        if (x->date != y->date || x->calories != y->calories || x->totalVolume != y->totalVolume || x->setCount != y->setCount
+            || x->repCount != y->repCount || x->exercises.size() != y->exercises.size())
+            return false;
+        for (size_t e = 0; e < x->exercises.size(); ++e) {
+            const Exercise &ex = x->exercises[e], &ey = y->exercises[e];
+            if (ex.name != ey.name || ex.volume != ey.volume || ex.sets.size() != ey.sets.size()) return false;
+            for (size_t s = 0; s < ex.sets.size(); ++s)
+                if (ex.sets[s].reps != ey.sets[s].reps || ex.sets[s].weight != ey.sets[s].weight) return false;
+        }
+    }
+    for (auto x = a.weightLogs.begin(), y = b.weightLogs.begin(); x != a.weightLogs.end(); ++x, ++y)
+        if (x->date != y->date || x->weight != y->weight) return false;
+    for (auto x = a.goals.begin(), y = b.goals.begin(); x != a.goals.end(); ++x, ++y)
+        if (x->name != y->name || x->type != y->type || x->target != y->target || x->progress != y->progress
+            || x->targetTime != y->targetTime || x->progressTime != y->progressTime || x->exerciseName != y->exerciseName
+            || x->exWeight != y->exWeight || x->exSets != y->exSets || x->exReps != y->exReps)
+            return false;
+    return true;
+}
+
+} // namespace
+
+int runParseBenchmark(const QStringList &args)
+{
+    QTextStream out(stdout);
+    const int idx = args.indexOf("--bench-parse");
+    const int rows = qMax(100, args.value(idx + 1).toInt() > 0 ? args.value(idx + 1).toInt() : 200000);
+
+    QTemporaryDir tmp;
+    if (!tmp.isValid()) { out << "bench: cannot create temp dir\n"; return 1; }
+    writeBenchAccount(tmp.path(), kBenchUser, rows);
+
+    qint64 bytes = 0;
+    for (const char *prefix : {"profile_","cardio_","strength_","weight_","goals_"})
+        bytes += QFileInfo(DatParser::userFilePath(tmp.path(), prefix, kBenchUser)).size();
+
+    UserData legacy, sequential, concurrent;
+    const double tLegacy = timeLoader([&] { return DatParser::loadUserDataLegacy(kBenchUser, tmp.path()); }, legacy);
+    const double tSeq = timeLoader([&] { return DatParser::loadUserData(kBenchUser, tmp.path(), false); }, sequential);
+    const double tPar = timeLoader([&] { return DatParser::loadUserData(kBenchUser, tmp.path(), true); }, concurrent);
+
+    // the same account as saveData() writes it: CRC32C-checked containers, verified on load
+    QTemporaryDir checkedDir;
+    if (!checkedDir.isValid()) { out << "bench: cannot create temp dir\n"; return 1; }
+    QByteArray largest;
+    for (const char *prefix : {"profile_","cardio_","strength_","weight_","goals_"}) {
+        QFile f(DatParser::userFilePath(tmp.path(), prefix, kBenchUser));
+        f.open(QIODevice::ReadOnly);
+        const QByteArray plain = f.readAll();
+        DataFile::write(DatParser::userFilePath(checkedDir.path(), prefix, kBenchUser), plain, QByteArray(), false);
+        if (plain.size() > largest.size()) largest = plain;
+    }
+    UserData checked;
+    const double tChecked = timeLoader([&] { return DatParser::loadUserData(kBenchUser, checkedDir.path(), true); }, checked);
+    const double crcMs = timeMs([&] { Crc32c::compute(largest.constData(), size_t(largest.size())); });
+    const double crcSoftMs = timeMs([&] { Crc32c::computeSoftware(largest.constData(), size_t(largest.size())); });
+
+    // what a worker's view of the data costs: a snapshot plus one edit on the GUI's side, against
+    // the deep copy of the cardio list the report worker used to take
+    PersistentVector<CardioWorkout> edited = concurrent.cardio;
+    const CardioWorkout extra = edited.back();
+    const double snapshotMs = timeMs([&] {
+        for (int i = 0; i < 100; ++i) {
+            const PersistentVector<CardioWorkout> snap = edited;
+            edited.push_back(extra);
+            edited.erase(edited.size() / 2);
+        }
+    }) / 200;
+    const double deepCopyMs = timeMs([&] { const std::vector<CardioWorkout> copy(concurrent.cardio.begin(), concurrent.cardio.end()); });
+
+    const bool same = sameData(legacy, sequential) && sameData(legacy, concurrent) && sameData(legacy, checked)
+                      && checked.damaged.isEmpty();
+
+    out << QString("records: cardio %1, strength %2 (%3 sets), weight %4, goals %5 - %6 MB\n")
+               .arg(legacy.cardio.size()).arg(legacy.strength.size()).arg(setCount(legacy))
+               .arg(legacy.weightLogs.size()).arg(legacy.goals.size()).arg(bytes / 1048576.0, 0, 'f', 1);
+    out << QString("legacy readLine+split   %1 ms\n").arg(tLegacy, 8, 'f', 2);
+    out << QString("zero-copy sequential    %1 ms  (%2x)\n").arg(tSeq, 8, 'f', 2).arg(tLegacy / qMax(tSeq, 1e-3), 0, 'f', 1);
+    out << QString("zero-copy concurrent    %1 ms  (%2x)\n").arg(tPar, 8, 'f', 2).arg(tLegacy / qMax(tPar, 1e-3), 0, 'f', 1);
+    out << QString("  with CRC32C checks    %1 ms  (%2%3%)\n").arg(tChecked, 8, 'f', 2)
+               .arg(tChecked >= tPar ? "+" : "").arg((tChecked / qMax(tPar, 1e-3) - 1) * 100, 0, 'f', 1);
+    out << QString("crc32c %1 MB/s (%2)   slicing-by-8 %3 MB/s\n")
+               .arg(mbPerSec(largest.size(), crcMs), 0, 'f', 0).arg(Crc32c::hasHardware() ? "sse4.2" : "no sse4.2, software")
+               .arg(mbPerSec(largest.size(), crcSoftMs), 0, 'f', 0);
+    out << QString("snapshot + one edit     %1 us   deep copy of cardio %2 ms\n").arg(snapshotMs * 1000, 0, 'f', 2).arg(deepCopyMs, 0, 'f', 2);
+    out << (same ? "results match\n" : "MISMATCH between loaders\n");
+    return same ? 0 : 2;
+}
+
+int runTraceBenchmark()
+{
+    QTextStream out(stdout);
+#ifdef FITTRACK_TRACING
+    const int spans = 2000000;
+    { FT_TRACE_SCOPE("warmup"); } // registers this thread's buffer outside the timed loop
+    QElapsedTimer t; t.start();
+    for (int i = 0; i < spans; ++i) { FT_TRACE_SCOPE("bench-span"); }
+    out << QString("%1 spans, %2 ns per span\n").arg(spans).arg(double(t.nsecsElapsed()) / spans, 0, 'f', 1);
+#else
+    out << "tracing is compiled out (FT_TRACE_SCOPE expands to nothing); rebuild with qmake CONFIG+=tracing\n";
+#endif
+    return 0;
+}
+
+int runCryptoBenchmark(const QStringList &args)
+{
+    QTextStream out(stdout);
+    const int idx = args.indexOf("--bench-crypto");
+    const int rows = qMax(100, args.value(idx + 1).toInt() > 0 ? args.value(idx + 1).toInt() : 200000);
+
+    // kernels over a 1 MiB buffer (cache resident, so this is the cipher alone)
+    QByteArray buf(1 << 20, 'x');
+    auto *data = reinterpret_cast<uint8_t *>(buf.data());
+    uint8_t key[Cipher::KeySize], nonce[Cipher::NonceSize] = {}, tag[Cipher::TagSize];
+    for (size_t i = 0; i < sizeof(key); ++i) key[i] = uint8_t(i * 7 + 1);
+    const int reps = 64;
+    for (Cipher::Kernel k : {Cipher::Kernel::Scalar, Cipher::Kernel::Sse2, Cipher::Kernel::Avx2}) {
+        if (!Cipher::kernelSupported(k)) { out << QString("chacha20 %1  not supported on this CPU\n").arg(QString::fromLatin1(Cipher::kernelName(k)), -6); continue; }
+        const double xorMs = timeMs([&] { for (int i = 0; i < reps; ++i) Cipher::chacha20Xor(key, nonce, 1, data, data, size_t(buf.size()), k); });
+        const double sealMs = timeMs([&] { for (int i = 0; i < reps; ++i) Cipher::seal(key, nonce, nullptr, 0, data, data, size_t(buf.size()), tag, k); });
+        out << QString("chacha20 %1 %2 MB/s   chacha20-poly1305 seal %3 MB/s%4\n")
+                   .arg(QString::fromLatin1(Cipher::kernelName(k)), -6).arg(mbPerSec(qint64(reps) * buf.size(), xorMs), 7, 'f', 0)
+                   .arg(mbPerSec(qint64(reps) * buf.size(), sealMs), 7, 'f', 0).arg(k == Cipher::bestKernel() ? "  (selected)" : "");
+    }
+    const double polyMs = timeMs([&] { for (int i = 0; i < reps; ++i) { Cipher::Poly1305 mac(key); mac.update(data, size_t(buf.size())); mac.finish(tag); } });
+    out << QString("poly1305        %1 MB/s\n").arg(mbPerSec(qint64(reps) * buf.size(), polyMs), 7, 'f', 0);
+    const double kdfMs = timeMs([&] { SecureStore::deriveKey("bench-password", QByteArray(16, 's'), SecureStore::DefaultIterations); }, 3);
+    out << QString("pbkdf2-sha256 x%1  %2 ms (password check, and the key of encrypted accounts, per login)\n").arg(SecureStore::DefaultIterations).arg(kdfMs, 0, 'f', 1);
+
+    // the storage path: the same account as plaintext and sealed, loaded and saved
+    QTemporaryDir plainDir, sealedDir;
+    if (!plainDir.isValid() || !sealedDir.isValid()) { out << "bench: cannot create temp dir\n"; return 1; }
+    writeBenchAccount(plainDir.path(), kBenchUser, rows);
+    const QByteArray fileKey = SecureStore::deriveKey("bench-password", QByteArray(16, 's'), 1);
+    std::vector<QByteArray> files;
+    qint64 bytes = 0;
+    for (const char *prefix : {"profile_","cardio_","strength_","weight_","goals_"}) {
+        QFile f(DatParser::userFilePath(plainDir.path(), prefix, kBenchUser));
+        f.open(QIODevice::ReadOnly);
+        files.push_back(f.readAll());
+        bytes += files.back().size();
+        DataFile::write(DatParser::userFilePath(sealedDir.path(), prefix, kBenchUser), files.back(), fileKey, false);
+    }
+
+    UserData plain, sealed;
+    const double loadPlain = timeLoader([&] { return DatParser::loadUserData(kBenchUser, plainDir.path(), true); }, plain);
+    const double loadSealed = timeLoader([&] { return DatParser::loadUserData(kBenchUser, sealedDir.path(), true, fileKey); }, sealed);
+    auto saveAll = [&](const QString &dir, const QByteArray &k) {
+        int i = 0;
+        for (const char *prefix : {"profile_","cardio_","strength_","weight_","goals_"})
+            DataFile::write(DatParser::userFilePath(dir, prefix, kBenchUser), files[size_t(i++)], k, false);
+    };
+    const double savePlain = timeMs([&] { saveAll(plainDir.path(), QByteArray()); });
+    const double saveSealed = timeMs([&] { saveAll(sealedDir.path(), fileKey); });
+
+    const bool same = !sealed.locked && sameData(plain, sealed);
+    out << QString("account: %1 cardio rows - %2 MB\n").arg(rows).arg(bytes / 1048576.0, 0, 'f', 1);
+    out << QString("load  plaintext %1 ms   encrypted %2 ms  (%3%4%)\n").arg(loadPlain, 8, 'f', 2).arg(loadSealed, 8, 'f', 2)
+               .arg(loadSealed >= loadPlain ? "+" : "").arg((loadSealed / qMax(loadPlain, 1e-3) - 1) * 100, 0, 'f', 1);
+    out << QString("write plaintext %1 ms   encrypted %2 ms  (%3%4%)\n").arg(savePlain, 8, 'f', 2).arg(saveSealed, 8, 'f', 2)
+               .arg(saveSealed >= savePlain ? "+" : "").arg((saveSealed / qMax(savePlain, 1e-3) - 1) * 100, 0, 'f', 1);
+    out << (same ? "results match\n" : "MISMATCH between plaintext and encrypted loads\n");
+    return same ? 0 : 2;
+}
+
+// A FIT activity as a watch writes it: file_id, one record per point, then the session
+class FitWriter {
+public:
+    FitWriter() {
+        bytes.fill('\0', 14);
+        define(0, 0, {{0, 1, 0x00}});                     // file_id: type
+        message(0); u8(4);                                // activity
+        define(1, 20, {{253, 4, 0x86}, {0, 4, 0x85}, {1, 4, 0x85}, {2, 2, 0x84}, {3, 1, 0x02}, {4, 1, 0x02}});
+        define(2, 18, {{253, 4, 0x86}, {2, 4, 0x86}, {5, 1, 0x00}, {7, 4, 0x86}, {8, 4, 0x86}});
+    }
+    void record(const QDateTime &t, double lat, double lon, double ele, int hr, int cad) {
+        message(1);
+        u32(fitTime(t)); u32(uint32_t(int32_t(std::lround(lat / 180.0 * 2147483648.0)))); u32(uint32_t(int32_t(std::lround(lon / 180.0 * 2147483648.0))));
+        u16(uint16_t(std::lround((ele + 500) * 5))); u8(uint8_t(hr)); u8(uint8_t(cad));
+    }
+    QByteArray finish(const QDateTime &start, const QDateTime &end, int sport) {
+        const uint32_t ms = uint32_t(start.msecsTo(end));
+        message(2); u32(fitTime(end)); u32(fitTime(start)); u8(uint8_t(sport)); u32(ms); u32(ms);
+        const uint32_t size = uint32_t(bytes.size() - 14);
+        const uint8_t header[12] = {14, 0x20, 0x08, 0x08, uint8_t(size), uint8_t(size >> 8), uint8_t(size >> 16), uint8_t(size >> 24), '.', 'F', 'I', 'T'};
+        std::memcpy(bytes.data(), header, 12);
+        const uint16_t headerCrc = Fit::crc16(header, 12);
+        bytes[12] = char(headerCrc & 0xff); bytes[13] = char(headerCrc >> 8);
+        u16(Fit::crc16(reinterpret_cast<const uint8_t *>(bytes.constData()), size_t(bytes.size())));
+        return bytes;
+    }
+
+private:
+    struct Field { uint8_t num, size, type; };
+    void define(uint8_t local, uint16_t global, std::initializer_list<Field> fields) {
+        u8(0x40 | local); u8(0); u8(0); u16(global); u8(uint8_t(fields.size()));
+        for (const Field &f : fields) { u8(f.num); u8(f.size); u8(f.type); }
+    }
+    void message(uint8_t local) { u8(local); }
+    static uint32_t fitTime(const QDateTime &t) { return uint32_t(t.toSecsSinceEpoch() - Fit::EpochOffset); }
+    void u8(uint8_t v) { bytes.append(char(v)); }
+    void u16(uint16_t v) { u8(uint8_t(v)); u8(uint8_t(v >> 8)); }
+    void u32(uint32_t v) { u16(uint16_t(v)); u16(uint16_t(v >> 16)); }
+    QByteArray bytes;
+};
+
+int runRouteBenchmark(const QStringList &args)
+{
+    QTextStream out(stdout);
+    const int idx = args.indexOf("--bench-route");
+    const int files = qMax(1, args.value(idx + 1).toInt() > 0 ? args.value(idx + 1).toInt() : 500);
+    constexpr int Points = 3600; // an hour at the 1 Hz most watches record
+
+    // a wandering track, so segments differ in length and direction
+    std::vector<double> lat(1 << 20), lon(lat.size());
+    QRandomGenerator rng(7);
+    lat[0] = 47.37; lon[0] = 8.54;
+    for (size_t i = 1; i < lat.size(); ++i) {
+        lat[i] = lat[i - 1] + (rng.generateDouble() - 0.45) * 4e-5;
+        lon[i] = lon[i - 1] + (rng.generateDouble() - 0.45) * 6e-5;
+    }
+
+    // kernels over 1M points
+    std::vector<double> ref(lat.size() - 1), seg(lat.size() - 1);
+    Geo::segmentDistances(lat.data(), lon.data(), lat.size(), ref.data(), Geo::Kernel::Scalar);
+    for (Geo::Kernel k : {Geo::Kernel::Scalar, Geo::Kernel::Avx2}) {
+        if (!Geo::kernelSupported(k)) { out << QString("haversine %1  not supported on this CPU\n").arg(QString::fromLatin1(Geo::kernelName(k)), -6); continue; }
+        const double ms = timeMs([&] { Geo::segmentDistances(lat.data(), lon.data(), lat.size(), seg.data(), k); });
+        double worst = 0, worstRel = 0;
+        for (size_t i = 0; i < seg.size(); ++i) {
+            worst = std::max(worst, std::fabs(seg[i] - ref[i]));
+            if (ref[i] > 0) worstRel = std::max(worstRel, std::fabs(seg[i] - ref[i]) / ref[i]);
+        }
+        out << QString("haversine %1 %2 M segments/s   max deviation %3 m (%4 relative)%5\n")
+                   .arg(QString::fromLatin1(Geo::kernelName(k)), -6).arg(seg.size() / 1e3 / qMax(ms, 1e-3), 6, 'f', 1)
+                   .arg(worst, 0, 'g', 2).arg(worstRel, 0, 'g', 2).arg(k == Geo::bestKernel() ? "  (selected)" : "");
+    }
+
+    // the import path: the same synthetic activities as GPX and as FIT files, parsed and analysed
+    // on the pool as the Cardio tab does
+    QTemporaryDir tmp;
+    if (!tmp.isValid()) { out << "bench: cannot create temp dir\n"; return 1; }
+    QStringList gpxPaths, fitPaths;
+    qint64 gpxBytes = 0, fitBytes = 0;
+    const QDateTime start(QDate(2024, 5, 1), QTime(7, 0), QTimeZone::utc());
+    for (int f = 0; f < files; ++f) {
+        const QString path = tmp.filePath(QString("run%1.gpx").arg(f));
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) { out << "bench: cannot write " << path << "\n"; return 1; }
+        QTextStream ts(&file);
+        ts << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<gpx version=\"1.1\" creator=\"bench\" xmlns=\"http://www.topografix.com/GPX/1/1\""
+           << " xmlns:gpxtpx=\"http://www.garmin.com/xmlschemas/TrackPointExtension/v1\">\n"
+           << "<trk><type>running</type><trkseg>\n";
+        FitWriter fit;
+        const size_t base = size_t(f) * 997 % (lat.size() - Points);
+        for (int i = 0; i < Points; ++i) {
+            const double la = lat[base + size_t(i)], lo = lon[base + size_t(i)], ele = std::round((400 + 20 * std::sin(i / 300.0)) * 5) / 5;
+            const int hr = 140 + int(15 * std::sin(i / 600.0)) + int(rng.bounded(3)), cad = 84 + int(rng.bounded(3));
+            const QDateTime at = start.addDays(f).addSecs(i);
+            ts << "<trkpt lat=\"" << QString::number(la, 'f', 7) << "\" lon=\"" << QString::number(lo, 'f', 7)
+               << "\"><ele>" << QString::number(ele, 'f', 1) << "</ele><time>" << at.toString(Qt::ISODate)
+               << "</time><extensions><gpxtpx:TrackPointExtension><gpxtpx:hr>" << hr << "</gpxtpx:hr><gpxtpx:cad>" << cad
+               << "</gpxtpx:cad></gpxtpx:TrackPointExtension></extensions></trkpt>\n";
+            fit.record(at, la, lo, ele, hr, cad);
+        }
+        ts << "</trkseg></trk>\n</gpx>\n";
+        ts.flush();
+        gpxBytes += file.size();
+        gpxPaths << path;
+
+        const QString fitPath = tmp.filePath(QString("run%1.fit").arg(f));
+        QFile fitFile(fitPath);
+        if (!fitFile.open(QIODevice::WriteOnly)) { out << "bench: cannot write " << fitPath << "\n"; return 1; }
+        fitBytes += fitFile.write(fit.finish(start.addDays(f), start.addDays(f).addSecs(Points - 1), 1));
+        fitPaths << fitPath;
+    }
+
+    int failed = 0;
+    auto importAll = [&](const QStringList &paths, qint64 bytes, const char *format) {
+        QList<RouteImport::FileResult> results;
+        const double ms = timeMs([&] { results = QtConcurrent::blockingMapped(paths, [](const QString &path) { return RouteImport::importFile(path, 190); }); }, 3);
+        for (const RouteImport::FileResult &r : results) failed += !r.error.isEmpty() || r.activities.size() != 1;
+        out << QString("import %1 %2 files x %3 points - %4 MB\n").arg(files).arg(format).arg(Points).arg(bytes / 1048576.0, 0, 'f', 1);
+        out << QString("  %1 ms   %2 files/s   %3 MB/s on %4 threads\n").arg(ms, 0, 'f', 1)
+                   .arg(files / (qMax(ms, 1e-3) / 1000.0), 0, 'f', 0).arg(mbPerSec(bytes, ms), 0, 'f', 0)
+                   .arg(QThreadPool::globalInstance()->maxThreadCount());
+        return results;
+    };
+    auto firstOf = [](const QList<RouteImport::FileResult> &results) {
+        return results.isEmpty() || results[0].activities.empty() ? RouteImport::FileResult::Activity() : results[0].activities[0];
+    };
+    const QList<RouteImport::FileResult> results = importAll(gpxPaths, gpxBytes, "GPX");
+    const RouteImport::FileResult::Activity firstGpx = firstOf(results);
+    const RouteSummary &first = firstGpx.summary;
+    out << QString("  first file: %1 km, %2 moving min, %3 splits, %4 m climbed\n").arg(first.workout.distance, 0, 'f', 2)
+               .arg(first.movingSeconds / 60, 0, 'f', 1).arg(first.workout.splits.size()).arg(first.workout.elevationGain, 0, 'f', 0);
+    const RouteSummary firstFit = firstOf(importAll(fitPaths, fitBytes, "FIT")).summary;
+    const bool fitMatches = std::fabs(firstFit.workout.distance - first.workout.distance) < 0.01
+                            && firstFit.workout.splits.size() == first.workout.splits.size()
+                            && firstFit.workout.heartRate.average == first.workout.heartRate.average;
+    out << QString("  first file: %1 km, %2 splits, avg HR %3 - %4\n").arg(firstFit.workout.distance, 0, 'f', 2)
+               .arg(firstFit.workout.splits.size()).arg(firstFit.workout.heartRate.average)
+               .arg(fitMatches ? "matches the GPX" : "MISMATCH with the GPX");
+    failed += !fitMatches;
+
+    // the sample streams: stored size against the decoded arrays, and the cost of opening one activity
+    qint64 stored = 0;
+    for (const RouteImport::FileResult &r : results)
+        for (const RouteImport::FileResult::Activity &a : r.activities) stored += a.sampleData.size();
+    SampleSeries decoded;
+    const QByteArray &one = firstGpx.sampleData;
+    const double decodeMs = timeMs([&] { SampleStore::decode(one, decoded); }, 9);
+    qint64 raw = qint64(decoded.time.size()) * 8;
+    for (const auto &v : decoded.values) raw += qint64(v.size()) * 8;
+    out << QString("samples: %1 KB per activity (%2x smaller than decoded), decode %3 ms, avg HR %4\n")
+               .arg(stored / 1024.0 / qMax(1, files), 0, 'f', 1).arg(double(raw) / qMax(1, one.size()), 0, 'f', 1)
+               .arg(decodeMs, 0, 'f', 3).arg(first.workout.heartRate.average);
+    if (failed) out << QString("%1 files FAILED to import or disagreed\n").arg(failed);
+    return failed ? 2 : 0;
+}
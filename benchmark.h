@@ -0,0 +1,31 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// FitTrack Pro - headless micro-benchmarks, run as "FittrackPro --bench-parse [cardioRows]" / "--bench-crypto [cardioRows]"
+// / "--bench-route [files]" / "--bench-trace"
+// (the widget benchmark, "--bench-gui", lives in main.cpp next to the window it drives)
+#include <QStringList>
+
+// Synthetic account in <dir>: cardioRows cardio days, a quarter as many strength workouts (4x4 sets),
+// half as many weigh-ins and 50 goals
+void writeBenchAccount(const QString &dir, const QString &username, int cardioRows);
+
+// Writes a synthetic account of the given size and times the legacy QTextStream loader
+// against the zero-copy parser (sequential, concurrent, and concurrent on CRC32C-checked files),
+// and what a worker's snapshot of the loaded data costs against a deep copy. Every loader's records
+// are compared field by field with the legacy loader's; returns 2 on any difference. Results go to stdout.
+int runParseBenchmark(const QStringList &args);
+
+// ChaCha20 / Poly1305 throughput per kernel, the PBKDF2 login cost, and load/write times of one
+// synthetic account stored as plaintext and encrypted. Results go to stdout.
+int runCryptoBenchmark(const QStringList &args);
+
+// Haversine throughput per kernel, GPX and FIT import throughput over the same synthetic one-hour
+// tracks imported on the thread pool, and the size and decode time of their sample streams.
+// Results go to stdout.
+int runRouteBenchmark(const QStringList &args);
+
+// Cost of one FT_TRACE_SCOPE span (only meaningful in a CONFIG+=tracing build)
+int runTraceBenchmark();
+
+#endif // BENCHMARK_H
@@ -0,0 +1,244 @@
+// bulkentry.cpp
+#include "bulkentry.h"
+#include "tracing.h"
+
+#include <QDate>
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTabWidget>
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include <map>
+
+namespace {
+
+constexpr int InitialRows = 20;
+const QColor BadCell(120, 24, 24);
+
+QString cell(const QStringList &cells, int c) { return c < cells.size() ? cells[c].trimmed() : QString(); }
+
+QString parseDate(const QString &text, QString *out)
+{
+    const QDate d = QDate::fromString(text, "yyyy-MM-dd");
+    if (!d.isValid()) return "Date must be yyyy-MM-dd";
+    if (d > QDate::currentDate()) return "Date is in the future";
+    *out = d.toString("yyyy-MM-dd");
+    return QString();
+}
+
+bool parseNumber(const QString &text, double lo, double hi, double *out)
+{
+    bool ok = false;
+    const double v = text.toDouble(&ok);
+    if (!ok || v < lo || v > hi) return false;
+    *out = v;
+    return true;
+}
+
+bool parseCount(const QString &text, int lo, int hi, int *out)
+{
+    bool ok = false;
+    const int v = text.toInt(&ok);
+    if (!ok || v < lo || v > hi) return false;
+    *out = v;
+    return true;
+}
+
+} // namespace
+
+namespace BulkEntry {
+
+QString parseCardioRow(const QStringList &cells, CardioWorkout *out, int *badColumn)
+{
+    CardioWorkout w{};
+    QString err = parseDate(cell(cells, 0), &w.date);
+    if (!err.isEmpty()) { *badColumn = 0; return err; }
+
+    static const QStringList types = {"Running", "Cycling", "Swimming", "Walking"};
+    for (const QString &t : types)
+        if (t.compare(cell(cells, 1), Qt::CaseInsensitive) == 0) w.type = t;
+    if (w.type.isEmpty()) { *badColumn = 1; return "Type must be one of " + types.join(", "); }
+
+    if (!parseCount(cell(cells, 2), 1, 1440, &w.duration)) { *badColumn = 2; return "Minutes must be 1-1440"; }
+    if (!parseNumber(cell(cells, 3), 0.0, 1000.0, &w.distance)) { *badColumn = 3; return "Km must be 0-1000"; }
+    w.avgSpeed = w.distance * 60.0 / w.duration;
+    *out = w;
+    return QString();
+}
+
+QString parseStrengthRow(const QStringList &cells, QString *date, Exercise *out, int *badColumn)
+{
+    QString err = parseDate(cell(cells, 0), date);
+    if (!err.isEmpty()) { *badColumn = 0; return err; }
+
+    Exercise ex;
+    ex.name = cell(cells, 1);
+    if (ex.name.isEmpty()) { *badColumn = 1; return "Enter the exercise name"; }
+
+    // "10" repeats for every set, "10,8,6" gives each set its own count
+    std::vector<int> reps;
+    for (const QString &part : cell(cells, 3).split(',', Qt::SkipEmptyParts)) {
+        int r = 0;
+        if (!parseCount(part.trimmed(), 1, 100, &r)) { *badColumn = 3; return "Reps must be 1-100, or a comma list like 10,8,6"; }
+        reps.push_back(r);
+    }
+    if (reps.empty()) { *badColumn = 3; return "Enter the reps"; }
+
+    int sets = (int)reps.size();
+    if (!cell(cells, 2).isEmpty() && !parseCount(cell(cells, 2), 1, 20, &sets)) { *badColumn = 2; return "Sets must be 1-20"; }
+    if (reps.size() > 1 && (int)reps.size() != sets) { *badColumn = 3; return QString("Reps list has %1 values for %2 sets").arg(reps.size()).arg(sets); }
+
+    double kg = 0;
+    if (!parseNumber(cell(cells, 4), 0.0, 500.0, &kg)) { *badColumn = 4; return "Kg must be 0-500"; }
+
+    for (int i = 0; i < sets; ++i) ex.sets.push_back({reps.size() > 1 ? reps[size_t(i)] : reps[0], kg});
+    *out = ex;
+    return QString();
+}
+
+QString parseWeightRow(const QStringList &cells, BodyweightLog *out, int *badColumn)
+{
+    BodyweightLog b{};
+    QString err = parseDate(cell(cells, 0), &b.date);
+    if (!err.isEmpty()) { *badColumn = 0; return err; }
+    if (!parseNumber(cell(cells, 1), 20.0, 300.0, &b.weight)) { *badColumn = 1; return "Kg must be 20-300"; }
+    *out = b;
+    return QString();
+}
+
+} // namespace BulkEntry
+
+BulkEntryDialog::BulkEntryDialog(QWidget *parent) : QDialog(parent)
+{
+    setWindowTitle("Bulk Entry");
+    resize(820, 560);
+    auto *lo = new QVBoxLayout(this);
+
+    auto *hint = new QLabel("Type one row per entry; empty rows are ignored. Strength rows with the same date form one workout.");
+    hint->setWordWrap(true);
+    lo->addWidget(hint);
+
+    auto *tabs = new QTabWidget;
+    grids[CardioGrid] = makeGrid({"Date (yyyy-MM-dd)", "Type", "Minutes", "Km"});
+    grids[StrengthGrid] = makeGrid({"Date (yyyy-MM-dd)", "Exercise", "Sets", "Reps", "Kg"});
+    grids[WeightGrid] = makeGrid({"Date (yyyy-MM-dd)", "Kg"});
+    tabs->addTab(grids[CardioGrid], "Cardio");
+    tabs->addTab(grids[StrengthGrid], "Strength");
+    tabs->addTab(grids[WeightGrid], "Bodyweight");
+    lo->addWidget(tabs);
+
+    for (int g = 0; g < GridCount; ++g) {
+        rowState[g].assign(InitialRows, 0);
+        connect(grids[g], &QTableWidget::itemChanged, this, [this, g](QTableWidgetItem *it) {
+            if (!validating) validateRow(Grid(g), it->row());
+        });
+    }
+
+    auto *bottom = new QHBoxLayout;
+    auto *more = new QPushButton("Add Rows");
+    connect(more, &QPushButton::clicked, this, [this, tabs] {
+        const int g = tabs->currentIndex();
+        grids[g]->setRowCount(grids[g]->rowCount() + InitialRows);
+        rowState[g].resize(size_t(grids[g]->rowCount()), 0);
+    });
+    bottom->addWidget(more);
+    statusLbl = new QLabel;
+    bottom->addWidget(statusLbl, 1);
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Cancel);
+    commitBtn = buttons->addButton("Save All", QDialogButtonBox::AcceptRole);
+    connect(buttons, &QDialogButtonBox::accepted, this, [this] { collect(); accept(); });
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    bottom->addWidget(buttons);
+    lo->addLayout(bottom);
+    updateStatus();
+}
+
+QTableWidget *BulkEntryDialog::makeGrid(const QStringList &headers)
+{
+    auto *t = new QTableWidget(InitialRows, headers.size());
+    t->setHorizontalHeaderLabels(headers);
+    t->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    t->setAlternatingRowColors(true);
+    return t;
+}
+
+void BulkEntryDialog::validateRow(Grid g, int row)
+{
+    QTableWidget *t = grids[g];
+    QStringList cells;
+    bool empty = true;
+    for (int c = 0; c < t->columnCount(); ++c) {
+        const QTableWidgetItem *it = t->item(row, c);
+        cells << (it ? it->text() : QString());
+        if (!cells.back().trimmed().isEmpty()) empty = false;
+    }
+
+    int bad = -1;
+    QString err;
+    if (!empty) {
+        if (g == CardioGrid) { CardioWorkout w; err = BulkEntry::parseCardioRow(cells, &w, &bad); }
+        else if (g == StrengthGrid) { QString d; Exercise e; err = BulkEntry::parseStrengthRow(cells, &d, &e, &bad); }
+        else { BodyweightLog b; err = BulkEntry::parseWeightRow(cells, &b, &bad); }
+    }
+    rowState[g][size_t(row)] = empty ? 0 : (err.isEmpty() ? 1 : 2);
+
+    // setting the colour re-emits itemChanged for the same row
+    validating = true;
+    for (int c = 0; c < t->columnCount(); ++c) {
+        QTableWidgetItem *it = t->item(row, c);
+        if (!it) { if (c != bad) continue; it = new QTableWidgetItem; t->setItem(row, c, it); }
+        it->setBackground(c == bad ? QBrush(BadCell) : QBrush());
+        it->setToolTip(c == bad ? err : QString());
+    }
+    validating = false;
+    updateStatus();
+}
+
+void BulkEntryDialog::updateStatus()
+{
+    int ready = 0, invalid = 0;
+    for (const auto &rows : rowState)
+        for (char s : rows) { ready += s == 1; invalid += s == 2; }
+    statusLbl->setText(invalid ? QString("%1 ready • %2 with errors (hover a red cell)").arg(ready).arg(invalid)
+                               : QString("%1 ready").arg(ready));
+    commitBtn->setEnabled(ready > 0 && invalid == 0);
+}
+
+void BulkEntryDialog::collect()
+{
+    FT_TRACE_SCOPE("BulkEntryDialog::collect");
+    result = BulkBatch();
+    auto rowCells = [](QTableWidget *t, int row) {
+        QStringList cells;
+        for (int c = 0; c < t->columnCount(); ++c) cells << (t->item(row, c) ? t->item(row, c)->text() : QString());
+        return cells;
+    };
+    int bad = -1;
+    for (int r = 0; r < grids[CardioGrid]->rowCount(); ++r) {
+        if (rowState[CardioGrid][size_t(r)] != 1) continue;
+        CardioWorkout w;
+        if (BulkEntry::parseCardioRow(rowCells(grids[CardioGrid], r), &w, &bad).isEmpty()) result.cardio.push_back(w);
+    }
+    std::map<QString, size_t> byDate; // date -> index in result.strength
+    for (int r = 0; r < grids[StrengthGrid]->rowCount(); ++r) {
+        if (rowState[StrengthGrid][size_t(r)] != 1) continue;
+        QString date; Exercise e;
+        if (!BulkEntry::parseStrengthRow(rowCells(grids[StrengthGrid], r), &date, &e, &bad).isEmpty()) continue;
+        auto it = byDate.find(date);
+        if (it == byDate.end()) {
+            it = byDate.emplace(date, result.strength.size()).first;
+            StrengthWorkout w; w.date = date;
+            result.strength.push_back(w);
+        }
+        result.strength[it->second].exercises.push_back(e);
+    }
+    for (auto &w : result.strength) w.updateTotals();
+    for (int r = 0; r < grids[WeightGrid]->rowCount(); ++r) {
+        if (rowState[WeightGrid][size_t(r)] != 1) continue;
+        BodyweightLog b;
+        if (BulkEntry::parseWeightRow(rowCells(grids[WeightGrid], r), &b, &bad).isEmpty()) result.weights.push_back(b);
+    }
+}
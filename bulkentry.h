@@ -0,0 +1,54 @@
+#ifndef BULKENTRY_H
+#define BULKENTRY_H
+
+// FitTrack Pro - bulk entry grid for backfilling many workouts at once
+// Rows are validated as they are typed (bad cells turn red with the reason as tooltip) and the whole
+// batch is handed back in one piece, so the window saves, evaluates goals and updates views once.
+#include <QDialog>
+#include <QStringList>
+#include <vector>
+#include "models.h"
+
+class QLabel;
+class QPushButton;
+class QTableWidget;
+
+// Calories are left at 0: they depend on the account's bodyweight and are filled in by the caller
+struct BulkBatch {
+    std::vector<CardioWorkout> cardio;
+    std::vector<StrengthWorkout> strength; // one workout per date, exercises in row order
+    std::vector<BodyweightLog> weights;
+    bool isEmpty() const { return cardio.empty() && strength.empty() && weights.empty(); }
+};
+
+namespace BulkEntry {
+
+// A row parser returns an empty string when the row is valid, else the reason and the offending column
+QString parseCardioRow(const QStringList &cells, CardioWorkout *out, int *badColumn);   // Date|Type|Minutes|Km
+QString parseStrengthRow(const QStringList &cells, QString *date, Exercise *out, int *badColumn); // Date|Exercise|Sets|Reps|Kg
+QString parseWeightRow(const QStringList &cells, BodyweightLog *out, int *badColumn);  // Date|Kg
+
+} // namespace BulkEntry
+
+class BulkEntryDialog : public QDialog {
+public:
+    explicit BulkEntryDialog(QWidget *parent = nullptr);
+    const BulkBatch &batch() const { return result; }
+
+private:
+    enum Grid { CardioGrid, StrengthGrid, WeightGrid, GridCount };
+
+    QTableWidget *makeGrid(const QStringList &headers);
+    void validateRow(Grid g, int row);
+    void updateStatus();
+    void collect();
+
+    QTableWidget *grids[GridCount] = {};
+    std::vector<char> rowState[GridCount]; // per row: 0 empty, 1 valid, 2 invalid
+    QLabel *statusLbl = nullptr;
+    QPushButton *commitBtn = nullptr;
+    BulkBatch result;
+    bool validating = false;
+};
+
+#endif // BULKENTRY_H
@@ -0,0 +1,82 @@
+// bwtrend.cpp
+#include "bwtrend.h"
+
+#include <algorithm>
+#include <cmath>
+
+void WeightTrend::clear()
+{
+    points.clear();
+    start = 0;
+    anchor = 0;
+    n = sx = sy = sxx = sxy = 0;
+}
+
+void WeightTrend::rebuild(const PersistentVector<BodyweightLog> &logs)
+{
+    clear();
+    std::vector<BodyweightLog> sorted(logs.begin(), logs.end());
+    std::stable_sort(sorted.begin(), sorted.end(), [](const BodyweightLog &a, const BodyweightLog &b) { return a.date < b.date; });
+    points.reserve(sorted.size());
+    for (const BodyweightLog &b : sorted) add(b);
+}
+
+bool WeightTrend::add(const BodyweightLog &b)
+{
+    const QDate d = QDate::fromString(b.date, "yyyy-MM-dd");
+    if (!d.isValid()) return true; // unreadable dates are skipped, as in the dashboard
+    const qint64 jd = d.toJulianDay();
+    if (!points.empty() && jd < points.back().day) return false;
+
+    double ewma = b.weight;
+    if (points.empty()) anchor = jd;
+    else {
+        // one Alpha step per elapsed day, so a gap in logging does not slow the trend down
+        const qint64 gap = std::max<qint64>(1, jd - points.back().day);
+        ewma = points.back().trend + (1.0 - std::pow(1.0 - Alpha, double(gap))) * (b.weight - points.back().trend);
+    }
+    points.push_back({jd, b.weight, ewma});
+
+    const double x = double(jd - anchor);
+    n += 1; sx += x; sy += b.weight; sxx += x * x; sxy += x * b.weight;
+    while (points[start].day <= jd - WindowDays) {
+        const double ox = double(points[start].day - anchor), oy = points[start].weight;
+        n -= 1; sx -= ox; sy -= oy; sxx -= ox * ox; sxy -= ox * oy;
+        ++start;
+    }
+    return true;
+}
+
+double WeightTrend::trendAt(const QDate &d) const
+{
+    const qint64 jd = d.toJulianDay();
+    auto it = std::upper_bound(points.begin(), points.end(), jd, [](qint64 v, const WeightPoint &p) { return v < p.day; });
+    return it == points.begin() ? 0.0 : std::prev(it)->trend;
+}
+
+LinearFit WeightTrend::fit() const
+{
+    LinearFit f;
+    const double den = n * sxx - sx * sx;
+    if (n < 2 || den <= 1e-9) { f.intercept = n > 0 ? sy / n : 0.0; return f; }
+    f.slope = (n * sxy - sx * sy) / den;
+    f.intercept = (sy - f.slope * sx) / n - f.slope * double(anchor);
+    return f;
+}
+
+double WeightTrend::ratePerWeek() const
+{
+    return fit().slope * 7.0;
+}
+
+QDate WeightTrend::projectedDate(double target) const
+{
+    if (points.empty() || target <= 0) return QDate();
+    const double diff = target - trend();
+    if (std::abs(diff) < 0.05) return lastDate(); // already there
+    const double perDay = fit().slope;
+    if (perDay == 0 || (diff > 0) != (perDay > 0)) return QDate();
+    const double days = diff / perDay;
+    if (days > 3650) return QDate(); // not in any useful horizon
+    return lastDate().addDays(qint64(std::ceil(days)));
+}
@@ -0,0 +1,42 @@
+#ifndef BWTREND_H
+#define BWTREND_H
+
+// FitTrack Pro - smoothed bodyweight trend and goal-weight forecast
+// Weigh-ins are folded in one at a time: the EWMA and the rolling-regression sums are updated
+// in O(1) per entry (amortized, entries leaving the window are subtracted back out).
+#include <QDate>
+#include <vector>
+#include "models.h"
+#include "progress.h"
+
+struct WeightPoint { qint64 day; double weight; double trend; };
+
+class WeightTrend {
+public:
+    static constexpr double Alpha = 0.1;   // EWMA weight of one day's reading
+    static constexpr int WindowDays = 28;  // rolling regression window
+
+    void clear();
+    void rebuild(const PersistentVector<BodyweightLog> &logs); // sorts by date, then add()s each
+    // O(1); returns false when `b` is older than the last entry (the caller should rebuild)
+    bool add(const BodyweightLog &b);
+
+    bool isEmpty() const { return points.empty(); }
+    const std::vector<WeightPoint> &history() const { return points; }
+    double trend() const { return points.empty() ? 0.0 : points.back().trend; }
+    double trendAt(const QDate &d) const; // trend as of day d (0 before the first entry)
+    QDate lastDate() const { return points.empty() ? QDate() : QDate::fromJulianDay(points.back().day); }
+
+    double ratePerWeek() const;   // regression slope over the last WindowDays, kg/week
+    LinearFit fit() const;        // same regression with x in julian days
+    int windowStart() const { return start; } // first history() index inside the window
+    QDate projectedDate(double target) const; // invalid when the trend is not heading to target
+
+private:
+    std::vector<WeightPoint> points;
+    size_t start = 0;
+    qint64 anchor = 0; // x origin for the sums, keeps them small
+    double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+};
+
+#endif // BWTREND_H
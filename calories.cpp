@@ -0,0 +1,108 @@
+// calories.cpp
+#include "calories.h"
+#include "tracing.h"
+
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace Calories {
+
+ActivityType activityFromName(const QString &type)
+{
+    if (type == "Running") return ActivityType::Running;
+    if (type == "Swimming") return ActivityType::Swimming;
+    if (type == "Walking") return ActivityType::Walking;
+    return ActivityType::Cycling;
+}
+
+double metFor(ActivityType a)
+{
+    switch (a) {
+    case ActivityType::Running: return Met<ActivityType::Running>::value;
+    case ActivityType::Cycling: return Met<ActivityType::Cycling>::value;
+    case ActivityType::Swimming: return Met<ActivityType::Swimming>::value;
+    case ActivityType::Walking: return Met<ActivityType::Walking>::value;
+    }
+    return Met<ActivityType::Cycling>::value;
+}
+
+double cardio(const QString &type, double weightKg, int minutes)
+{
+    switch (activityFromName(type)) {
+    case ActivityType::Running: return cardio<ActivityType::Running>(weightKg, minutes);
+    case ActivityType::Swimming: return cardio<ActivityType::Swimming>(weightKg, minutes);
+    case ActivityType::Walking: return cardio<ActivityType::Walking>(weightKg, minutes);
+    case ActivityType::Cycling: break;
+    }
+    return cardio<ActivityType::Cycling>(weightKg, minutes);
+}
+
+double strength(double weightKg, double volumeKg)
+{
+    return 5.0 * weightKg * 0.15 + volumeKg * 0.01;
+}
+
+WeightHistory::WeightHistory(const PersistentVector<BodyweightLog> &logs, double fallbackKg)
+    : fallback(fallbackKg > 0 ? fallbackKg : DefaultWeightKg)
+{
+    byDay.reserve(logs.size());
+    for (const BodyweightLog &b : logs) {
+        const QDate d = QDate::fromString(b.date, "yyyy-MM-dd");
+        if (d.isValid() && b.weight > 0) byDay.emplace_back(d.toJulianDay(), b.weight);
+    }
+    // stable, so the later entry of a day survives the dedupe below (matches the dashboard)
+    std::stable_sort(byDay.begin(), byDay.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    std::vector<std::pair<qint64, double>> unique;
+    unique.reserve(byDay.size());
+    for (const auto &e : byDay) {
+        if (!unique.empty() && unique.back().first == e.first) unique.back().second = e.second;
+        else unique.push_back(e);
+    }
+    byDay.swap(unique);
+}
+
+double WeightHistory::on(const QString &date) const
+{
+    if (byDay.empty()) return fallback;
+    const QDate d = QDate::fromString(date, "yyyy-MM-dd");
+    if (!d.isValid()) return byDay.back().second;
+    auto it = std::upper_bound(byDay.begin(), byDay.end(), d.toJulianDay(),
+                               [](qint64 v, const std::pair<qint64, double> &e) { return v < e.first; });
+    return it == byDay.begin() ? byDay.front().second : std::prev(it)->second;
+}
+
+RecomputeResult recompute(PersistentVector<CardioWorkout> &cardioHistory, PersistentVector<StrengthWorkout> &strengthHistory,
+                          const PersistentVector<BodyweightLog> &weightLogs, double fallbackKg)
+{
+    FT_TRACE_SCOPE("Calories::recompute");
+    const WeightHistory history(weightLogs, fallbackKg);
+    RecomputeResult r;
+    // nearly every record changes, so the lists are rebuilt rather than patched record by record
+    std::vector<CardioWorkout> cardioLog(cardioHistory.begin(), cardioHistory.end());
+    std::vector<StrengthWorkout> strengthLog(strengthHistory.begin(), strengthHistory.end());
+    for (auto &w : cardioLog) r.before += w.calories;
+    for (auto &w : strengthLog) r.before += w.calories;
+
+    // every record is independent; the lookup table is read-only
+    std::atomic<int> cardioChanged{0}, strengthChanged{0};
+    QtConcurrent::blockingMap(cardioLog, [&](CardioWorkout &w) {
+        const double kcal = cardio(w.type, history.on(w.date), w.duration);
+        if (std::abs(kcal - w.calories) > 1e-6) { w.calories = kcal; cardioChanged++; }
+    });
+    QtConcurrent::blockingMap(strengthLog, [&](StrengthWorkout &w) {
+        const double kcal = strength(history.on(w.date), w.totalVolume);
+        if (std::abs(kcal - w.calories) > 1e-6) { w.calories = kcal; strengthChanged++; }
+    });
+    r.cardioChanged = cardioChanged;
+    r.strengthChanged = strengthChanged;
+
+    for (auto &w : cardioLog) r.after += w.calories;
+    for (auto &w : strengthLog) r.after += w.calories;
+    if (r.cardioChanged) cardioHistory.assign(std::move(cardioLog));
+    if (r.strengthChanged) strengthHistory.assign(std::move(strengthLog));
+    return r;
+}
+
+} // namespace Calories
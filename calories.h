@@ -0,0 +1,55 @@
+#ifndef CALORIES_H
+#define CALORIES_H
+
+// FitTrack Pro - calorie estimates and historical recomputation
+// Each activity's MET value is a compile-time specialization of Met<>; adding an activity means one
+// enum value, one specialization and one line in metFor()/activityFromName().
+#include <QDate>
+#include <QString>
+#include <vector>
+#include "models.h"
+
+enum class ActivityType { Running, Cycling, Swimming, Walking };
+
+template <ActivityType A> struct Met; // deliberately undefined: every activity must specialize it
+template <> struct Met<ActivityType::Running>  { static constexpr double value = 9.8; };
+template <> struct Met<ActivityType::Cycling>  { static constexpr double value = 7.5; };
+template <> struct Met<ActivityType::Swimming> { static constexpr double value = 8.0; };
+template <> struct Met<ActivityType::Walking>  { static constexpr double value = 3.5; };
+
+namespace Calories {
+
+constexpr double DefaultWeightKg = 70.0; // used when neither a weigh-in nor a profile weight is known
+
+ActivityType activityFromName(const QString &type); // unknown names count as Cycling, as before
+double metFor(ActivityType a);
+
+template <ActivityType A>
+constexpr double cardio(double weightKg, int minutes) { return Met<A>::value * weightKg * (minutes / 60.0); }
+double cardio(const QString &type, double weightKg, int minutes);
+double strength(double weightKg, double volumeKg);
+
+// Bodyweight in effect on a date: the latest weigh-in on or before it, else the earliest weigh-in,
+// else the fallback
+class WeightHistory {
+public:
+    WeightHistory(const PersistentVector<BodyweightLog> &logs, double fallbackKg);
+    double on(const QString &date) const;
+
+private:
+    std::vector<std::pair<qint64, double>> byDay; // sorted by julian day, last entry per day wins
+    double fallback;
+};
+
+struct RecomputeResult {
+    int cardioChanged = 0, strengthChanged = 0;
+    double before = 0, after = 0; // total kcal over all workouts
+};
+
+// Rewrites every workout's calories from the weight in effect on its date, in parallel
+RecomputeResult recompute(PersistentVector<CardioWorkout> &cardio, PersistentVector<StrengthWorkout> &strength,
+                          const PersistentVector<BodyweightLog> &weightLogs, double fallbackKg);
+
+} // namespace Calories
+
+#endif // CALORIES_H
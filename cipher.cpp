@@ -0,0 +1,401 @@
+// cipher.cpp
+#include "cipher.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FT_CIPHER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define FT_TARGET_AVX2
+#else
+#define FT_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+inline uint32_t load32(const uint8_t *p)
+{
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+inline void store32(uint8_t *p, uint32_t v)
+{
+    p[0] = uint8_t(v); p[1] = uint8_t(v >> 8); p[2] = uint8_t(v >> 16); p[3] = uint8_t(v >> 24);
+}
+
+inline void store64(uint8_t *p, uint64_t v)
+{
+    store32(p, uint32_t(v));
+    store32(p + 4, uint32_t(v >> 32));
+}
+
+inline uint32_t rotl(uint32_t v, int n) { return (v << n) | (v >> (32 - n)); }
+
+// "expand 32-byte k", key, counter, nonce
+void initState(uint32_t s[16], const uint8_t key[32], const uint8_t nonce[12], uint32_t counter)
+{
+    s[0] = 0x61707865; s[1] = 0x3320646e; s[2] = 0x79622d32; s[3] = 0x6b206574;
+    for (int i = 0; i < 8; ++i) s[4 + i] = load32(key + 4 * i);
+    s[12] = counter;
+    for (int i = 0; i < 3; ++i) s[13 + i] = load32(nonce + 4 * i);
+}
+
+#define FT_QR(a, b, c, d)                      \
+    a += b; d ^= a; d = rotl(d, 16);           \
+    c += d; b ^= c; b = rotl(b, 12);           \
+    a += b; d ^= a; d = rotl(d, 8);            \
+    c += d; b ^= c; b = rotl(b, 7);
+
+void block(const uint32_t in[16], uint8_t out[64])
+{
+    uint32_t x[16];
+    std::memcpy(x, in, sizeof(x));
+    for (int i = 0; i < 10; ++i) {
+        FT_QR(x[0], x[4], x[8], x[12]) FT_QR(x[1], x[5], x[9], x[13])
+        FT_QR(x[2], x[6], x[10], x[14]) FT_QR(x[3], x[7], x[11], x[15])
+        FT_QR(x[0], x[5], x[10], x[15]) FT_QR(x[1], x[6], x[11], x[12])
+        FT_QR(x[2], x[7], x[8], x[13]) FT_QR(x[3], x[4], x[9], x[14])
+    }
+    for (int i = 0; i < 16; ++i) store32(out + 4 * i, x[i] + in[i]);
+}
+
+#undef FT_QR
+
+// Whole and partial blocks one at a time; the SIMD kernels hand their tails to this
+void xorScalar(uint32_t s[16], const uint8_t *in, uint8_t *out, size_t len)
+{
+    uint8_t ks[64];
+    while (len) {
+        block(s, ks);
+        const size_t n = len < 64 ? len : 64;
+        for (size_t i = 0; i < n; ++i) out[i] = in[i] ^ ks[i];
+        s[12]++;
+        in += n; out += n; len -= n;
+    }
+}
+
+#ifdef FT_CIPHER_X86
+
+// Each vector holds one state word for 4 consecutive blocks (counters s[12] .. s[12]+3)
+#define FT_ROTL128(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - n))
+#define FT_QR128(a, b, c, d)                                                        \
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = FT_ROTL128(d, 16);         \
+    c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = FT_ROTL128(b, 12);         \
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = FT_ROTL128(d, 8);          \
+    c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = FT_ROTL128(b, 7);
+
+// 4x4 transpose: word vectors a..d in, one block's 16 bytes per vector out
+inline void transpose128(__m128i &a, __m128i &b, __m128i &c, __m128i &d)
+{
+    const __m128i t0 = _mm_unpacklo_epi32(a, b), t1 = _mm_unpacklo_epi32(c, d);
+    const __m128i t2 = _mm_unpackhi_epi32(a, b), t3 = _mm_unpackhi_epi32(c, d);
+    a = _mm_unpacklo_epi64(t0, t1); b = _mm_unpackhi_epi64(t0, t1);
+    c = _mm_unpacklo_epi64(t2, t3); d = _mm_unpackhi_epi64(t2, t3);
+}
+
+inline void xor16(const uint8_t *in, uint8_t *out, __m128i ks)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in)), ks));
+}
+
+void xorSse2(uint32_t s[16], const uint8_t *in, uint8_t *out, size_t len)
+{
+    while (len >= 256) {
+        __m128i base[16], x[16];
+        for (int i = 0; i < 16; ++i) base[i] = _mm_set1_epi32(int(s[i]));
+        base[12] = _mm_add_epi32(base[12], _mm_set_epi32(3, 2, 1, 0));
+        for (int i = 0; i < 16; ++i) x[i] = base[i];
+        for (int i = 0; i < 10; ++i) {
+            FT_QR128(x[0], x[4], x[8], x[12]) FT_QR128(x[1], x[5], x[9], x[13])
+            FT_QR128(x[2], x[6], x[10], x[14]) FT_QR128(x[3], x[7], x[11], x[15])
+            FT_QR128(x[0], x[5], x[10], x[15]) FT_QR128(x[1], x[6], x[11], x[12])
+            FT_QR128(x[2], x[7], x[8], x[13]) FT_QR128(x[3], x[4], x[9], x[14])
+        }
+        for (int i = 0; i < 16; ++i) x[i] = _mm_add_epi32(x[i], base[i]);
+        for (int g = 0; g < 4; ++g) {
+            // words 4g..4g+3 of blocks 0..3 land at byte 16g of each block
+            transpose128(x[4 * g], x[4 * g + 1], x[4 * g + 2], x[4 * g + 3]);
+            for (int b = 0; b < 4; ++b) xor16(in + 64 * b + 16 * g, out + 64 * b + 16 * g, x[4 * g + b]);
+        }
+        s[12] += 4;
+        in += 256; out += 256; len -= 256;
+    }
+    xorScalar(s, in, out, len);
+}
+
+#undef FT_QR128
+#undef FT_ROTL128
+
+// Same layout as the SSE2 kernel, 8 blocks per pass: lane i of a vector is block i
+#define FT_ROTL256(v, n) _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - n))
+#define FT_QR256(a, b, c, d)                                                            \
+    a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a); d = FT_ROTL256(d, 16);       \
+    c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c); b = FT_ROTL256(b, 12);       \
+    a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a); d = FT_ROTL256(d, 8);        \
+    c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c); b = FT_ROTL256(b, 7);
+
+// 4x4 transpose inside each 128-bit half: afterwards a = [block 0 | block 4], b = [1 | 5], ...
+FT_TARGET_AVX2 inline void transpose256(__m256i &a, __m256i &b, __m256i &c, __m256i &d)
+{
+    const __m256i t0 = _mm256_unpacklo_epi32(a, b), t1 = _mm256_unpacklo_epi32(c, d);
+    const __m256i t2 = _mm256_unpackhi_epi32(a, b), t3 = _mm256_unpackhi_epi32(c, d);
+    a = _mm256_unpacklo_epi64(t0, t1); b = _mm256_unpackhi_epi64(t0, t1);
+    c = _mm256_unpacklo_epi64(t2, t3); d = _mm256_unpackhi_epi64(t2, t3);
+}
+
+FT_TARGET_AVX2 inline void xor32(const uint8_t *in, uint8_t *out, __m256i ks)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in)), ks));
+}
+
+FT_TARGET_AVX2 void xorAvx2(uint32_t s[16], const uint8_t *in, uint8_t *out, size_t len)
+{
+    while (len >= 512) {
+        __m256i base[16], x[16];
+        for (int i = 0; i < 16; ++i) base[i] = _mm256_set1_epi32(int(s[i]));
+        base[12] = _mm256_add_epi32(base[12], _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+        for (int i = 0; i < 16; ++i) x[i] = base[i];
+        for (int i = 0; i < 10; ++i) {
+            FT_QR256(x[0], x[4], x[8], x[12]) FT_QR256(x[1], x[5], x[9], x[13])
+            FT_QR256(x[2], x[6], x[10], x[14]) FT_QR256(x[3], x[7], x[11], x[15])
+            FT_QR256(x[0], x[5], x[10], x[15]) FT_QR256(x[1], x[6], x[11], x[12])
+            FT_QR256(x[2], x[7], x[8], x[13]) FT_QR256(x[3], x[4], x[9], x[14])
+        }
+        for (int i = 0; i < 16; ++i) x[i] = _mm256_add_epi32(x[i], base[i]);
+        for (int i = 0; i < 16; i += 4) transpose256(x[i], x[i + 1], x[i + 2], x[i + 3]);
+        // x[4g + b] = [words 4g..4g+3 of block b | of block b + 4]; pair groups 0/1 and 2/3 into 32-byte rows
+        for (int half = 0; half < 2; ++half) {
+            const int g = 2 * half;
+            for (int b = 0; b < 4; ++b) {
+                const __m256i lo = x[4 * g + b], hi = x[4 * (g + 1) + b];
+                xor32(in + 64 * b + 32 * half, out + 64 * b + 32 * half, _mm256_permute2x128_si256(lo, hi, 0x20));
+                xor32(in + 64 * (b + 4) + 32 * half, out + 64 * (b + 4) + 32 * half, _mm256_permute2x128_si256(lo, hi, 0x31));
+            }
+        }
+        s[12] += 8;
+        in += 512; out += 512; len -= 512;
+    }
+    xorSse2(s, in, out, len);
+}
+
+#undef FT_QR256
+#undef FT_ROTL256
+
+bool cpuHasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 6) != 6) return false; // OS saves the YMM registers
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // FT_CIPHER_X86
+
+void padTo16(Cipher::Poly1305 &mac, size_t len)
+{
+    static const uint8_t zeros[16] = {};
+    if (len % 16) mac.update(zeros, 16 - len % 16);
+}
+
+// RFC 8439 2.8: one-time Poly1305 key from block 0, MAC over aad | pad | ciphertext | pad | lengths
+void computeTag(const uint8_t key[32], const uint8_t nonce[12], const uint8_t *aad, size_t aadLen,
+                const uint8_t *ct, size_t len, uint8_t tag[16], Cipher::Kernel k)
+{
+    uint8_t polyKey[64] = {};
+    Cipher::chacha20Xor(key, nonce, 0, polyKey, polyKey, sizeof(polyKey), k);
+    Cipher::Poly1305 mac(polyKey);
+    mac.update(aad, aadLen); padTo16(mac, aadLen);
+    mac.update(ct, len); padTo16(mac, len);
+    uint8_t lens[16];
+    store64(lens, aadLen);
+    store64(lens + 8, len);
+    mac.update(lens, sizeof(lens));
+    mac.finish(tag);
+}
+
+} // namespace
+
+namespace Cipher {
+
+bool kernelSupported(Kernel k)
+{
+    switch (k) {
+    case Kernel::Scalar: return true;
+#ifdef FT_CIPHER_X86
+    case Kernel::Sse2: return true; // part of the x86-64 baseline
+    case Kernel::Avx2: { static const bool avx2 = cpuHasAvx2(); return avx2; }
+#else
+    default: return false;
+#endif
+    }
+    return false;
+}
+
+Kernel bestKernel()
+{
+    static const Kernel best = kernelSupported(Kernel::Avx2) ? Kernel::Avx2 : kernelSupported(Kernel::Sse2) ? Kernel::Sse2 : Kernel::Scalar;
+    return best;
+}
+
+const char *kernelName(Kernel k)
+{
+    switch (k) {
+    case Kernel::Scalar: return "scalar";
+    case Kernel::Sse2: return "sse2";
+    case Kernel::Avx2: return "avx2";
+    }
+    return "?";
+}
+
+void chacha20Xor(const uint8_t key[KeySize], const uint8_t nonce[NonceSize], uint32_t counter,
+                 const uint8_t *in, uint8_t *out, size_t len, Kernel k)
+{
+    uint32_t s[16];
+    initState(s, key, nonce, counter);
+    if (!kernelSupported(k)) k = Kernel::Scalar;
+    switch (k) {
+#ifdef FT_CIPHER_X86
+    case Kernel::Avx2: xorAvx2(s, in, out, len); break;
+    case Kernel::Sse2: xorSse2(s, in, out, len); break;
+#endif
+    default: xorScalar(s, in, out, len); break;
+    }
+}
+
+Poly1305::Poly1305(const uint8_t key[32])
+{
+    // clamp r (RFC 8439 2.5) and split it into 26-bit limbs
+    r[0] = load32(key + 0) & 0x3ffffff;
+    r[1] = (load32(key + 3) >> 2) & 0x3ffff03;
+    r[2] = (load32(key + 6) >> 4) & 0x3ffc0ff;
+    r[3] = (load32(key + 9) >> 6) & 0x3f03fff;
+    r[4] = (load32(key + 12) >> 8) & 0x00fffff;
+    for (int i = 0; i < 4; ++i) pad[i] = load32(key + 16 + 4 * i);
+}
+
+void Poly1305::blocks(const uint8_t *m, size_t bytes, bool final)
+{
+    const uint32_t hibit = final ? 0 : (1u << 24);
+    const uint32_t r0 = r[0], r1 = r[1], r2 = r[2], r3 = r[3], r4 = r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4];
+    while (bytes >= 16) {
+        h0 += load32(m + 0) & 0x3ffffff;
+        h1 += (load32(m + 3) >> 2) & 0x3ffffff;
+        h2 += (load32(m + 6) >> 4) & 0x3ffffff;
+        h3 += (load32(m + 9) >> 6) & 0x3ffffff;
+        h4 += (load32(m + 12) >> 8) | hibit;
+
+        uint64_t d0 = uint64_t(h0) * r0 + uint64_t(h1) * s4 + uint64_t(h2) * s3 + uint64_t(h3) * s2 + uint64_t(h4) * s1;
+        uint64_t d1 = uint64_t(h0) * r1 + uint64_t(h1) * r0 + uint64_t(h2) * s4 + uint64_t(h3) * s3 + uint64_t(h4) * s2;
+        uint64_t d2 = uint64_t(h0) * r2 + uint64_t(h1) * r1 + uint64_t(h2) * r0 + uint64_t(h3) * s4 + uint64_t(h4) * s3;
+        uint64_t d3 = uint64_t(h0) * r3 + uint64_t(h1) * r2 + uint64_t(h2) * r1 + uint64_t(h3) * r0 + uint64_t(h4) * s4;
+        uint64_t d4 = uint64_t(h0) * r4 + uint64_t(h1) * r3 + uint64_t(h2) * r2 + uint64_t(h3) * r1 + uint64_t(h4) * r0;
+
+        uint32_t c = uint32_t(d0 >> 26); h0 = uint32_t(d0) & 0x3ffffff;
+        d1 += c; c = uint32_t(d1 >> 26); h1 = uint32_t(d1) & 0x3ffffff;
+        d2 += c; c = uint32_t(d2 >> 26); h2 = uint32_t(d2) & 0x3ffffff;
+        d3 += c; c = uint32_t(d3 >> 26); h3 = uint32_t(d3) & 0x3ffffff;
+        d4 += c; c = uint32_t(d4 >> 26); h4 = uint32_t(d4) & 0x3ffffff;
+        h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+        h1 += c;
+
+        m += 16; bytes -= 16;
+    }
+    h[0] = h0; h[1] = h1; h[2] = h2; h[3] = h3; h[4] = h4;
+}
+
+void Poly1305::update(const uint8_t *data, size_t len)
+{
+    if (leftover) {
+        const size_t want = std::min<size_t>(16 - leftover, len);
+        std::memcpy(buffer + leftover, data, want);
+        leftover += want; data += want; len -= want;
+        if (leftover < 16) return;
+        blocks(buffer, 16, false);
+        leftover = 0;
+    }
+    if (len >= 16) {
+        const size_t whole = len & ~size_t(15);
+        blocks(data, whole, false);
+        data += whole; len -= whole;
+    }
+    if (len) {
+        std::memcpy(buffer, data, len);
+        leftover = len;
+    }
+}
+
+void Poly1305::finish(uint8_t tag[TagSize])
+{
+    if (leftover) {
+        buffer[leftover] = 1;
+        std::memset(buffer + leftover + 1, 0, 16 - leftover - 1);
+        blocks(buffer, 16, true);
+    }
+
+    uint32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4], c;
+    c = h1 >> 26; h1 &= 0x3ffffff;
+    h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+    h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+    h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+
+    // h - p, selected in constant time if h >= p
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+    uint32_t g4 = h4 + c - (1u << 26);
+    uint32_t mask = (g4 >> 31) - 1;
+    g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0; h1 = (h1 & mask) | g1; h2 = (h2 & mask) | g2; h3 = (h3 & mask) | g3; h4 = (h4 & mask) | g4;
+
+    // h mod 2^128, plus the pad
+    h0 = h0 | (h1 << 26);
+    h1 = (h1 >> 6) | (h2 << 20);
+    h2 = (h2 >> 12) | (h3 << 14);
+    h3 = (h3 >> 18) | (h4 << 8);
+    uint64_t f = uint64_t(h0) + pad[0]; h0 = uint32_t(f);
+    f = uint64_t(h1) + pad[1] + (f >> 32); h1 = uint32_t(f);
+    f = uint64_t(h2) + pad[2] + (f >> 32); h2 = uint32_t(f);
+    f = uint64_t(h3) + pad[3] + (f >> 32); h3 = uint32_t(f);
+    store32(tag + 0, h0); store32(tag + 4, h1); store32(tag + 8, h2); store32(tag + 12, h3);
+
+    std::memset(r, 0, sizeof(r)); std::memset(h, 0, sizeof(h)); std::memset(pad, 0, sizeof(pad));
+}
+
+void seal(const uint8_t key[KeySize], const uint8_t nonce[NonceSize], const uint8_t *aad, size_t aadLen,
+          const uint8_t *in, uint8_t *out, size_t len, uint8_t tag[TagSize], Kernel k)
+{
+    chacha20Xor(key, nonce, 1, in, out, len, k);
+    computeTag(key, nonce, aad, aadLen, out, len, tag, k);
+}
+
+bool open(const uint8_t key[KeySize], const uint8_t nonce[NonceSize], const uint8_t *aad, size_t aadLen,
+          const uint8_t *in, uint8_t *out, size_t len, const uint8_t tag[TagSize], Kernel k)
+{
+    uint8_t expect[TagSize];
+    computeTag(key, nonce, aad, aadLen, in, len, expect, k);
+    uint8_t diff = 0;
+    for (size_t i = 0; i < TagSize; ++i) diff |= uint8_t(expect[i] ^ tag[i]);
+    if (diff) return false;
+    chacha20Xor(key, nonce, 1, in, out, len, k);
+    return true;
+}
+
+} // namespace Cipher
@@ -0,0 +1,47 @@
+#ifndef CIPHER_H
+#define CIPHER_H
+
+// FitTrack Pro - self-contained ChaCha20-Poly1305 (RFC 8439) for the encrypted .dat files.
+// The ChaCha20 keystream has scalar, SSE2 (4 blocks at a time) and AVX2 (8 blocks) kernels,
+// picked once per process from the CPU; Poly1305 is the portable 26-bit-limb form.
+#include <cstddef>
+#include <cstdint>
+
+namespace Cipher {
+
+constexpr size_t KeySize = 32, NonceSize = 12, TagSize = 16;
+
+enum class Kernel { Scalar, Sse2, Avx2 };
+
+Kernel bestKernel();                 // fastest kernel this CPU supports
+bool kernelSupported(Kernel k);
+const char *kernelName(Kernel k);
+
+// out = in ^ keystream(key, nonce) starting at block `counter`; in and out may alias
+void chacha20Xor(const uint8_t key[KeySize], const uint8_t nonce[NonceSize], uint32_t counter,
+                 const uint8_t *in, uint8_t *out, size_t len, Kernel k = bestKernel());
+
+class Poly1305 {
+public:
+    explicit Poly1305(const uint8_t key[32]);
+    void update(const uint8_t *data, size_t len);
+    void finish(uint8_t tag[TagSize]);
+
+private:
+    void blocks(const uint8_t *m, size_t bytes, bool final);
+
+    uint32_t r[5], h[5] = {0, 0, 0, 0, 0}, pad[4];
+    uint8_t buffer[16];
+    size_t leftover = 0;
+};
+
+// AEAD: seal encrypts len bytes and writes the tag; open verifies the tag before decrypting
+// and returns false (leaving out untouched) on mismatch. in and out may alias.
+void seal(const uint8_t key[KeySize], const uint8_t nonce[NonceSize], const uint8_t *aad, size_t aadLen,
+          const uint8_t *in, uint8_t *out, size_t len, uint8_t tag[TagSize], Kernel k = bestKernel());
+bool open(const uint8_t key[KeySize], const uint8_t nonce[NonceSize], const uint8_t *aad, size_t aadLen,
+          const uint8_t *in, uint8_t *out, size_t len, const uint8_t tag[TagSize], Kernel k = bestKernel());
+
+} // namespace Cipher
+
+#endif // CIPHER_H
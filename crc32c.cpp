@@ -0,0 +1,164 @@
+// crc32c.cpp
+#include "crc32c.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FT_CRC_X86 1
+#include <nmmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define FT_TARGET_SSE42
+#else
+#define FT_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+#endif
+
+namespace {
+
+constexpr uint32_t Poly = 0x82f63b78; // reflected Castagnoli polynomial
+
+struct Tables {
+    uint32_t t[8][256];
+    Tables()
+    {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (Poly & (0u - (c & 1)));
+            t[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; ++i)
+            for (int s = 1; s < 8; ++s) t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xff];
+    }
+};
+
+const Tables &tables()
+{
+    static const Tables tab;
+    return tab;
+}
+
+#ifdef FT_CRC_X86
+
+// Three independent streams hide the instruction's 3-cycle latency. Each partial CRC is then moved
+// past the bytes that followed it; appending zeros is linear in the register, so a 4x256 table per
+// distance does that in four lookups.
+constexpr size_t Stride = 8192;
+
+FT_TARGET_SSE42 uint64_t crcRun(uint64_t crc, const unsigned char *p, size_t words)
+{
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t v;
+        std::memcpy(&v, p + 8 * i, 8);
+        crc = _mm_crc32_u64(crc, v);
+    }
+    return crc;
+}
+
+struct ShiftTable {
+    uint32_t t[4][256];
+
+    // register after `len` zero bytes
+    FT_TARGET_SSE42 explicit ShiftTable(size_t len)
+    {
+        uint32_t bit[32];
+        for (int b = 0; b < 32; ++b) {
+            uint64_t c = 1u << b;
+            for (size_t i = 0; i < len / 8; ++i) c = _mm_crc32_u64(c, 0);
+            bit[b] = uint32_t(c);
+        }
+        for (int k = 0; k < 4; ++k)
+            for (uint32_t v = 0; v < 256; ++v) {
+                uint32_t r = 0;
+                for (int b = 0; b < 8; ++b) if (v & (1u << b)) r ^= bit[8 * k + b];
+                t[k][v] = r;
+            }
+    }
+
+    uint32_t operator()(uint32_t c) const
+    {
+        return t[0][c & 0xff] ^ t[1][(c >> 8) & 0xff] ^ t[2][(c >> 16) & 0xff] ^ t[3][c >> 24];
+    }
+};
+
+FT_TARGET_SSE42 uint32_t computeHardware(const unsigned char *p, size_t len, uint32_t crc)
+{
+    static const ShiftTable shift1(Stride), shift2(2 * Stride);
+    uint64_t c0 = ~crc;
+    while (len >= 3 * Stride) {
+        uint64_t c1 = 0, c2 = 0;
+        const size_t words = Stride / 8;
+        for (size_t i = 0; i < words; ++i) {
+            uint64_t a, b, d;
+            std::memcpy(&a, p + 8 * i, 8);
+            std::memcpy(&b, p + Stride + 8 * i, 8);
+            std::memcpy(&d, p + 2 * Stride + 8 * i, 8);
+            c0 = _mm_crc32_u64(c0, a);
+            c1 = _mm_crc32_u64(c1, b);
+            c2 = _mm_crc32_u64(c2, d);
+        }
+        c0 = shift2(uint32_t(c0)) ^ shift1(uint32_t(c1)) ^ uint32_t(c2);
+        p += 3 * Stride; len -= 3 * Stride;
+    }
+    c0 = crcRun(c0, p, len / 8);
+    p += len & ~size_t(7); len &= 7;
+    uint32_t c = uint32_t(c0);
+    while (len--) c = _mm_crc32_u8(c, *p++);
+    return ~c;
+}
+
+bool cpuHasSse42()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+#endif // FT_CRC_X86
+
+} // namespace
+
+namespace Crc32c {
+
+uint32_t computeSoftware(const void *data, size_t len, uint32_t crc)
+{
+    const Tables &tab = tables();
+    const auto *p = static_cast<const unsigned char *>(data);
+    uint32_t c = ~crc;
+    // slicing-by-8: eight table lookups per 8 input bytes
+    while (len >= 8) {
+        uint32_t lo, hi;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 4);
+        lo ^= c; // little-endian load, as on every platform this ships on
+        c = tab.t[7][lo & 0xff] ^ tab.t[6][(lo >> 8) & 0xff] ^ tab.t[5][(lo >> 16) & 0xff] ^ tab.t[4][lo >> 24]
+            ^ tab.t[3][hi & 0xff] ^ tab.t[2][(hi >> 8) & 0xff] ^ tab.t[1][(hi >> 16) & 0xff] ^ tab.t[0][hi >> 24];
+        p += 8; len -= 8;
+    }
+    while (len--) c = (c >> 8) ^ tab.t[0][(c ^ *p++) & 0xff];
+    return ~c;
+}
+
+bool hasHardware()
+{
+#ifdef FT_CRC_X86
+    static const bool sse42 = cpuHasSse42();
+    return sse42;
+#else
+    return false;
+#endif
+}
+
+uint32_t compute(const void *data, size_t len, uint32_t crc)
+{
+#ifdef FT_CRC_X86
+    if (hasHardware()) return computeHardware(static_cast<const unsigned char *>(data), len, crc);
+#endif
+    return computeSoftware(data, len, crc);
+}
+
+} // namespace Crc32c
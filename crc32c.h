@@ -0,0 +1,17 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+// FitTrack Pro - CRC32C (Castagnoli) for the checksummed .dat container.
+// Uses the SSE4.2 crc32 instruction when the CPU has it, slicing-by-8 tables otherwise.
+#include <cstddef>
+#include <cstdint>
+
+namespace Crc32c {
+
+uint32_t compute(const void *data, size_t len, uint32_t crc = 0);
+uint32_t computeSoftware(const void *data, size_t len, uint32_t crc = 0);
+bool hasHardware();
+
+} // namespace Crc32c
+
+#endif // CRC32C_H
@@ -0,0 +1,161 @@
+// datafile.cpp
+#include "datafile.h"
+#include "crc32c.h"
+#include "securestore.h"
+#include "tracing.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// 0xff never occurs in UTF-8, so no legacy plaintext file starts with this
+constexpr char Magic[4] = {'\xff', 'F', 'T', 'C'};
+constexpr int HeaderSize = 16; // magic, block size, payload length
+
+quint32 get32(const char *p)
+{
+    const auto *u = reinterpret_cast<const uint8_t *>(p);
+    return quint32(u[0]) | quint32(u[1]) << 8 | quint32(u[2]) << 16 | quint32(u[3]) << 24;
+}
+
+void put32(char *p, quint32 v)
+{
+    for (int i = 0; i < 4; ++i) p[i] = char(v >> (8 * i));
+}
+
+bool isChecked(QByteArrayView buf)
+{
+    return buf.size() >= HeaderSize && std::memcmp(buf.data(), Magic, 4) == 0;
+}
+
+// Payload minus every line that overlaps a bad byte range
+QByteArray salvage(QByteArrayView payload, const std::vector<std::pair<qsizetype, qsizetype>> &bad)
+{
+    QByteArray out;
+    out.reserve(payload.size());
+    qsizetype pos = 0;
+    for (auto [from, to] : bad) {
+        from = qMin(from, payload.size());
+        // back to the start of the line holding `from`, forward past the end of the one holding `to - 1`
+        qsizetype cut = from;
+        while (cut > pos && payload[cut - 1] != '\n') --cut;
+        if (cut > pos) out.append(payload.sliced(pos, cut - pos));
+        qsizetype resume = qMin(to, payload.size());
+        while (resume < payload.size() && payload[resume - 1] != '\n') ++resume;
+        pos = qMax(pos, resume);
+    }
+    if (pos < payload.size()) out.append(payload.sliced(pos));
+    return out;
+}
+
+DataFile::Contents verify(QByteArrayView buf, DataFile::Contents c)
+{
+    FT_TRACE_SCOPE("DataFile::verify");
+    const qsizetype blockSize = get32(buf.data() + 4);
+    const quint64 length = quint64(get32(buf.data() + 8)) | quint64(get32(buf.data() + 12)) << 32;
+    if (blockSize <= 0 || length > quint64(buf.size())) {
+        c.status = DataFile::Status::Damaged;
+        c.problem = "container header is corrupt";
+        return c;
+    }
+    const qsizetype blocks = qsizetype((length + blockSize - 1) / blockSize);
+    const qsizetype payloadAt = HeaderSize + 4 * blocks;
+    const QByteArrayView payload = buf.sliced(qMin(payloadAt, buf.size()));
+    std::vector<std::pair<qsizetype, qsizetype>> bad;
+    for (qsizetype b = 0; b < blocks; ++b) {
+        const qsizetype off = b * blockSize, len = qMin<qsizetype>(blockSize, qsizetype(length) - off);
+        const bool present = payloadAt + off + len <= buf.size();
+        if (!present || Crc32c::compute(payload.data() + off, size_t(len)) != get32(buf.data() + HeaderSize + 4 * b)) {
+            if (!bad.empty() && bad.back().second == off) bad.back().second = off + len;
+            else bad.emplace_back(off, off + len);
+        }
+    }
+    if (bad.empty()) {
+        c.view = payload.first(qsizetype(length));
+        return c;
+    }
+    qsizetype badBlocks = 0;
+    for (auto [from, to] : bad) badBlocks += (to - from + blockSize - 1) / blockSize;
+    c.status = DataFile::Status::Damaged;
+    c.problem = QString("%1 of %2 blocks failed CRC32C").arg(badBlocks).arg(blocks);
+    c.owned = salvage(payload.first(qMin(payload.size(), qsizetype(length))), bad);
+    c.view = QByteArrayView(c.owned);
+    return c;
+}
+
+} // namespace
+
+namespace DataFile {
+
+QByteArray wrap(QByteArrayView plain)
+{
+    FT_TRACE_SCOPE("DataFile::wrap");
+    const qsizetype blocks = (plain.size() + BlockSize - 1) / BlockSize;
+    QByteArray out(HeaderSize + 4 * blocks, Qt::Uninitialized);
+    char *h = out.data();
+    std::memcpy(h, Magic, 4);
+    put32(h + 4, BlockSize);
+    put32(h + 8, quint32(quint64(plain.size())));
+    put32(h + 12, quint32(quint64(plain.size()) >> 32));
+    for (qsizetype b = 0; b < blocks; ++b) {
+        const qsizetype off = b * BlockSize;
+        put32(h + HeaderSize + 4 * b, Crc32c::compute(plain.data() + off, size_t(qMin<qsizetype>(BlockSize, plain.size() - off))));
+    }
+    out.append(plain);
+    return out;
+}
+
+Contents read(const QString &path, const QByteArray &key)
+{
+    Contents c;
+    c.file = std::make_shared<QFile>(path);
+    if (!c.file->open(QIODevice::ReadOnly)) return c; // Missing
+    c.status = Status::Ok;
+    QByteArrayView buf;
+    const qint64 size = c.file->size();
+    if (size > 0) {
+        if (uchar *m = c.file->map(0, size)) buf = QByteArrayView(reinterpret_cast<const char *>(m), size); // unmapped when the QFile goes
+        else { c.owned = c.file->readAll(); buf = QByteArrayView(c.owned); }
+    }
+
+    if (SecureStore::isSealed(buf)) {
+        if (key.isEmpty()) { c.status = Status::Locked; return c; }
+        QByteArray plain;
+        if (!SecureStore::open(buf, key, plain)) {
+            c.status = Status::Damaged;
+            c.problem = "failed authentication";
+            return c;
+        }
+        c.owned = std::move(plain);
+        c.view = QByteArrayView(c.owned);
+        return c;
+    }
+    if (isChecked(buf)) return verify(buf, std::move(c));
+    c.view = buf; // legacy plaintext, upgraded on the next save
+    return c;
+}
+
+bool write(const QString &path, const QByteArray &plain, const QByteArray &key, bool snapshot)
+{
+    FT_TRACE_SCOPE("DataFile::write");
+    const QByteArray data = key.isEmpty() ? wrap(plain) : SecureStore::seal(plain, key);
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly) || f.write(data) != data.size()) { f.cancelWriting(); return false; }
+    if (snapshot && QFileInfo::exists(path)) {
+        // between these renames and the commit there is only the snapshot; read() callers fall back to it
+        QFile::remove(snapshotPath(path));
+        QFile::rename(path, snapshotPath(path));
+    }
+    return f.commit();
+}
+
+QString snapshotPath(const QString &path)
+{
+    return path + ".bak";
+}
+
+} // namespace DataFile
@@ -0,0 +1,45 @@
+#ifndef DATAFILE_H
+#define DATAFILE_H
+
+// FitTrack Pro - on-disk form of the per-user .dat files
+// Plaintext files sit in a checksummed container: 0xff "FTC" | block size | payload length |
+// one CRC32C per block | payload. The payload stays contiguous, so once verified the parsers read
+// it in place from the mapping. Encrypted files (securestore.h) are checked by their Poly1305 tags.
+// Saves go through QSaveFile, so an interrupted save leaves the old file or the new one, never a
+// mix; a save may first move the previous file to <file>.bak, the snapshot loads fall back to.
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <memory>
+
+class QFile;
+
+namespace DataFile {
+
+constexpr int BlockSize = 64 * 1024;
+
+enum class Status { Ok, Missing, Locked, Damaged };
+
+struct Contents {
+    Status status = Status::Missing;
+    QByteArrayView view; // the plaintext; for Damaged, what survived (lines touching a bad block dropped)
+    QString problem;     // for Damaged: what failed verification
+
+    // keep `view` alive
+    std::shared_ptr<QFile> file;
+    QByteArray owned;
+};
+
+QByteArray wrap(QByteArrayView plain);
+
+// Verifies (or decrypts with `key`) one file; legacy files without a container load unchecked
+Contents read(const QString &path, const QByteArray &key);
+
+// Sealed with `key` if given, else wrapped; with snapshot=true the current file becomes the .bak first
+bool write(const QString &path, const QByteArray &plain, const QByteArray &key, bool snapshot);
+
+QString snapshotPath(const QString &path);
+
+} // namespace DataFile
+
+#endif // DATAFILE_H
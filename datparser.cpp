@@ -0,0 +1,423 @@
+// datparser.cpp
+// Zero-copy tokenizer for profile_/cardio_/strength_/weight_/goals_<user>.dat
+#include "datparser.h"
+#include "datafile.h"
+#include "tracing.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QtConcurrent>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+namespace DatParser {
+
+namespace {
+
+// Map the file (fall back to readAll for sequential devices) and hand the bytes to fn
+template <typename Fn>
+auto withFileBuffer(const QString &path, Fn &&fn) -> decltype(fn(QByteArrayView()))
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return fn(QByteArrayView());
+    const qint64 size = f.size();
+    if (size > 0) {
+        if (uchar *m = f.map(0, size)) {
+            auto r = fn(QByteArrayView(reinterpret_cast<const char *>(m), size));
+            f.unmap(m);
+            return r;
+        }
+    }
+    const QByteArray all = f.readAll();
+    return fn(QByteArrayView(all));
+}
+
+// What loading one per-user file ran into; one per file, so the pool tasks never share one
+struct FileState {
+    bool locked = false;
+    QString problem;
+};
+
+// The verified (or decrypted) bytes of a per-user file. A damaged or missing file falls back to the
+// snapshot of the previous session; without one fn sees whatever survived verification. An
+// encrypted file without a matching key, or damaged past use, sets locked and fn sees nothing.
+template <typename Fn>
+auto withDataFile(const QString &path, const QByteArray &key, FileState &st, Fn &&fn) -> decltype(fn(QByteArrayView()))
+{
+    const DataFile::Contents c = DataFile::read(path, key);
+    if (c.status == DataFile::Status::Ok) return fn(c.view);
+    if (c.status == DataFile::Status::Locked) {
+        st.locked = true;
+        return fn(QByteArrayView());
+    }
+    const DataFile::Contents bak = DataFile::read(DataFile::snapshotPath(path), key);
+    const QString name = QFileInfo(path).fileName();
+    if (c.status == DataFile::Status::Missing) {
+        // only a save interrupted between moving the file aside and committing the new one leaves this
+        if (bak.status == DataFile::Status::Ok) st.problem = name + ": missing, restored from snapshot";
+        return fn(bak.status == DataFile::Status::Ok ? bak.view : QByteArrayView());
+    }
+    if (bak.status == DataFile::Status::Ok) {
+        st.problem = name + ": " + c.problem + ", restored from snapshot";
+        return fn(bak.view);
+    }
+    if (c.view.isEmpty()) {
+        st.problem = name + ": " + c.problem + ", no usable snapshot";
+        st.locked = true; // nothing to show, and saving would overwrite what is left
+        return fn(QByteArrayView());
+    }
+    st.problem = name + ": " + c.problem + ", no usable snapshot; the damaged lines were dropped";
+    return fn(c.view);
+}
+
+qsizetype countLines(QByteArrayView buf)
+{
+    return std::count(buf.data(), buf.data() + buf.size(), '\n') + 1;
+}
+
+// Calls fn for every line without its "\n" / "\r\n" terminator
+template <typename Fn>
+void forEachLine(QByteArrayView buf, Fn &&fn)
+{
+    const char *p = buf.data();
+    const char *end = p + buf.size();
+    while (p < end) {
+        const char *nl = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)));
+        const char *e = nl ? nl : end;
+        if (e > p && e[-1] == '\r') --e;
+        fn(QByteArrayView(p, e - p));
+        p = nl ? nl + 1 : end;
+    }
+}
+
+// Same token semantics as QString::split(sep): always at least one (possibly empty) token
+template <typename Fn>
+void forEachToken(QByteArrayView v, char sep, Fn &&fn)
+{
+    const char *p = v.data();
+    const char *end = p + v.size();
+    for (;;) {
+        const char *s = p < end ? static_cast<const char *>(std::memchr(p, sep, size_t(end - p))) : nullptr;
+        fn(QByteArrayView(p, (s ? s : end) - p));
+        if (!s) return;
+        p = s + 1;
+    }
+}
+
+// Fills out[0..maxFields) and returns the number of fields found (capped at maxFields)
+int splitFields(QByteArrayView line, char sep, QByteArrayView *out, int maxFields)
+{
+    int n = 0;
+    const char *p = line.data();
+    const char *end = p + line.size();
+    while (n < maxFields) {
+        const char *s = p < end ? static_cast<const char *>(std::memchr(p, sep, size_t(end - p))) : nullptr;
+        out[n++] = QByteArrayView(p, (s ? s : end) - p);
+        if (!s) break;
+        p = s + 1;
+    }
+    return n;
+}
+
+double toDouble(QByteArrayView v)
+{
+    double d = 0;
+    std::from_chars(v.data(), v.data() + v.size(), d);
+    return d;
+}
+
+int toInt(QByteArrayView v)
+{
+    int i = 0;
+    std::from_chars(v.data(), v.data() + v.size(), i);
+    return i;
+}
+
+// Dates and numbers are plain ASCII
+QString latin1(QByteArrayView v) { return QString::fromLatin1(v.data(), v.size()); }
+
+// Shares one QString per distinct value; activity types and exercise names repeat on almost every line
+class Interner {
+public:
+    const QString &get(QByteArrayView v) {
+        std::string_view key(v.data(), size_t(v.size()));
+        auto it = table.find(key);
+        if (it == table.end()) it = table.emplace(key, QString::fromUtf8(v.data(), v.size())).first;
+        return it->second;
+    }
+
+private:
+    std::unordered_map<std::string_view, QString> table; // keys point into the file buffer
+};
+
+} // namespace
+
+QString userFilePath(const QString &dir, const QString &prefix, const QString &username)
+{
+    return QDir(dir).filePath(prefix + username + ".dat");
+}
+
+bool parseProfile(QByteArrayView buf, UserProfile &out)
+{
+    // profile format: gender|weight|targetBodyweight|height|age (first line only)
+    bool ok = false, first = true;
+    forEachLine(buf, [&](QByteArrayView line) {
+        if (!first) return;
+        first = false;
+        QByteArrayView p[5];
+        if (splitFields(line, '|', p, 5) < 5) return;
+        out.gender = QString::fromUtf8(p[0].data(), p[0].size());
+        out.weight = toDouble(p[1]);
+        out.targetBodyweight = toDouble(p[2]);
+        out.height = toDouble(p[3]);
+        out.age = toInt(p[4]);
+        ok = true;
+    });
+    return ok;
+}
+
+std::vector<CardioWorkout> parseCardio(QByteArrayView buf)
+{
+    FT_TRACE_SCOPE("parseCardio");
+    std::vector<CardioWorkout> out;
+    out.reserve(size_t(countLines(buf)));
+    Interner types;
+    QByteArrayView p[10];
+    forEachLine(buf, [&](QByteArrayView line) {
+        // Format: date|type|duration|distance|calories|avgSpeed[|elevationGain|split;split|samples|avgHr;maxHr;z1;..;z5]
+        // (the tail only for GPS imports)
+        const int n = splitFields(line, '|', p, 10);
+        if (n < 6) return;
+        CardioWorkout w;
+        w.date = latin1(p[0]);
+        w.type = types.get(p[1]);
+        w.duration = toInt(p[2]);
+        w.distance = toDouble(p[3]);
+        w.calories = toDouble(p[4]);
+        w.avgSpeed = toDouble(p[5]);
+        if (n > 6) w.elevationGain = toDouble(p[6]);
+        if (n > 7 && !p[7].isEmpty()) forEachToken(p[7], ';', [&](QByteArrayView s) { w.splits.push_back(toInt(s)); });
+        if (n > 8) w.samples = latin1(p[8]);
+        if (n > 9) {
+            int hr[7] = {}, i = 0;
+            forEachToken(p[9], ';', [&](QByteArrayView s) { if (i < 7) hr[i++] = toInt(s); });
+            w.heartRate.average = hr[0]; w.heartRate.maximum = hr[1];
+            std::copy(hr + 2, hr + 7, w.heartRate.zoneSeconds);
+        }
+        out.push_back(std::move(w));
+    });
+    return out;
+}
+
+std::vector<StrengthWorkout> parseStrength(QByteArrayView buf)
+{
+    FT_TRACE_SCOPE("parseStrength");
+    std::vector<StrengthWorkout> out;
+    out.reserve(size_t(countLines(buf)));
+    Interner names;
+    QByteArrayView p[7];
+    forEachLine(buf, [&](QByteArrayView line) {
+        // Format: date|calories|exercises[|volume|sets|reps|exVolume;exVolume]   exercises = name:RxW,RxW;name:RxW
+        const int n = splitFields(line, '|', p, 7);
+        if (n < 3) return;
+        StrengthWorkout w;
+        w.date = latin1(p[0]);
+        w.calories = toDouble(p[1]);
+        forEachToken(p[2], ';', [&](QByteArrayView es) {
+            QByteArrayView ep[2];
+            if (splitFields(es, ':', ep, 2) < 2) return;
+            Exercise ex;
+            ex.name = names.get(ep[0]);
+            forEachToken(ep[1], ',', [&](QByteArrayView ss) {
+                QByteArrayView sp[2];
+                if (splitFields(ss, 'x', sp, 2) < 2) return;
+                ex.sets.push_back(ExerciseSet{toInt(sp[0]), toDouble(sp[1])});
+            });
+            w.exercises.push_back(std::move(ex));
+        });
+        // files written before the totals were stored (or with a mismatched list) are summed once here
+        bool stored = n >= 7;
+        if (stored) {
+            size_t i = 0;
+            forEachToken(p[6], ';', [&](QByteArrayView v) { if (i < w.exercises.size()) w.exercises[i].volume = toDouble(v); ++i; });
+            stored = i == w.exercises.size() || (w.exercises.empty() && p[6].isEmpty());
+        }
+        if (stored) { w.totalVolume = toDouble(p[3]); w.setCount = toInt(p[4]); w.repCount = toInt(p[5]); }
+        else w.updateTotals();
+        out.push_back(std::move(w));
+    });
+    return out;
+}
+
+std::vector<BodyweightLog> parseWeights(QByteArrayView buf)
+{
+    FT_TRACE_SCOPE("parseWeights");
+    std::vector<BodyweightLog> out;
+    out.reserve(size_t(countLines(buf)));
+    QByteArrayView p[2];
+    forEachLine(buf, [&](QByteArrayView line) {
+        // Format: date|weight
+        if (splitFields(line, '|', p, 2) < 2) return;
+        out.push_back(BodyweightLog{latin1(p[0]), toDouble(p[1])});
+    });
+    return out;
+}
+
+std::vector<Goal> parseGoals(QByteArrayView buf)
+{
+    FT_TRACE_SCOPE("parseGoals");
+    std::vector<Goal> out;
+    QByteArrayView p[10];
+    forEachLine(buf, [&](QByteArrayView line) {
+        const int n = splitFields(line, '|', p, 10);
+        if (n < 6) return;
+        Goal g;
+        g.name = QString::fromUtf8(p[0].data(), p[0].size()); g.type = latin1(p[1]);
+        g.target = toDouble(p[2]); g.progress = toDouble(p[3]);
+        g.targetTime = toInt(p[4]); g.progressTime = toInt(p[5]);
+        if (n >= 10) {
+            g.exerciseName = QString::fromUtf8(p[6].data(), p[6].size()); g.exWeight = toDouble(p[7]);
+            g.exSets = toInt(p[8]); g.exReps = toInt(p[9]);
+        }
+        out.push_back(std::move(g));
+    });
+    return out;
+}
+
+std::vector<UserAccount> loadUserIndex(const QString &dir)
+{
+    return withFileBuffer(QDir(dir).filePath("users.dat"), [](QByteArrayView buf) {
+        std::vector<UserAccount> out;
+        QByteArrayView p[3];
+        forEachLine(buf, [&](QByteArrayView line) {
+            if (splitFields(line, '|', p, 3) < 3) return;
+            out.push_back(UserAccount{QString::fromUtf8(p[0].data(), p[0].size()), latin1(p[1]),
+                                      QString::fromUtf8(p[2].data(), p[2].size())});
+        });
+        return out;
+    });
+}
+
+UserData loadUserData(const QString &username, const QString &dir, bool concurrent, const QByteArray &key)
+{
+    FT_TRACE_SCOPE("loadUserData");
+    UserData data;
+    const QString cardioPath = userFilePath(dir, "cardio_", username);
+    const QString strengthPath = userFilePath(dir, "strength_", username);
+    const QString weightPath = userFilePath(dir, "weight_", username);
+    const QString goalsPath = userFilePath(dir, "goals_", username);
+    FileState state[5];
+    auto loadProfile = [&] {
+        data.hasProfile = withDataFile(userFilePath(dir, "profile_", username), key, state[0],
+                                       [&](QByteArrayView b) { return parseProfile(b, data.profile); });
+    };
+
+    if (!concurrent) {
+        loadProfile();
+        data.cardio.assign(withDataFile(cardioPath, key, state[1], parseCardio));
+        data.strength.assign(withDataFile(strengthPath, key, state[2], parseStrength));
+        data.weightLogs.assign(withDataFile(weightPath, key, state[3], parseWeights));
+        data.goals.assign(withDataFile(goalsPath, key, state[4], parseGoals));
+    } else {
+        // the four record files go to the pool; the one-line profile is read here meanwhile
+        auto cf = QtConcurrent::run([&] { return withDataFile(cardioPath, key, state[1], parseCardio); });
+        auto sf = QtConcurrent::run([&] { return withDataFile(strengthPath, key, state[2], parseStrength); });
+        auto wf = QtConcurrent::run([&] { return withDataFile(weightPath, key, state[3], parseWeights); });
+        auto gf = QtConcurrent::run([&] { return withDataFile(goalsPath, key, state[4], parseGoals); });
+        loadProfile();
+        data.cardio.assign(cf.takeResult());
+        data.strength.assign(sf.takeResult());
+        data.weightLogs.assign(wf.takeResult());
+        data.goals.assign(gf.takeResult());
+    }
+    for (const FileState &st : state) {
+        data.locked |= st.locked;
+        if (!st.problem.isEmpty()) data.damaged << st.problem;
+    }
+    return data;
+}
+
+UserData loadUserDataLegacy(const QString &username, const QString &dir)
+{
+    UserData data;
+    const QString &u = username;
+
+    QFile pf(userFilePath(dir, "profile_", u));
+    if (pf.open(QIODevice::ReadOnly)) {
+        auto p = QTextStream(&pf).readLine().split("|");
+        if (p.size() >= 5) { data.profile.gender = p[0]; data.profile.weight = p[1].toDouble(); data.profile.targetBodyweight = p[2].toDouble(); data.profile.height = p[3].toDouble(); data.profile.age = p[4].toInt(); data.hasProfile = true; }
+        pf.close();
+    }
+
+    QFile cf(userFilePath(dir, "cardio_", u));
+    if (cf.open(QIODevice::ReadOnly)) {
+        QTextStream in(&cf);
+        while (!in.atEnd()) {
+            auto p = in.readLine().split("|");
+            if (p.size() >= 6) {
+                CardioWorkout w;
+                w.date = p[0]; w.type = p[1]; w.duration = p[2].toInt(); w.distance = p[3].toDouble(); w.calories = p[4].toDouble(); w.avgSpeed = p[5].toDouble();
+                data.cardio.push_back(w);
+            }
+        }
+        cf.close();
+    }
+
+    QFile sf(userFilePath(dir, "strength_", u));
+    if (sf.open(QIODevice::ReadOnly)) {
+        QTextStream in(&sf);
+        while (!in.atEnd()) {
+            auto p = in.readLine().split("|");
+            if (p.size() >= 3) {
+                StrengthWorkout w; w.date = p[0]; w.calories = p[1].toDouble();
+                for (const QString &es : p[2].split(";")) {
+                    auto ep = es.split(":");
+                    if (ep.size() >= 2) {
+                        Exercise ex; ex.name = ep[0];
+                        for (const QString &ss : ep[1].split(",")) {
+                            auto sp = ss.split("x");
+                            if (sp.size() >= 2) { ExerciseSet s; s.reps = sp[0].toInt(); s.weight = sp[1].toDouble(); ex.sets.push_back(s); }
+                        }
+                        w.exercises.push_back(ex);
+                    }
+                }
+                w.updateTotals();
+                data.strength.push_back(w);
+            }
+        }
+        sf.close();
+    }
+
+    QFile wf(userFilePath(dir, "weight_", u));
+    if (wf.open(QIODevice::ReadOnly)) {
+        QTextStream in(&wf);
+        while (!in.atEnd()) {
+            auto p = in.readLine().split("|");
+            if (p.size() >= 2) { BodyweightLog b; b.date = p[0]; b.weight = p[1].toDouble(); data.weightLogs.push_back(b); }
+        }
+        wf.close();
+    }
+
+    QFile gf(userFilePath(dir, "goals_", u));
+    if (gf.open(QIODevice::ReadOnly)) {
+        QTextStream in(&gf);
+        while (!in.atEnd()) {
+            auto p = in.readLine().split("|");
+            if (p.size() >= 6) {
+                Goal g; g.name = p[0]; g.type = p[1]; g.target = p[2].toDouble(); g.progress = p[3].toDouble();
+                g.targetTime = p[4].toInt(); g.progressTime = p[5].toInt();
+                if (p.size() >= 10) { g.exerciseName = p[6]; g.exWeight = p[7].toDouble(); g.exSets = p[8].toInt(); g.exReps = p[9].toInt(); }
+                data.goals.push_back(g);
+            }
+        }
+        gf.close();
+    }
+    return data;
+}
+
+} // namespace DatParser
@@ -0,0 +1,35 @@
+#ifndef DATPARSER_H
+#define DATPARSER_H
+
+// FitTrack Pro - allocation-light reader for the pipe-delimited .dat files
+// Each file is mapped (or read) into one buffer and tokenized in place with QByteArrayView;
+// only the final record strings are materialized.
+#include <QByteArrayView>
+#include <QString>
+#include "models.h"
+
+namespace DatParser {
+
+QString userFilePath(const QString &dir, const QString &prefix, const QString &username);
+
+// buffer parsers (one record per line, malformed lines skipped like the QTextStream path)
+bool parseProfile(QByteArrayView buf, UserProfile &out);
+std::vector<CardioWorkout> parseCardio(QByteArrayView buf);
+std::vector<StrengthWorkout> parseStrength(QByteArrayView buf);
+std::vector<BodyweightLog> parseWeights(QByteArrayView buf);
+std::vector<Goal> parseGoals(QByteArrayView buf);
+
+// users.dat in `dir` (current directory when empty)
+std::vector<UserAccount> loadUserIndex(const QString &dir = QString());
+
+// Loads all five per-user files; with concurrent=true each file is parsed on the global thread pool.
+// Encrypted files are opened with `key` (see securestore.h); without it they load empty and set `locked`.
+UserData loadUserData(const QString &username, const QString &dir = QString(), bool concurrent = true,
+                      const QByteArray &key = QByteArray());
+
+// Reference implementation: the original QTextStream::readLine + split loader (kept for benchmarking)
+UserData loadUserDataLegacy(const QString &username, const QString &dir = QString());
+
+} // namespace DatParser
+
+#endif // DATPARSER_H
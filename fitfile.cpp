@@ -0,0 +1,327 @@
+// fitfile.cpp
+#include "fitfile.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+constexpr double SemicircleToDeg = 180.0 / 2147483648.0;
+constexpr int LocalTypes = 16;
+
+enum Global : uint16_t { MsgSession = 18, MsgLap = 19, MsgRecord = 20 };
+
+// Fields we read, by message; a definition maps each to where it sits in the data message
+enum Slot {
+    Timestamp,
+    // record
+    Lat, Lon, Altitude, EnhancedAltitude, HeartRate, Cadence, Distance, Speed, EnhancedSpeed,
+    // session / lap
+    StartTime, Sport, TotalElapsed, TotalTimer, TotalDistance, TotalAscent, TotalCalories, AvgHeartRate, MaxHeartRate,
+    SlotCount
+};
+
+int slotOf(uint16_t global, uint8_t field)
+{
+    if (field == 253) return Timestamp;
+    switch (global) {
+    case MsgRecord:
+        switch (field) {
+        case 0: return Lat; case 1: return Lon; case 2: return Altitude; case 3: return HeartRate;
+        case 4: return Cadence; case 5: return Distance; case 6: return Speed;
+        case 73: return EnhancedSpeed; case 78: return EnhancedAltitude;
+        }
+        break;
+    case MsgSession:
+        switch (field) {
+        case 2: return StartTime; case 5: return Sport; case 7: return TotalElapsed; case 8: return TotalTimer;
+        case 9: return TotalDistance; case 11: return TotalCalories; case 16: return AvgHeartRate;
+        case 17: return MaxHeartRate; case 22: return TotalAscent;
+        }
+        break;
+    case MsgLap:
+        switch (field) {
+        case 2: return StartTime; case 7: return TotalElapsed; case 8: return TotalTimer; case 9: return TotalDistance;
+        }
+        break;
+    }
+    return -1;
+}
+
+struct FieldRef {
+    uint16_t offset = 0;
+    uint8_t size = 0; // 0: not in this message
+    uint8_t baseType = 0;
+};
+
+struct Definition {
+    bool defined = false;
+    bool bigEndian = false;
+    uint16_t global = 0;
+    uint32_t length = 0; // data message bytes after the header, developer fields included
+    FieldRef slots[SlotCount];
+};
+
+// Size of one value of each base type (low five bits of the base type byte)
+constexpr uint8_t BaseSize[17] = {1, 1, 1, 2, 2, 4, 4, 1, 4, 8, 1, 2, 4, 1, 8, 8, 8};
+
+// The field's first value as a number; false for the type's "invalid" marker
+inline bool readValue(const uint8_t *msg, const FieldRef &f, bool bigEndian, double *out)
+{
+    const uint8_t type = f.baseType & 0x1f;
+    if (type > 16 || type == 7) return false; // strings are never wanted
+    const uint8_t n = BaseSize[type];
+    if (f.size < n) return false;
+    const uint8_t *p = msg + f.offset;
+    uint64_t u;
+    switch (n) {
+    case 1: u = p[0]; break;
+    case 2: u = bigEndian ? uint64_t(p[0]) << 8 | p[1] : uint64_t(p[1]) << 8 | p[0]; break;
+    case 4: u = bigEndian ? uint64_t(p[0]) << 24 | uint64_t(p[1]) << 16 | uint64_t(p[2]) << 8 | p[3]
+                          : uint64_t(p[3]) << 24 | uint64_t(p[2]) << 16 | uint64_t(p[1]) << 8 | p[0]; break;
+    default:
+        u = 0;
+        for (uint8_t i = 0; i < 8; ++i) u |= uint64_t(p[bigEndian ? 7 - i : i]) << (8 * i);
+    }
+    const uint64_t all = n == 8 ? ~uint64_t(0) : (uint64_t(1) << (8 * n)) - 1;
+    switch (type) {
+    case 0x01: case 0x03: case 0x05: case 0x0e: { // sint8/16/32/64: invalid is the largest positive value
+        if (u == all >> 1) return false;
+        const int shift = 64 - 8 * n;
+        *out = double(int64_t(u << shift) >> shift);
+        return true;
+    }
+    case 0x08: { float f32; uint32_t b = uint32_t(u); std::memcpy(&f32, &b, 4); if (b == 0xffffffffu) return false; *out = f32; return true; }
+    case 0x09: { double f64; std::memcpy(&f64, &u, 8); if (u == all) return false; *out = f64; return true; }
+    case 0x0a: case 0x0b: case 0x0c: case 0x10: // uint8z/16z/32z/64z: invalid is zero
+        if (u == 0) return false;
+        *out = double(u);
+        return true;
+    default: // enum, uint8/16/32/64, byte: invalid is all ones
+        if (u == all) return false;
+        *out = double(u);
+        return true;
+    }
+}
+
+constexpr uint16_t CrcPoly = 0xa001; // CRC-16/ARC, reflected
+
+struct CrcTables {
+    uint16_t t[8][256];
+    CrcTables()
+    {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (CrcPoly & (0u - (c & 1)));
+            t[0][i] = uint16_t(c);
+        }
+        for (uint32_t i = 0; i < 256; ++i)
+            for (int s = 1; s < 8; ++s) t[s][i] = uint16_t((t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xff]);
+    }
+};
+
+const CrcTables &crcTables()
+{
+    static const CrcTables tab;
+    return tab;
+}
+
+class Decoder {
+public:
+    explicit Decoder(Fit::Activity &out) : out(out) {}
+
+    // One FIT file (header, messages, CRC) starting at p; *used gets its length when it decoded cleanly
+    Fit::Status file(const uint8_t *p, size_t size, size_t *used) {
+        if (size < 12) return Fit::Status::NotFit;
+        const uint8_t headerSize = p[0];
+        if (headerSize < 12 || headerSize > size || std::memcmp(p + 8, ".FIT", 4) != 0) return Fit::Status::NotFit;
+        const uint32_t dataSize = uint32_t(p[4]) | uint32_t(p[5]) << 8 | uint32_t(p[6]) << 16 | uint32_t(p[7]) << 24;
+        if (headerSize >= 14 && (p[12] | p[13] << 8) != 0 && Fit::crc16(p, 12) != uint16_t(p[12] | p[13] << 8)) return Fit::Status::BadCrc;
+
+        const bool complete = size_t(headerSize) + dataSize + 2 <= size;
+        const size_t end = complete ? headerSize + dataSize : size; // a watch that died mid-write: read what is there
+        reserve(end - headerSize);
+        for (Definition &d : defs) d = Definition();
+        size_t pos = headerSize;
+        while (pos < end) {
+            const uint8_t h = p[pos++];
+            if (h & 0x80) { // compressed timestamp header: data message with a 5-bit time offset
+                const Definition &d = defs[(h >> 5) & 3];
+                if (!d.defined || pos + d.length > end) return stop(complete);
+                const uint32_t offset = h & 0x1f;
+                lastTimestamp = (lastTimestamp & ~0x1fu) + offset + (offset < (lastTimestamp & 0x1f) ? 0x20 : 0);
+                message(d, p + pos, true);
+                pos += d.length;
+            } else if (h & 0x40) { // definition
+                if (pos + 5 > end) return stop(complete);
+                Definition &d = defs[h & 0x0f];
+                d = Definition();
+                d.bigEndian = p[pos + 1] == 1;
+                d.global = d.bigEndian ? uint16_t(p[pos + 2] << 8 | p[pos + 3]) : uint16_t(p[pos + 3] << 8 | p[pos + 2]);
+                const uint8_t fields = p[pos + 4];
+                pos += 5;
+                if (pos + 3u * fields > end) return stop(complete);
+                for (uint8_t i = 0; i < fields; ++i, pos += 3) {
+                    const int slot = slotOf(d.global, p[pos]);
+                    if (slot >= 0) d.slots[slot] = {uint16_t(d.length), p[pos + 1], p[pos + 2]};
+                    d.length += p[pos + 1];
+                }
+                if (h & 0x20) { // developer fields: only their sizes matter
+                    if (pos >= end) return stop(complete);
+                    const uint8_t devFields = p[pos++];
+                    if (pos + 3u * devFields > end) return stop(complete);
+                    for (uint8_t i = 0; i < devFields; ++i, pos += 3) d.length += p[pos + 1];
+                }
+                d.defined = true;
+            } else { // data
+                const Definition &d = defs[h & 0x0f];
+                if (!d.defined) return Fit::Status::BadRecord;
+                if (pos + d.length > end) return stop(complete);
+                message(d, p + pos, false);
+                pos += d.length;
+            }
+        }
+        if (!complete) return Fit::Status::Truncated;
+        if (Fit::crc16(p, end + 2) != 0) return Fit::Status::BadCrc; // the trailing CRC makes the total zero
+        *used = end + 2;
+        return Fit::Status::Ok;
+    }
+
+private:
+    Fit::Status stop(bool complete) { return complete ? Fit::Status::BadRecord : Fit::Status::Truncated; }
+
+    // A record message is rarely under 16 bytes, so this is one allocation per array for the file;
+    // the pages past what gets used are never touched
+    void reserve(size_t bytes) {
+        Fit::Records &r = out.records;
+        const size_t n = r.size() + bytes / 16;
+        for (auto *v : {&r.lat, &r.lon, &r.altitude, &r.heartRate, &r.cadence, &r.distance, &r.speed}) v->reserve(n);
+        r.time.reserve(n);
+    }
+
+    double get(const Definition &d, const uint8_t *msg, Slot s, double scale = 1, double offset = 0) const {
+        double v;
+        if (!d.slots[s].size || !readValue(msg, d.slots[s], d.bigEndian, &v)) return NaN;
+        return v / scale - offset;
+    }
+
+    // Sessions and laps are written when they end: without a start_time, back off by the elapsed time
+    int64_t startOf(const Definition &d, const uint8_t *msg, int64_t time, double elapsed) const {
+        const double start = get(d, msg, StartTime);
+        if (!std::isnan(start)) return int64_t(start) + Fit::EpochOffset;
+        return std::isnan(elapsed) ? time : time - int64_t(elapsed);
+    }
+
+    void message(const Definition &d, const uint8_t *msg, bool compressedTime) {
+        if (!compressedTime) {
+            const double ts = get(d, msg, Timestamp);
+            if (!std::isnan(ts)) lastTimestamp = uint32_t(ts);
+        }
+        const int64_t time = int64_t(lastTimestamp) + Fit::EpochOffset;
+        switch (d.global) {
+        case MsgRecord: {
+            Fit::Records &r = out.records;
+            r.time.push_back(time);
+            r.lat.push_back(get(d, msg, Lat) * SemicircleToDeg);
+            r.lon.push_back(get(d, msg, Lon) * SemicircleToDeg);
+            double alt = get(d, msg, EnhancedAltitude, 5, 500);
+            if (std::isnan(alt)) alt = get(d, msg, Altitude, 5, 500);
+            r.altitude.push_back(alt);
+            r.heartRate.push_back(get(d, msg, HeartRate));
+            r.cadence.push_back(get(d, msg, Cadence));
+            r.distance.push_back(get(d, msg, Distance, 100));
+            double speed = get(d, msg, EnhancedSpeed, 1000);
+            if (std::isnan(speed)) speed = get(d, msg, Speed, 1000);
+            r.speed.push_back(speed);
+            break;
+        }
+        case MsgSession: {
+            Fit::Session s;
+            s.elapsed = get(d, msg, TotalElapsed, 1000);
+            s.start = startOf(d, msg, time, s.elapsed);
+            const double sport = get(d, msg, Sport);
+            s.sport = std::isnan(sport) ? -1 : int(sport);
+            s.timer = get(d, msg, TotalTimer, 1000);
+            s.distance = get(d, msg, TotalDistance, 100);
+            s.ascent = get(d, msg, TotalAscent);
+            s.calories = get(d, msg, TotalCalories);
+            const double avg = get(d, msg, AvgHeartRate), max = get(d, msg, MaxHeartRate);
+            s.avgHeartRate = std::isnan(avg) ? 0 : int(avg);
+            s.maxHeartRate = std::isnan(max) ? 0 : int(max);
+            out.sessions.push_back(s);
+            break;
+        }
+        case MsgLap: {
+            Fit::Lap l;
+            l.elapsed = get(d, msg, TotalElapsed, 1000);
+            l.start = startOf(d, msg, time, l.elapsed);
+            l.timer = get(d, msg, TotalTimer, 1000);
+            l.distance = get(d, msg, TotalDistance, 100);
+            out.laps.push_back(l);
+            break;
+        }
+        }
+    }
+
+    Fit::Activity &out;
+    Definition defs[LocalTypes];
+    uint32_t lastTimestamp = 0;
+};
+
+} // namespace
+
+namespace Fit {
+
+Session::Session() : elapsed(NaN), timer(NaN), distance(NaN), ascent(NaN), calories(NaN) {}
+Lap::Lap() : elapsed(NaN), timer(NaN), distance(NaN) {}
+
+const char *statusText(Status s)
+{
+    switch (s) {
+    case Status::Ok: return "ok";
+    case Status::Truncated: return "file is truncated";
+    case Status::NotFit: return "not a FIT file";
+    case Status::BadCrc: return "CRC mismatch";
+    case Status::BadRecord: return "corrupt record";
+    }
+    return "?";
+}
+
+Status decode(const uint8_t *data, size_t size, Activity &out)
+{
+    out = Activity();
+    Decoder dec(out);
+    size_t pos = 0;
+    Status status = Status::NotFit;
+    // chained files: a new header may follow each file's CRC
+    while (pos < size) {
+        size_t used = 0;
+        const Status s = dec.file(data + pos, size - pos, &used);
+        if (s != Status::Ok) return pos && s == Status::NotFit ? Status::Ok : s; // trailing padding after a complete file
+        status = Status::Ok;
+        pos += used;
+    }
+    return status;
+}
+
+uint16_t crc16(const uint8_t *data, size_t size, uint16_t crc)
+{
+    const CrcTables &tab = crcTables();
+    uint32_t c = crc;
+    // slicing-by-8 as in Crc32c::computeSoftware; the CRC share of a decode would otherwise be half of it
+    while (size >= 8) {
+        uint32_t lo, hi;
+        std::memcpy(&lo, data, 4);
+        std::memcpy(&hi, data + 4, 4);
+        lo ^= c;
+        c = tab.t[7][lo & 0xff] ^ tab.t[6][(lo >> 8) & 0xff] ^ tab.t[5][(lo >> 16) & 0xff] ^ tab.t[4][lo >> 24]
+            ^ tab.t[3][hi & 0xff] ^ tab.t[2][(hi >> 8) & 0xff] ^ tab.t[1][(hi >> 16) & 0xff] ^ tab.t[0][hi >> 24];
+        data += 8; size -= 8;
+    }
+    while (size--) c = (c >> 8) ^ tab.t[0][(c ^ *data++) & 0xff];
+    return uint16_t(c);
+}
+
+} // namespace Fit
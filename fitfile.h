@@ -0,0 +1,57 @@
+#ifndef FITFILE_H
+#define FITFILE_H
+
+// FitTrack Pro - Garmin FIT activity file decoder
+// Works on the file's bytes in place (the caller maps it): definition messages are turned into
+// per-local-type extraction plans (offset, size and base type of each wanted field), and data
+// messages are read through those plans, so a record costs a few loads and no allocation beyond
+// the output arrays, which are reserved up front. Only session (18), lap (19) and record (20)
+// messages are extracted; everything else, developer fields included, is skipped by length.
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Fit {
+
+constexpr int64_t EpochOffset = 631065600; // FIT timestamps count from 1989-12-31T00:00:00Z
+
+// Totals as the device computed them; NaN / 0 where the file leaves them out. Times in Unix seconds.
+struct Session {
+    int64_t start = 0;
+    int sport = -1; // FIT sport enum: 1 running, 2 cycling, 5 swimming, 11 walking, 17 hiking, ...
+    double elapsed, timer, distance, ascent, calories; // s, s, m, m, kcal
+    int avgHeartRate = 0, maxHeartRate = 0;
+    Session();
+};
+
+struct Lap {
+    int64_t start = 0;
+    double elapsed, timer, distance;
+    Lap();
+};
+
+// One entry per record message; NaN where a field is absent or invalid
+struct Records {
+    std::vector<int64_t> time; // Unix seconds
+    std::vector<double> lat, lon; // degrees
+    std::vector<double> altitude, heartRate, cadence, distance, speed; // m, bpm, rpm, m (cumulative), m/s
+    size_t size() const { return time.size(); }
+};
+
+struct Activity {
+    std::vector<Session> sessions;
+    std::vector<Lap> laps;
+    Records records;
+};
+
+enum class Status { Ok, Truncated, NotFit, BadCrc, BadRecord };
+const char *statusText(Status s);
+
+// Decodes every FIT file chained in data[0, size). Truncated still fills `out` with what was read.
+Status decode(const uint8_t *data, size_t size, Activity &out);
+
+uint16_t crc16(const uint8_t *data, size_t size, uint16_t crc = 0);
+
+} // namespace Fit
+
+#endif // FITFILE_H
@@ -0,0 +1,165 @@
+// geo.cpp
+#include "geo.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FT_GEO_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define FT_TARGET_AVX2
+#else
+#define FT_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+constexpr double Pi = 3.14159265358979323846;
+constexpr double DegToRad = Pi / 180.0;
+
+void segmentsScalar(const double *lat, const double *lon, size_t n, double *out)
+{
+    double cosPrev = std::cos(lat[0] * DegToRad);
+    for (size_t i = 0; i + 1 < n; ++i) {
+        const double cosNext = std::cos(lat[i + 1] * DegToRad);
+        const double sLat = std::sin((lat[i + 1] - lat[i]) * DegToRad / 2);
+        const double sLon = std::sin((lon[i + 1] - lon[i]) * DegToRad / 2);
+        const double a = sLat * sLat + cosPrev * cosNext * sLon * sLon;
+        out[i] = 2 * Geo::EarthRadiusM * std::asin(std::sqrt(std::min(a, 1.0)));
+        cosPrev = cosNext;
+    }
+}
+
+#ifdef FT_GEO_X86
+
+// Taylor series, odd terms up to x^21: truncation below 2e-18 for |x| <= pi/2, so rounding dominates
+FT_TARGET_AVX2 inline __m256d sinAvx2(__m256d x)
+{
+    static constexpr double C[] = {1.0 / 51090942171709440000.0, -1.0 / 121645100408832000.0, 1.0 / 355687428096000.0,
+                                   -1.0 / 1307674368000.0, 1.0 / 6227020800.0, -1.0 / 39916800.0, 1.0 / 362880.0, -1.0 / 5040.0, 1.0 / 120.0, -1.0 / 6.0};
+    const __m256d x2 = _mm256_mul_pd(x, x);
+    __m256d p = _mm256_set1_pd(C[0]);
+    for (size_t i = 1; i < sizeof(C) / sizeof(C[0]); ++i) p = _mm256_add_pd(_mm256_mul_pd(p, x2), _mm256_set1_pd(C[i]));
+    return _mm256_add_pd(x, _mm256_mul_pd(_mm256_mul_pd(p, x2), x));
+}
+
+// cos x = 1 - 2 sin^2(x/2), for latitudes (|x| <= pi/2)
+FT_TARGET_AVX2 inline __m256d cosAvx2(__m256d x)
+{
+    const __m256d s = sinAvx2(_mm256_mul_pd(x, _mm256_set1_pd(0.5)));
+    return _mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(_mm256_set1_pd(2.0), _mm256_mul_pd(s, s)));
+}
+
+// asin series up to x^13, exact to rounding for x < AsinSeriesLimit (segments under ~600 km)
+constexpr double AsinSeriesLimit = 0.05;
+FT_TARGET_AVX2 inline __m256d asinSmallAvx2(__m256d x)
+{
+    static constexpr double C[] = {231.0 / 13312.0, 63.0 / 2816.0, 35.0 / 1152.0, 5.0 / 112.0, 3.0 / 40.0, 1.0 / 6.0};
+    const __m256d x2 = _mm256_mul_pd(x, x);
+    __m256d p = _mm256_set1_pd(C[0]);
+    for (size_t i = 1; i < sizeof(C) / sizeof(C[0]); ++i) p = _mm256_add_pd(_mm256_mul_pd(p, x2), _mm256_set1_pd(C[i]));
+    return _mm256_add_pd(x, _mm256_mul_pd(_mm256_mul_pd(p, x2), x));
+}
+
+FT_TARGET_AVX2 void segmentsAvx2(const double *lat, const double *lon, size_t n, double *out)
+{
+    const __m256d toRad = _mm256_set1_pd(DegToRad), halfRad = _mm256_set1_pd(DegToRad / 2);
+    const __m256d turn = _mm256_set1_pd(360.0), invTurn = _mm256_set1_pd(1.0 / 360.0);
+    const __m256d one = _mm256_set1_pd(1.0), diameter = _mm256_set1_pd(2 * Geo::EarthRadiusM);
+    size_t i = 0;
+    for (; i + 4 < n; i += 4) {
+        const __m256d lat0 = _mm256_loadu_pd(lat + i), lat1 = _mm256_loadu_pd(lat + i + 1);
+        const __m256d lon0 = _mm256_loadu_pd(lon + i), lon1 = _mm256_loadu_pd(lon + i + 1);
+        __m256d dLon = _mm256_sub_pd(lon1, lon0);
+        // across the antimeridian: the short way round, so |dLon / 2| stays within the sine's range
+        dLon = _mm256_sub_pd(dLon, _mm256_mul_pd(turn, _mm256_round_pd(_mm256_mul_pd(dLon, invTurn), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)));
+        const __m256d sLat = sinAvx2(_mm256_mul_pd(_mm256_sub_pd(lat1, lat0), halfRad));
+        const __m256d sLon = sinAvx2(_mm256_mul_pd(dLon, halfRad));
+        const __m256d cosProduct = _mm256_mul_pd(cosAvx2(_mm256_mul_pd(lat0, toRad)), cosAvx2(_mm256_mul_pd(lat1, toRad)));
+        // min returns its second operand for NaN: a missing position gives NaN, as in the scalar path
+        const __m256d a = _mm256_min_pd(one, _mm256_add_pd(_mm256_mul_pd(sLat, sLat), _mm256_mul_pd(cosProduct, _mm256_mul_pd(sLon, sLon))));
+        const __m256d h = _mm256_sqrt_pd(a);
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(diameter, asinSmallAvx2(h)));
+        // GPS gaps that long are rare: recompute those lanes with libm
+        if (int far = _mm256_movemask_pd(_mm256_cmp_pd(h, _mm256_set1_pd(AsinSeriesLimit), _CMP_GE_OQ))) {
+            alignas(32) double hs[4];
+            _mm256_store_pd(hs, h);
+            for (int l = 0; l < 4; ++l)
+                if (far & (1 << l)) out[i + size_t(l)] = 2 * Geo::EarthRadiusM * std::asin(hs[l]);
+        }
+    }
+    if (i + 1 < n) segmentsScalar(lat + i, lon + i, n - i, out + i);
+}
+
+bool cpuHasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 6) != 6) return false; // OS saves the YMM registers
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // FT_GEO_X86
+
+} // namespace
+
+namespace Geo {
+
+bool kernelSupported(Kernel k)
+{
+    switch (k) {
+    case Kernel::Scalar: return true;
+#ifdef FT_GEO_X86
+    case Kernel::Avx2: { static const bool avx2 = cpuHasAvx2(); return avx2; }
+#else
+    default: return false;
+#endif
+    }
+    return false;
+}
+
+Kernel bestKernel()
+{
+    static const Kernel best = kernelSupported(Kernel::Avx2) ? Kernel::Avx2 : Kernel::Scalar;
+    return best;
+}
+
+const char *kernelName(Kernel k)
+{
+    switch (k) {
+    case Kernel::Scalar: return "scalar";
+    case Kernel::Avx2: return "avx2";
+    }
+    return "?";
+}
+
+double haversine(double lat1, double lon1, double lat2, double lon2)
+{
+    const double lat[2] = {lat1, lat2}, lon[2] = {lon1, lon2};
+    double d = 0;
+    segmentsScalar(lat, lon, 2, &d);
+    return d;
+}
+
+void segmentDistances(const double *lat, const double *lon, size_t n, double *out, Kernel k)
+{
+    if (n < 2) return;
+    if (!kernelSupported(k)) k = Kernel::Scalar;
+#ifdef FT_GEO_X86
+    if (k == Kernel::Avx2) { segmentsAvx2(lat, lon, n, out); return; }
+#endif
+    segmentsScalar(lat, lon, n, out);
+}
+
+} // namespace Geo
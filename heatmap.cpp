@@ -0,0 +1,205 @@
+// heatmap.cpp
+#include "heatmap.h"
+#include "tracing.h"
+
+#include <QDate>
+#include <QHelpEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QToolTip>
+#include <algorithm>
+
+namespace {
+
+const QColor Empty(16, 38, 56);
+const QColor Levels[4] = {QColor(90, 45, 20), QColor(150, 68, 24), QColor(215, 92, 34), QColor(255, 138, 61)};
+
+int weekday(const QDate &d) { return d.dayOfWeek() - 1; } // Monday = 0
+
+// Week column of a day inside its year band
+int columnOf(const QDate &d)
+{
+    const QDate jan1(d.year(), 1, 1);
+    return (int(jan1.daysTo(d)) + weekday(jan1)) / 7;
+}
+
+} // namespace
+
+ActivityHeatmap::ActivityHeatmap(QWidget *parent) : QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+}
+
+void ActivityHeatmap::setData(qint64 firstDay, std::vector<double> v, qint64 lastDay, const QString &unit)
+{
+    FT_TRACE_SCOPE("ActivityHeatmap::setData");
+    first = firstDay;
+    values = std::move(v);
+    units = unit;
+    lastYear = QDate::fromJulianDay(std::max(lastDay, first + qint64(values.size()) - 1)).year();
+    firstYear = values.empty() ? lastYear : QDate::fromJulianDay(first).year();
+    rescale();
+    tiles.clear();
+    setMinimumSize(sizeHint()); // lets an enclosing QScrollArea scroll the full range
+    update();
+}
+
+void ActivityHeatmap::rescale()
+{
+    std::vector<double> active;
+    for (double v : values) if (v > 0) active.push_back(v);
+    top = 0;
+    std::fill(cuts, cuts + 3, 0.0);
+    if (active.empty()) return;
+    std::sort(active.begin(), active.end());
+    for (int q = 0; q < 3; ++q) cuts[q] = active[active.size() * size_t(q + 1) / 4];
+    top = active.back();
+}
+
+int ActivityHeatmap::level(double v) const
+{
+    if (v <= 0) return 0;
+    int l = 1;
+    while (l < 4 && v > cuts[l - 1]) ++l;
+    return l;
+}
+
+double ActivityHeatmap::valueAt(qint64 day) const
+{
+    const qint64 i = day - first;
+    return (i < 0 || i >= (qint64)values.size()) ? 0.0 : values[size_t(i)];
+}
+
+void ActivityHeatmap::setDay(qint64 day, double value)
+{
+    if (values.empty()) { setData(day, {value}, day, units); return; }
+    if (day < first) {
+        values.insert(values.begin(), size_t(first - day), 0.0);
+        first = day;
+    } else if (day - first >= (qint64)values.size()) {
+        values.resize(size_t(day - first + 1), 0.0);
+    }
+    values[size_t(day - first)] = value > 1e-9 ? value : 0.0; // deletes subtract, so absorb rounding
+
+    const int year = QDate::fromJulianDay(day).year();
+    if (year < firstYear || year > lastYear) {
+        // a new year band shifts every tile
+        setData(first, std::move(values), QDate(lastYear, 12, 31).toJulianDay(), units);
+        return;
+    }
+    // any change can move the quartiles or the top (a deleted best day lowers them); re-deriving them is
+    // one sort of a few thousand days, far cheaper than repainting every tile when nothing moved
+    const double oldCuts[3] = {cuts[0], cuts[1], cuts[2]}, oldTop = top;
+    rescale();
+    if (!std::equal(cuts, cuts + 3, oldCuts) || top != oldTop) {
+        // the band edges moved: every tile's colours may change
+        tiles.clear();
+        update();
+        return;
+    }
+    const QDate d = QDate::fromJulianDay(day);
+    tiles.remove(monthKey(d.year(), d.month()));
+    update(tileRect(d.year(), d.month()));
+}
+
+QSize ActivityHeatmap::sizeHint() const
+{
+    const int bands = values.empty() ? 1 : lastYear - firstYear + 1;
+    return QSize(Gutter + 54 * Pitch + 8, bands * BandHeight);
+}
+
+QRect ActivityHeatmap::tileRect(int year, int month) const
+{
+    const QDate start(year, month, 1);
+    const int c0 = columnOf(start), c1 = columnOf(start.addDays(start.daysInMonth() - 1));
+    const int band = lastYear - year;
+    return QRect(Gutter + c0 * Pitch, band * BandHeight, (c1 - c0 + 1) * Pitch, Header + 7 * Pitch);
+}
+
+QPixmap ActivityHeatmap::renderTile(int year, int month) const
+{
+    FT_TRACE_SCOPE("ActivityHeatmap::renderTile");
+    const QRect r = tileRect(year, month);
+    const qreal dpr = devicePixelRatioF();
+    QPixmap pm(r.size() * dpr);
+    pm.setDevicePixelRatio(dpr);
+    pm.fill(Qt::transparent); // the first and last week columns are shared with the neighbouring months
+
+    QPainter p(&pm);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setPen(QColor("#b8c8d8"));
+    p.drawText(QRect(0, 0, r.width(), Header - 2), Qt::AlignLeft | Qt::AlignBottom, QDate(year, month, 1).toString("MMM"));
+
+    p.setPen(Qt::NoPen);
+    const QDate start(year, month, 1);
+    const int c0 = columnOf(start);
+    for (int i = 0; i < start.daysInMonth(); ++i) {
+        const QDate d = start.addDays(i);
+        const int l = level(valueAt(d.toJulianDay()));
+        p.setBrush(l ? Levels[l - 1] : Empty);
+        p.drawRoundedRect(QRectF((columnOf(d) - c0) * Pitch, Header + weekday(d) * Pitch, Cell, Cell), 2, 2);
+    }
+    return pm;
+}
+
+void ActivityHeatmap::paintEvent(QPaintEvent *ev)
+{
+    FT_TRACE_SCOPE("ActivityHeatmap::paint");
+    QPainter p(this);
+    const QRect exposed = ev->rect();
+    p.fillRect(exposed, QColor(5, 18, 27));
+    if (values.empty()) {
+        p.setPen(QColor("#b8c8d8"));
+        p.drawText(rect(), Qt::AlignCenter, "Log a workout to start your calendar");
+        return;
+    }
+
+    // only the year bands and months that intersect the exposed rect
+    const int bandLo = std::max(0, exposed.top() / BandHeight);
+    const int bandHi = std::min(lastYear - firstYear, exposed.bottom() / BandHeight);
+    for (int band = bandLo; band <= bandHi; ++band) {
+        const int year = lastYear - band;
+        const int y = band * BandHeight;
+        p.setPen(QColor("#ffffff"));
+        p.drawText(QRect(0, y, Gutter, Header), Qt::AlignLeft | Qt::AlignBottom, QString::number(year));
+        p.setPen(QColor("#b8c8d8"));
+        for (int row : {0, 2, 4})
+            p.drawText(QRect(0, y + Header + row * Pitch, Gutter - 4, Cell), Qt::AlignLeft | Qt::AlignVCenter,
+                       QDate(2024, 1, 1 + row).toString("ddd")); // 2024-01-01 is a Monday
+
+        for (int month = 1; month <= 12; ++month) {
+            const QRect r = tileRect(year, month);
+            if (!r.intersects(exposed)) continue;
+            auto it = tiles.find(monthKey(year, month));
+            if (it == tiles.end()) it = tiles.insert(monthKey(year, month), renderTile(year, month));
+            p.drawPixmap(r.topLeft(), *it);
+        }
+    }
+}
+
+qint64 ActivityHeatmap::dayAt(const QPoint &pos) const
+{
+    if (values.empty() || pos.x() < Gutter) return -1;
+    const int band = pos.y() / BandHeight, yIn = pos.y() % BandHeight - Header;
+    const int year = lastYear - band;
+    if (year < firstYear || yIn < 0 || yIn >= 7 * Pitch || yIn % Pitch >= Cell) return -1;
+    const int col = (pos.x() - Gutter) / Pitch, row = yIn / Pitch;
+    const QDate jan1(year, 1, 1);
+    const QDate d = jan1.addDays(col * 7 + row - weekday(jan1));
+    return d.year() == year ? d.toJulianDay() : -1;
+}
+
+bool ActivityHeatmap::event(QEvent *ev)
+{
+    if (ev->type() == QEvent::ToolTip) {
+        auto *he = static_cast<QHelpEvent *>(ev);
+        const qint64 day = dayAt(he->pos());
+        if (day < 0) { QToolTip::hideText(); ev->ignore(); return true; }
+        const double v = valueAt(day);
+        QToolTip::showText(he->globalPos(), QString("%1: %2").arg(QDate::fromJulianDay(day).toString("ddd yyyy-MM-dd"))
+                                                .arg(v > 0 ? QString("%1 %2").arg(v, 0, 'f', 1).arg(units) : QString("rest day")), this);
+        return true;
+    }
+    return QWidget::event(ev);
+}
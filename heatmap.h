@@ -0,0 +1,50 @@
+#ifndef HEATMAP_H
+#define HEATMAP_H
+
+// FitTrack Pro - year-at-a-glance activity heatmap (one band per year, newest first)
+// Each month is rendered once into a cached pixmap tile; paintEvent only blits the tiles that
+// intersect the exposed rect. Changing one day drops just its month's tile, unless the new value
+// moves the colour scale, which re-renders everything.
+#include <QHash>
+#include <QPixmap>
+#include <QString>
+#include <QWidget>
+#include <vector>
+
+class ActivityHeatmap : public QWidget {
+public:
+    explicit ActivityHeatmap(QWidget *parent = nullptr);
+
+    // values[i] belongs to julian day firstDay + i; the map runs through the year of lastDay
+    void setData(qint64 firstDay, std::vector<double> values, qint64 lastDay, const QString &unit);
+    void setDay(qint64 day, double value);
+    double valueAt(qint64 day) const;
+    bool isEmpty() const { return values.empty(); }
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *ev) override;
+    bool event(QEvent *ev) override;
+
+private:
+    static constexpr int Cell = 12, Pitch = 14, Header = 16, Gutter = 32;
+    static constexpr int BandHeight = Header + 7 * Pitch + 10;
+
+    int monthKey(int year, int month) const { return year * 12 + month - 1; }
+    QRect tileRect(int year, int month) const; // widget coordinates
+    QPixmap renderTile(int year, int month) const;
+    int level(double v) const;                 // 0 = rest day, 1..4 = quartile of the active days
+    void rescale();
+    qint64 dayAt(const QPoint &pos) const;     // -1 if no cell there
+
+    qint64 first = 0;
+    std::vector<double> values;
+    int firstYear = 0, lastYear = 0;
+    double cuts[3] = {0, 0, 0}; // quartile boundaries of the non-zero days
+    double top = 0;             // largest value the current scale was built for
+    QString units;
+    mutable QHash<int, QPixmap> tiles;
+};
+
+#endif // HEATMAP_H
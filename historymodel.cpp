@@ -0,0 +1,196 @@
+// historymodel.cpp
+#include "historymodel.h"
+#include "tracing.h"
+
+#include <algorithm>
+#include <numeric>
+
+void HistoryModel::setColumns(const QStringList &t, const QVector<KeyKind> &kinds)
+{
+    titles = t;
+    columns.assign(size_t(kinds.size()), ColumnKeys());
+    for (int i = 0; i < kinds.size(); ++i) columns[size_t(i)].kind = kinds[i];
+}
+
+int HistoryModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : (int)rows.size();
+}
+
+int HistoryModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : titles.size();
+}
+
+QVariant HistoryModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) return QVariant();
+    if (orientation == Qt::Horizontal) return titles.value(section);
+    return section + 1;
+}
+
+QVariant HistoryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole) return QVariant();
+    const int r = recordAt(index.row());
+    return r < 0 || r >= records() ? QVariant() : QVariant(display(r, index.column())); // formatted only for visible cells
+}
+
+void HistoryModel::pushKeys(int record)
+{
+    for (size_t c = 0; c < columns.size(); ++c) {
+        ColumnKeys &col = columns[c];
+        if (col.kind == KeyKind::Number) { col.number.push_back(numberKey(record, int(c))); continue; }
+        const QString key = textKey(record, int(c)).toLower();
+        auto it = col.ids.constFind(key);
+        if (it == col.ids.cend()) { it = col.ids.insert(key, col.strings.size()); col.strings << key; col.rankDirty = true; }
+        col.textId.push_back(*it);
+    }
+    days.push_back(dayOf(record));
+    search.push_back(searchText(record).toLower());
+}
+
+void HistoryModel::ensureRank(ColumnKeys &c)
+{
+    if (c.kind != KeyKind::Text || !c.rankDirty) return;
+    // only the distinct strings are compared; rows then sort on plain ints
+    std::vector<int> ids(size_t(c.strings.size()));
+    std::iota(ids.begin(), ids.end(), 0);
+    std::sort(ids.begin(), ids.end(), [&](int a, int b) { return c.strings[a] < c.strings[b]; });
+    c.rank.assign(ids.size(), 0);
+    for (size_t i = 0; i < ids.size(); ++i) c.rank[size_t(ids[i])] = int(i);
+    c.rankDirty = false;
+}
+
+double HistoryModel::sortKey(int record) const
+{
+    const ColumnKeys &c = columns[size_t(sortColumn)];
+    return c.kind == KeyKind::Number ? c.number[size_t(record)] : c.rank[size_t(c.textId[size_t(record)])];
+}
+
+bool HistoryModel::less(int a, int b) const
+{
+    if (sortColumn >= 0) {
+        const double ka = sortKey(a), kb = sortKey(b);
+        if (ka != kb) return sortOrder == Qt::AscendingOrder ? ka < kb : ka > kb;
+    }
+    // ties (and the unsorted view) keep insertion order
+    return sortOrder == Qt::AscendingOrder || sortColumn < 0 ? a < b : a > b;
+}
+
+void HistoryModel::resort()
+{
+    order.resize(days.size());
+    if (sortColumn < 0) { std::iota(order.begin(), order.end(), 0); return; }
+    ensureRank(columns[size_t(sortColumn)]);
+    // sort (key, record) pairs so the comparator touches one contiguous array
+    std::vector<std::pair<double, int>> keyed(days.size());
+    for (size_t i = 0; i < keyed.size(); ++i) keyed[i] = {sortKey(int(i)), int(i)};
+    if (sortOrder == Qt::AscendingOrder) std::sort(keyed.begin(), keyed.end());
+    else std::sort(keyed.begin(), keyed.end(), [](const auto &a, const auto &b) { return a > b; });
+    for (size_t i = 0; i < keyed.size(); ++i) order[i] = keyed[i].second;
+}
+
+bool HistoryModel::matches(int record) const
+{
+    const qint64 d = days[size_t(record)];
+    if (filter.from.isValid() && d < filter.from.toJulianDay()) return false;
+    if (filter.to.isValid() && d > filter.to.toJulianDay()) return false;
+    return filterText.isEmpty() || search[size_t(record)].contains(filterText);
+}
+
+void HistoryModel::refilter()
+{
+    rows.clear();
+    if (filter.isEmpty()) { rows = order; return; }
+    rows.reserve(order.size());
+    for (int r : order) if (matches(r)) rows.push_back(r);
+}
+
+void HistoryModel::reset()
+{
+    FT_TRACE_SCOPE("HistoryModel::reset");
+    beginResetModel();
+    for (ColumnKeys &c : columns) { c.number.clear(); c.textId.clear(); c.ids.clear(); c.strings.clear(); c.rankDirty = true; }
+    days.clear(); search.clear();
+    const int n = records();
+    for (int i = 0; i < n; ++i) pushKeys(i);
+    resort();
+    refilter();
+    endResetModel();
+}
+
+void HistoryModel::sort(int column, Qt::SortOrder o)
+{
+    FT_TRACE_SCOPE("HistoryModel::sort");
+    emit layoutAboutToBeChanged();
+    // views keep their current index and selection in persistent indexes: they must follow the record,
+    // not stay on a row number that now holds another one
+    const QModelIndexList before = persistentIndexList();
+    std::vector<int> held(size_t(before.size()));
+    for (int i = 0; i < before.size(); ++i) held[size_t(i)] = recordAt(before[i].row());
+    sortColumn = column >= 0 && column < (int)columns.size() ? column : -1;
+    sortOrder = o;
+    resort();
+    refilter();
+    std::vector<int> rowOf(order.size(), -1);
+    for (size_t r = 0; r < rows.size(); ++r) rowOf[size_t(rows[r])] = int(r);
+    QModelIndexList after;
+    after.reserve(before.size());
+    for (int i = 0; i < before.size(); ++i) {
+        const int rec = held[size_t(i)];
+        const int row = rec >= 0 && rec < (int)rowOf.size() ? rowOf[size_t(rec)] : -1;
+        after << (row >= 0 ? index(row, before[i].column()) : QModelIndex()); // hidden by the filter: dropped
+    }
+    changePersistentIndexList(before, after);
+    emit layoutChanged();
+}
+
+void HistoryModel::setFilter(const HistoryFilter &f)
+{
+    FT_TRACE_SCOPE("HistoryModel::setFilter");
+    beginResetModel();
+    filter = f;
+    filterText = f.text.trimmed().toLower();
+    refilter(); // `order` is already sorted, so filtering is one linear pass
+    endResetModel();
+}
+
+void HistoryModel::appended()
+{
+    const int record = records() - 1;
+    if (record != (int)order.size()) { reset(); return; } // out of step: fall back to a rebuild
+    pushKeys(record);
+    if (sortColumn >= 0) ensureRank(columns[size_t(sortColumn)]);
+    auto cmp = [this](int a, int b) { return less(a, b); };
+    order.insert(std::upper_bound(order.begin(), order.end(), record, cmp), record);
+    if (!matches(record)) return;
+    const auto pos = std::upper_bound(rows.begin(), rows.end(), record, cmp);
+    const int row = int(pos - rows.begin());
+    beginInsertRows(QModelIndex(), row, row);
+    rows.insert(pos, record);
+    endInsertRows();
+}
+
+void HistoryModel::remove(int record, const std::function<void()> &eraseRecord)
+{
+    if (record < 0 || record >= (int)order.size()) { eraseRecord(); reset(); return; } // out of step: rebuild
+    auto rowIt = std::find(rows.begin(), rows.end(), record);
+    const int row = rowIt == rows.end() ? -1 : int(rowIt - rows.begin());
+    if (row >= 0) beginRemoveRows(QModelIndex(), row, row);
+    eraseRecord();
+
+    for (ColumnKeys &c : columns) {
+        if (c.kind == KeyKind::Number) c.number.erase(c.number.begin() + record);
+        else c.textId.erase(c.textId.begin() + record); // the interned string stays; harmless
+    }
+    days.erase(days.begin() + record);
+    search.erase(search.begin() + record);
+    // later records moved down one slot in the vector
+    order.erase(std::find(order.begin(), order.end(), record));
+    for (int &r : order) if (r > record) --r;
+    if (row >= 0) rows.erase(rows.begin() + row);
+    for (int &r : rows) if (r > record) --r;
+
+    if (row >= 0) endRemoveRows();
+}
@@ -0,0 +1,122 @@
+#ifndef HISTORYMODEL_H
+#define HISTORYMODEL_H
+
+// FitTrack Pro - sortable, filterable table models over the history vectors
+// Sort keys are typed and computed once per record (numbers as double, text as an interned id that
+// is ranked at sort time). `order` holds every record in sort order and `rows` the filtered subset;
+// appends and deletes patch both in place instead of re-sorting.
+#include <QAbstractTableModel>
+#include <QDate>
+#include <QHash>
+#include <QStringList>
+#include <functional>
+#include <vector>
+#include "persistentvector.h"
+
+struct HistoryFilter {
+    QDate from, to;   // inclusive; invalid = open-ended
+    QString text;     // case-insensitive substring of the record's search text
+    bool isEmpty() const { return !from.isValid() && !to.isValid() && text.isEmpty(); }
+};
+
+class HistoryModel : public QAbstractTableModel {
+public:
+    enum class KeyKind { Number, Text };
+
+    explicit HistoryModel(QObject *parent = nullptr) : QAbstractTableModel(parent) {}
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    void reset();             // records replaced or edited in bulk: recompute every key
+    void appended();          // one record was pushed to the back of the vector
+    // Erases the record at this index through eraseRecord(), called between beginRemoveRows() and
+    // endRemoveRows() so no view reads the vector while rows and records are out of step
+    void remove(int record, const std::function<void()> &eraseRecord);
+    void setFilter(const HistoryFilter &f);
+
+    int recordAt(int row) const { return row >= 0 && row < (int)rows.size() ? rows[size_t(row)] : -1; }
+    int totalCount() const { return (int)order.size(); }
+
+protected:
+    void setColumns(const QStringList &titles, const QVector<KeyKind> &kinds);
+
+    virtual int records() const = 0;
+    virtual QString display(int record, int column) const = 0;
+    virtual double numberKey(int record, int column) const = 0;
+    virtual QString textKey(int record, int column) const = 0;
+    virtual qint64 dayOf(int record) const = 0;        // julian day, 0 if unknown
+    virtual QString searchText(int record) const = 0;  // matched by HistoryFilter::text
+
+private:
+    struct ColumnKeys {
+        KeyKind kind = KeyKind::Number;
+        std::vector<double> number;    // per record
+        std::vector<int> textId;       // per record, index into strings
+        QHash<QString, int> ids;
+        QStringList strings;
+        std::vector<int> rank;         // textId -> sort rank, rebuilt lazily
+        bool rankDirty = true;
+    };
+
+    void pushKeys(int record);
+    void ensureRank(ColumnKeys &c);
+    double sortKey(int record) const;
+    bool less(int a, int b) const;
+    void resort();
+    bool matches(int record) const;
+    void refilter();
+
+    QStringList titles;
+    std::vector<ColumnKeys> columns;
+    std::vector<qint64> days;
+    std::vector<QString> search; // lower-cased
+    std::vector<int> order;
+    std::vector<int> rows;
+    int sortColumn = -1; // -1: insertion order
+    Qt::SortOrder sortOrder = Qt::AscendingOrder;
+    HistoryFilter filter;
+    QString filterText; // filter.text lower-cased
+};
+
+// Binds HistoryModel to a PersistentVector of records that have a `date` member
+template <class R>
+class RecordTableModel : public HistoryModel {
+public:
+    struct Column {
+        QString title;
+        KeyKind kind;
+        std::function<QString(const R &)> display;
+        std::function<double(const R &)> number; // KeyKind::Number
+        std::function<QString(const R &)> text;  // KeyKind::Text
+    };
+
+    RecordTableModel(const PersistentVector<R> *data, std::vector<Column> cols, std::function<QString(const R &)> searchFn,
+                     QObject *parent = nullptr)
+        : HistoryModel(parent), recs(data), cols(std::move(cols)), searchFn(std::move(searchFn)) {
+        QStringList t; QVector<KeyKind> k;
+        for (const Column &c : this->cols) { t << c.title; k << c.kind; }
+        setColumns(t, k);
+    }
+
+protected:
+    int records() const override { return (int)recs->size(); }
+    QString display(int r, int c) const override { return cols[size_t(c)].display((*recs)[size_t(r)]); }
+    double numberKey(int r, int c) const override { return cols[size_t(c)].number((*recs)[size_t(r)]); }
+    QString textKey(int r, int c) const override { return cols[size_t(c)].text((*recs)[size_t(r)]); }
+    qint64 dayOf(int r) const override {
+        const QDate d = QDate::fromString((*recs)[size_t(r)].date, "yyyy-MM-dd");
+        return d.isValid() ? d.toJulianDay() : 0;
+    }
+    QString searchText(int r) const override { return searchFn ? searchFn((*recs)[size_t(r)]) : QString(); }
+
+private:
+    const PersistentVector<R> *recs;
+    std::vector<Column> cols;
+    std::function<QString(const R &)> searchFn;
+};
+
+#endif // HISTORYMODEL_H
@@ -0,0 +1,237 @@
+// leaderboard.cpp
+#include "leaderboard.h"
+#include "datparser.h"
+#include "tracing.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QtConcurrent>
+#include <algorithm>
+#include <set>
+
+namespace {
+
+// only recent periods are kept per member; older buckets can never appear on the board
+constexpr int KeptWeeks = 8;
+constexpr int KeptMonths = 3;
+
+qint64 weekKey(const QDate &d) { return d.addDays(1 - d.dayOfWeek()).toJulianDay(); }
+qint64 monthKey(const QDate &d) { return qint64(d.year()) * 12 + d.month() - 1; }
+
+QString totalsLine(char tag, qint64 key, const PeriodTotals &t)
+{
+    return QString("%1|%2|%3|%4|%5|%6\n").arg(QChar(tag)).arg(key)
+        .arg(t.distanceKm, 0, 'f', 3).arg(t.volumeKg, 0, 'f', 1).arg(t.workouts).arg(t.activeDays);
+}
+
+QString memberBlock(const MemberBoardStats &m)
+{
+    QString s = QString("M|%1|%2|%3|%4|%5\n").arg(m.username, m.name)
+        .arg(m.lastActive.isValid() ? m.lastActive.toJulianDay() : 0).arg(m.streak).arg(m.bestStreak);
+    for (auto it = m.weeks.cbegin(); it != m.weeks.cend(); ++it) s += totalsLine('W', it.key(), it.value());
+    for (auto it = m.months.cbegin(); it != m.months.cend(); ++it) s += totalsLine('O', it.key(), it.value());
+    return s;
+}
+
+double metricValue(const MemberBoardStats &m, BoardMetric metric, const QMap<qint64, PeriodTotals> &buckets, qint64 key, const QDate &today)
+{
+    if (metric == BoardMetric::Streak) // a streak is still alive if the member trained today or yesterday
+        return m.lastActive.isValid() && m.lastActive.daysTo(today) <= 1 ? m.streak : 0;
+    auto it = buckets.constFind(key);
+    if (it == buckets.cend()) return 0;
+    switch (metric) {
+    case BoardMetric::Distance: return it->distanceKm;
+    case BoardMetric::Volume: return it->volumeKg;
+    case BoardMetric::Workouts: return it->workouts;
+    case BoardMetric::ActiveDays: return it->activeDays;
+    default: return 0;
+    }
+}
+
+} // namespace
+
+MemberBoardStats Leaderboard::computeMember(const QString &username, const QString &name,
+                                            const PersistentVector<CardioWorkout> &cardio, const PersistentVector<StrengthWorkout> &strength,
+                                            const QDate &today)
+{
+    FT_TRACE_SCOPE("Leaderboard::computeMember");
+    MemberBoardStats m;
+    m.username = username;
+    m.name = name;
+    const qint64 firstWeek = weekKey(today) - 7 * (KeptWeeks - 1);
+    const qint64 firstMonth = monthKey(today) - (KeptMonths - 1);
+
+    std::set<qint64> days; // every training day, for active-day counts and streaks
+    auto add = [&](const QString &date, double km, double vol) {
+        QDate d = QDate::fromString(date, "yyyy-MM-dd");
+        if (!d.isValid()) return;
+        days.insert(d.toJulianDay());
+        const qint64 wk = weekKey(d), mo = monthKey(d);
+        if (wk >= firstWeek) { PeriodTotals &t = m.weeks[wk]; t.distanceKm += km; t.volumeKg += vol; t.workouts++; }
+        if (mo >= firstMonth) { PeriodTotals &t = m.months[mo]; t.distanceKm += km; t.volumeKg += vol; t.workouts++; }
+    };
+    for (auto &w : cardio) add(w.date, w.distance, 0.0);
+    for (auto &w : strength) add(w.date, 0.0, w.totalVolume);
+
+    qint64 prev = 0;
+    int run = 0;
+    for (qint64 jd : days) {
+        run = (run > 0 && jd == prev + 1) ? run + 1 : 1;
+        prev = jd;
+        m.bestStreak = qMax(m.bestStreak, run);
+        const QDate d = QDate::fromJulianDay(jd);
+        auto wk = m.weeks.find(weekKey(d));
+        if (wk != m.weeks.end()) wk->activeDays++;
+        auto mo = m.months.find(monthKey(d));
+        if (mo != m.months.end()) mo->activeDays++;
+    }
+    if (!days.empty()) { m.lastActive = QDate::fromJulianDay(prev); m.streak = run; }
+    return m;
+}
+
+QString Leaderboard::journalPath() const
+{
+    return dir.isEmpty() ? QString("leaderboard.dat") : QDir(dir).filePath("leaderboard.dat");
+}
+
+bool Leaderboard::load()
+{
+    FT_TRACE_SCOPE("Leaderboard::load");
+    // without a journal the board stays unloaded (members published meanwhile are kept) until replaceAll()
+    QFile f(journalPath());
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+    members.clear();
+    loaded = true;
+    QTextStream in(&f);
+    MemberBoardStats *cur = nullptr;
+    while (!in.atEnd()) {
+        QStringList p = in.readLine().split("|");
+        if (p[0] == "M" && p.size() >= 6) {
+            // a newer block for the same member replaces the older one
+            MemberBoardStats m;
+            m.username = p[1]; m.name = p[2];
+            const qint64 jd = p[3].toLongLong();
+            if (jd > 0) m.lastActive = QDate::fromJulianDay(jd);
+            m.streak = p[4].toInt(); m.bestStreak = p[5].toInt();
+            cur = &(members[m.username] = m);
+        } else if ((p[0] == "W" || p[0] == "O") && p.size() >= 6 && cur) {
+            PeriodTotals t;
+            t.distanceKm = p[2].toDouble(); t.volumeKg = p[3].toDouble();
+            t.workouts = p[4].toInt(); t.activeDays = p[5].toInt();
+            (p[0] == "W" ? cur->weeks : cur->months)[p[1].toLongLong()] = t;
+        }
+    }
+    // measured after replay so a journal full of superseded blocks gets compacted on the next save
+    compactedSize = 0;
+    for (const MemberBoardStats &m : std::as_const(members)) compactedSize += memberBlock(m).size();
+    return true;
+}
+
+void Leaderboard::updateMember(const QString &username, const QString &name,
+                               const PersistentVector<CardioWorkout> &cardio, const PersistentVector<StrengthWorkout> &strength)
+{
+    MemberBoardStats m = computeMember(username, name, cardio, strength);
+    // a journal holding only this member would pass for the whole board: until the first full scan
+    // the update stays in memory, and replaceAll() keeps it if the scan cannot read this member's files
+    if (!loaded && !load()) { members[username] = m; return; }
+    members[username] = m;
+    const qint64 size = QFileInfo(journalPath()).size();
+    // a failed compaction leaves the old journal in place, so the update is appended to it instead
+    if (size > 2 * compactedSize + 64 * 1024 && writeAll()) return;
+    appendJournal(m);
+}
+
+void Leaderboard::appendJournal(const MemberBoardStats &m)
+{
+    QFile f(journalPath());
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) return;
+    QTextStream out(&f);
+    out << memberBlock(m);
+}
+
+bool Leaderboard::writeAll()
+{
+    FT_TRACE_SCOPE("Leaderboard::writeAll");
+    // written beside the journal and renamed over it, so a crash mid-compaction keeps the old board
+    QSaveFile f(journalPath());
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+    QTextStream out(&f);
+    qint64 size = 0;
+    for (const MemberBoardStats &m : std::as_const(members)) {
+        const QString block = memberBlock(m);
+        size += block.size();
+        out << block;
+    }
+    out.flush();
+    if (out.status() != QTextStream::Ok || !f.commit()) return false;
+    compactedSize = size;
+    return true;
+}
+
+std::vector<MemberBoardStats> Leaderboard::scanAll(const QString &dir)
+{
+    FT_TRACE_SCOPE("Leaderboard::scanAll");
+    const std::vector<UserAccount> accounts = DatParser::loadUserIndex(dir);
+    const QDate today = QDate::currentDate();
+    std::vector<MemberBoardStats> all(accounts.size());
+    QList<int> indices;
+    for (int i = 0; i < (int)accounts.size(); ++i) indices << i;
+    QtConcurrent::blockingMap(indices, [&](int i) {
+        // files are read sequentially here: the member pool is the only source of parallelism
+        const UserData data = DatParser::loadUserData(accounts[i].username, dir, false);
+        if (data.locked) return; // encrypted files: left unnamed, so replaceAll() keeps the member's last block
+        all[i] = computeMember(accounts[i].username, accounts[i].name, data.cardio, data.strength, today);
+    });
+    return all;
+}
+
+void Leaderboard::replaceAll(const std::vector<MemberBoardStats> &all)
+{
+    QHash<QString, MemberBoardStats> scanned;
+    for (const MemberBoardStats &m : all) if (!m.username.isEmpty()) scanned.insert(m.username, m);
+    // members the scan could not read (encrypted files) keep what their own app last published
+    for (auto it = members.cbegin(); it != members.cend(); ++it)
+        if (!scanned.contains(it.key())) scanned.insert(it.key(), it.value());
+    members = std::move(scanned);
+    loaded = true;
+    writeAll();
+}
+
+std::vector<BoardEntry> Leaderboard::top(BoardMetric metric, BoardPeriod period, const QDate &today, int k,
+                                         const QString &username, int *rank) const
+{
+    FT_TRACE_SCOPE("Leaderboard::top");
+    const bool weekly = period == BoardPeriod::ThisWeek || period == BoardPeriod::LastWeek;
+    qint64 key = 0;
+    switch (period) {
+    case BoardPeriod::ThisWeek: key = weekKey(today); break;
+    case BoardPeriod::LastWeek: key = weekKey(today) - 7; break;
+    case BoardPeriod::ThisMonth: key = monthKey(today); break;
+    case BoardPeriod::LastMonth: key = monthKey(today) - 1; break;
+    }
+
+    std::vector<BoardEntry> entries;
+    entries.reserve(members.size());
+    double mine = 0;
+    for (const MemberBoardStats &m : members) {
+        const double v = metricValue(m, metric, weekly ? m.weeks : m.months, key, today);
+        if (m.username == username) mine = v;
+        if (v > 0) entries.push_back({m.username, m.name, v});
+    }
+    if (rank) {
+        *rank = 0;
+        if (mine > 0) *rank = 1 + (int)std::count_if(entries.begin(), entries.end(), [&](const BoardEntry &e) { return e.value > mine; });
+    }
+
+    // partial sort keeps opening the board O(n log k) for thousands of members
+    auto byValue = [](const BoardEntry &a, const BoardEntry &b) {
+        return a.value != b.value ? a.value > b.value : a.name.compare(b.name, Qt::CaseInsensitive) < 0;
+    };
+    const size_t n = qMin<size_t>(qMax(0, k), entries.size());
+    std::partial_sort(entries.begin(), entries.begin() + n, entries.end(), byValue);
+    entries.resize(n);
+    return entries;
+}
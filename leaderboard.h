@@ -0,0 +1,72 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+// FitTrack Pro - gym-wide leaderboards across every member in users.dat
+// Per-member weekly/monthly totals are cached in leaderboard.dat, an append-only journal:
+// a member's newest block replaces older ones, so a save only appends that member's block.
+// The journal is compacted when it doubles and can be rebuilt in parallel from all .dat files.
+#include <QDate>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include "models.h"
+
+struct PeriodTotals {
+    double distanceKm = 0.0;
+    double volumeKg = 0.0;
+    int workouts = 0;
+    int activeDays = 0;
+};
+
+struct MemberBoardStats {
+    QString username, name;
+    QMap<qint64, PeriodTotals> weeks;  // key: julian day of the week's Monday
+    QMap<qint64, PeriodTotals> months; // key: year * 12 + month - 1
+    QDate lastActive;                  // last day with any workout
+    int streak = 0;                    // consecutive training days ending at lastActive
+    int bestStreak = 0;
+};
+
+enum class BoardMetric { Distance, Volume, Workouts, ActiveDays, Streak };
+enum class BoardPeriod { ThisWeek, LastWeek, ThisMonth, LastMonth };
+
+struct BoardEntry { QString username, name; double value = 0.0; };
+
+class Leaderboard {
+public:
+    explicit Leaderboard(const QString &dir = QString()) : dir(dir) {}
+
+    bool load(); // false (and still unloaded) when there is no journal yet: the board needs scanAll() + replaceAll()
+    bool isLoaded() const { return loaded; }
+    int memberCount() const { return members.size(); }
+
+    // Recomputes one member from their in-memory history and appends it to the journal; before the
+    // first full scan (no journal) it is only kept in memory
+    void updateMember(const QString &username, const QString &name,
+                      const PersistentVector<CardioWorkout> &cardio, const PersistentVector<StrengthWorkout> &strength);
+
+    // Reads every member's files on the global pool (safe to call from a worker thread).
+    // Members with encrypted files come back with an empty username; replaceAll() keeps their old entry.
+    static std::vector<MemberBoardStats> scanAll(const QString &dir);
+    void replaceAll(const std::vector<MemberBoardStats> &all);
+
+    // Top k members by metric for the period around `today`; *rank receives `username`'s place (0 = unranked)
+    std::vector<BoardEntry> top(BoardMetric metric, BoardPeriod period, const QDate &today, int k,
+                                const QString &username = QString(), int *rank = nullptr) const;
+
+    static MemberBoardStats computeMember(const QString &username, const QString &name,
+                                          const PersistentVector<CardioWorkout> &cardio, const PersistentVector<StrengthWorkout> &strength,
+                                          const QDate &today = QDate::currentDate());
+
+private:
+    QString journalPath() const;
+    void appendJournal(const MemberBoardStats &m);
+    bool writeAll();
+
+    QString dir;
+    QHash<QString, MemberBoardStats> members;
+    qint64 compactedSize = 0;
+    bool loaded = false;
+};
+
+#endif // LEADERBOARD_H
@@ -3,8 +3,36 @@
 // Updated: bodyweight card shows a 7-day daily-weight bar chart (no "vs 7d ago" line)
 #include <QMetaObject>
 #include <QThread>
+#include <QtConcurrent>
 #include <QtWidgets>
+#include <functional>
+#include <memory>
 #include <vector>
+#include "activityview.h"
+#include "allocstats.h"
+#include "analytics.h"
+#include "batchreport.h"
+#include "benchmark.h"
+#include "bulkentry.h"
+#include "bwtrend.h"
+#include "calories.h"
+#include "datafile.h"
+#include "datparser.h"
+#include "heatmap.h"
+#include "historymodel.h"
+#include "leaderboard.h"
+#include "models.h"
+#include "pdfreport.h"
+#include "progress.h"
+#include "records.h"
+#include "reportcharts.h"
+#include "reports.h"
+#include "samplestore.h"
+#include "routeimport.h"
+#include "securestore.h"
+#include "traceoverlay.h"
+#include "tracing.h"
+#include "trainingload.h"
 
 // --- Lightweight 7-day bar chart widget (no external libs) ---
 class WeeklyBarChart : public QWidget {
@@ -27,6 +55,7 @@ public:
 
 protected:
     void paintEvent(QPaintEvent *) override {
+        FT_TRACE_SCOPE("WeeklyBarChart::paint");
         QPainter p(this);
         p.setRenderHint(QPainter::Antialiasing);
         QRect r = rect().marginsRemoved(QMargins(6,6,6,6));
@@ -78,24 +107,81 @@ private:
     QVector<double> data; // length 7
 };
 
-// --- Data structures ---
-struct ExerciseSet { int reps; double weight; };
-struct Exercise { QString name; std::vector<ExerciseSet> sets; };
-struct StrengthWorkout { QString date; std::vector<Exercise> exercises; double calories; };
-struct CardioWorkout { QString date; QString type; int duration; double distance; double calories; double avgSpeed; };
-struct BodyweightLog { QString date; double weight; };
-
-struct Goal {
-    QString name;
-    QString type; // "cardio_km", "strength_exercise"
-    double target = 0;
-    double progress = 0;
-    int targetTime = 0;
-    int progressTime = 0;
-    QString exerciseName;
-    double exWeight = 0;
-    int exSets = 0;
-    int exReps = 0;
+// --- Line chart for one series over time, with its moving average and regression line ---
+class TrendChart : public QWidget {
+    Q_OBJECT
+public:
+    explicit TrendChart(QWidget *parent = nullptr) : QWidget(parent) {
+        setMinimumHeight(180);
+        setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    }
+
+    // x: julian days (ascending), y/avg: same length; fit drawn over the last fitFrom.. points
+    void setData(std::vector<double> x, std::vector<double> y, std::vector<double> avg, LinearFit fit, int fitFrom, const QString &unit) {
+        xs = std::move(x); ys = std::move(y); ma = std::move(avg); line = fit; lineFrom = fitFrom; units = unit;
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override {
+        FT_TRACE_SCOPE("TrendChart::paint");
+        QPainter p(this);
+        p.setRenderHint(QPainter::Antialiasing);
+        QRect r = rect().marginsRemoved(QMargins(48,12,12,24));
+        p.fillRect(rect(), QColor(5, 18, 27));
+        if (xs.size() < 2) {
+            p.setPen(QColor("#b8c8d8"));
+            p.drawText(rect(), Qt::AlignCenter, "Log at least two entries to see a trend");
+            return;
+        }
+
+        double lo = ys[0], hi = ys[0];
+        for (double v : ys) { lo = qMin(lo, v); hi = qMax(hi, v); }
+        if (hi - lo < 1e-9) { hi += 1; lo -= 1; }
+        const double x0 = xs.front(), x1 = qMax(xs.back(), xs.front() + 1);
+        auto pt = [&](double x, double y) {
+            return QPointF(r.left() + (x - x0) / (x1 - x0) * r.width(), r.bottom() - (y - lo) / (hi - lo) * r.height());
+        };
+
+        // axes and labels
+        p.setPen(QPen(QColor(20,50,70), 1));
+        p.drawLine(r.bottomLeft(), r.bottomRight());
+        p.drawLine(r.bottomLeft(), r.topLeft());
+        p.setPen(QColor("#b8c8d8"));
+        p.drawText(QRect(0, r.top() - 8, 44, 16), Qt::AlignRight | Qt::AlignVCenter, QString::number(hi, 'f', 0));
+        p.drawText(QRect(0, r.bottom() - 8, 44, 16), Qt::AlignRight | Qt::AlignVCenter, QString::number(lo, 'f', 0));
+        p.drawText(QRect(r.left(), r.bottom() + 4, 120, 16), Qt::AlignLeft, QDate::fromJulianDay((qint64)x0).toString("yyyy-MM-dd"));
+        p.drawText(QRect(r.right() - 120, r.bottom() + 4, 120, 16), Qt::AlignRight, QDate::fromJulianDay((qint64)xs.back()).toString("yyyy-MM-dd"));
+        p.drawText(QRect(r.left() + 6, r.top(), 80, 16), Qt::AlignLeft, units);
+
+        // raw sessions
+        QPolygonF raw;
+        for (size_t i = 0; i < xs.size(); ++i) raw << pt(xs[i], ys[i]);
+        p.setPen(QPen(QColor(12,80,100), 2));
+        p.drawPolyline(raw);
+        p.setBrush(QColor(255,95,31));
+        p.setPen(Qt::NoPen);
+        for (const QPointF &q : raw) p.drawEllipse(q, 2.5, 2.5);
+
+        // moving average
+        QPolygonF avg;
+        for (size_t i = 0; i < ma.size() && i < xs.size(); ++i) avg << pt(xs[i], ma[i]);
+        p.setPen(QPen(QColor("#FFB86B"), 2));
+        p.drawPolyline(avg);
+
+        // regression over the trailing window
+        if (lineFrom >= 0 && lineFrom < (int)xs.size() - 1) {
+            const double a = xs[lineFrom], b = xs.back();
+            p.setPen(QPen(QColor("#ffffff"), 1.5, Qt::DashLine));
+            p.drawLine(pt(a, line.slope * a + line.intercept), pt(b, line.slope * b + line.intercept));
+        }
+    }
+
+private:
+    std::vector<double> xs, ys, ma;
+    LinearFit line;
+    int lineFrom = -1;
+    QString units;
 };
 
 // BackgroundWidget: paints a scaled pixmap that covers the widget (like CSS background-size: cover)
@@ -111,6 +197,7 @@ public:
 protected:
     void paintEvent(QPaintEvent *ev) override {
         Q_UNUSED(ev);
+        FT_TRACE_SCOPE("BackgroundWidget::paint");
         QPainter p(this);
         if (base.isNull()) { p.fillRect(rect(), palette().window()); return; }
         if (scaled.isNull()) updateScaledPixmap();
@@ -140,11 +227,10 @@ private:
     QPixmap scaled;
 };
 
-struct UserProfile { QString username; QString name; QString gender; double weight = 0; double targetBodyweight = 0; double height = 0; int age = 0; };
-
 // --- Main Window ---
 class FitTrackPro : public QMainWindow {
     Q_OBJECT
+    friend int runGuiBenchmark(const QStringList &args);
 public:
     FitTrackPro() {
         setWindowTitle("FitTrack Pro");
@@ -166,13 +252,13 @@ public:
             "QMainWindow, QWidget { background: #071126; color: #ffffff; font-family: 'Segoe UI', Roboto, Arial; }"
             "QGroupBox { background: #0b1b2b; border: 1px solid #163247; border-radius: 10px; margin-top: 12px; padding-top: 10px; }"
             "QGroupBox::title { subcontrol-origin: margin; left: 12px; padding: 0px 6px; color: #ffffff; font-weight: 900; font-size: 13px; }"
-            "QLabel, QLineEdit, QSpinBox, QDoubleSpinBox, QComboBox, QTableWidget, QHeaderView::section, QListWidget { color: #ffffff; }"
+            "QLabel, QLineEdit, QSpinBox, QDoubleSpinBox, QComboBox, QTableWidget, QTableView, QHeaderView::section, QListWidget { color: #ffffff; }"
             "QTabWidget::pane { border: none; background: transparent; }"
             "QTabBar::tab { background: #071126; color: #ffffff; padding: 12px 22px; margin: 4px; border-radius: 8px; font-weight: 900; font-size: 14.5px; }"
             "QTabBar::tab:selected { background: #0f2a40; }"
             "QLineEdit, QSpinBox, QDoubleSpinBox, QComboBox, QDateEdit { background: #071b2a; border: 1px solid #163247; border-radius: 8px; padding: 8px; color: #ffffff; }"
             "QLineEdit::placeholder { color: #b8c8d8; }"
-            "QTableWidget { background: #05121b; alternate-background-color: #081826; gridline-color: #10314a; border-radius: 8px; selection-background-color: #FF833F; }"
+            "QTableWidget, QTableView { background: #05121b; alternate-background-color: #081826; gridline-color: #10314a; border-radius: 8px; selection-background-color: #FF833F; }"
             "QHeaderView::section { background: #0c3550; color: #ffffff; font-weight: 900; padding: 10px; border: none; font-size: 13px; }"
             "QListWidget { background: #07121b; border: 1px solid #163247; border-radius: 8px; }"
             "QProgressBar { background: #061223; border: 1px solid #163247; border-radius: 8px; text-align: center; min-height: 22px; }"
@@ -202,30 +288,80 @@ public:
         stack->addWidget(signupPage);
         stack->addWidget(profilePage);
         stack->addWidget(mainPage);
+        connect(stack, &QStackedWidget::currentChanged, [this](int){ flushStaleViews(); });
 
         applyCompactRoundedButtons();
 
         QFont tableFont = QApplication::font();
         tableFont.setPointSize(11);
-        for (QTableWidget *t : this->findChildren<QTableWidget*>()) {
+        for (QTableView *t : this->findChildren<QTableView*>()) {
             t->setFont(tableFont);
             t->verticalHeader()->setDefaultSectionSize(36);
             t->setAlternatingRowColors(true);
         }
+
+#ifdef FITTRACK_TRACING
+        // F12 toggles the perf overlay, Ctrl+Shift+T dumps a Chrome trace next to the data files
+        traceOverlay = new TraceOverlay(this);
+        auto *overlayKey = new QShortcut(QKeySequence(Qt::Key_F12), this);
+        connect(overlayKey, &QShortcut::activated, [this]{ traceOverlay->toggle(); });
+        auto *dumpKey = new QShortcut(QKeySequence("Ctrl+Shift+T"), this);
+        connect(dumpKey, &QShortcut::activated, [this]{ dumpTrace(); });
+#endif
+#ifdef FITTRACK_ALLOC_STATS
+        // F11 shows per-action allocation counts
+        auto *allocKey = new QShortcut(QKeySequence(Qt::Key_F11), this);
+        connect(allocKey, &QShortcut::activated, [this]{ showAllocReport(); });
+#endif
     }
 
 private:
     // Data
     UserProfile user;
-    std::vector<CardioWorkout> cardio;
-    std::vector<StrengthWorkout> strength;
-    std::vector<BodyweightLog> weightLogs;
-    std::vector<Goal> goals;
+    // persistent vectors (persistentvector.h): a worker takes a copy as its snapshot in O(1), and each
+    // edit here copies only the path to the changed record, so the two never share mutable state
+    PersistentVector<CardioWorkout> cardio;
+    PersistentVector<StrengthWorkout> strength;
+    PersistentVector<BodyweightLog> weightLogs;
+    PersistentVector<Goal> goals;
     std::vector<Exercise> curEx;
+    PersonalRecords records; // maintained alongside `strength`
+    std::vector<ExerciseSeries> progressSeries; // rebuilt whenever `strength` changes
+    WeightTrend weightTrend; // follows `weightLogs` entry by entry
+    TrainingLoad trainingLoad; // follows `cardio` and `strength` per saved/deleted workout
     QString pUser, pName;
+    bool quiet = false; // --bench-gui: actions skip their confirmation boxes
+
+    // Login prefetch: once the username field names a known account, its files are parsed on a worker
+    // while the password is typed. doLogin() takes the result only for that user, after the password
+    // checks out and if none of the files changed since; anything else drops it.
+    static constexpr int PrefetchDelayMs = 250; // typing pause before a prefetch starts
+    QTimer *prefetchTimer = nullptr;
+    QString prefetchUser;
+    QList<qint64> prefetchStamp;
+    QFuture<UserData> prefetch;
+    QByteArray dataKey; // while set, saveData() encrypts the member's files with it (see securestore.h)
+    bool snapshotPending = false; // the session's first save keeps the files it replaces as .bak (see datafile.h)
+
+    // Views that derive from the data above. A mutation marks the affected views stale; a stale view
+    // is recomputed when it is (or next becomes) visible, so hidden tabs cost nothing per action.
+    enum View : unsigned {
+        ViewDashboard = 1u << 0, // weekly cards, charts, bodyweight trend and training load
+        ViewGoals = 1u << 1,
+        ViewRecords = 1u << 2,
+        ViewProgress = 1u << 3,
+        ViewWeight = 1u << 4,    // bodyweight tab: trend chart and forecast
+        ViewProfile = 1u << 5,   // profile editor fields and BMI
+        ViewCalendar = 1u << 6,  // activity heatmap
+        ViewReports = 1u << 7,   // computed on a worker thread, drawn when it finishes
+        ViewAll = (1u << 8) - 1
+    };
+    unsigned staleViews = ViewAll;
+    QMap<unsigned, QWidget*> viewPages; // the tab page that shows each view
 
     // Widgets
     QStackedWidget *stack = nullptr;
+    QTabWidget *mainTabs = nullptr, *logTabs = nullptr;
     QWidget *loginPage = nullptr, *signupPage = nullptr, *profilePage = nullptr, *mainPage = nullptr;
     QLineEdit *logUser = nullptr, *logPass = nullptr, *sigName = nullptr, *sigUser = nullptr, *sigPass = nullptr, *sigConf = nullptr;
     QComboBox *profGender = nullptr, *cardioTypeCb = nullptr, *goalTypeCb = nullptr, *editGender = nullptr;
@@ -233,8 +369,35 @@ private:
     QSpinBox *profAge = nullptr, *cardioDur = nullptr, *exSets = nullptr, *editAge = nullptr;
     QDateEdit *cardioDateEd = nullptr, *strDateEd = nullptr;
     QLineEdit *exName = nullptr, *goalNameEd = nullptr;
-    QTableWidget *setsT = nullptr, *cardioT = nullptr, *strT = nullptr, *goalsT = nullptr, *weightT = nullptr;
+    QTableWidget *setsT = nullptr, *goalsT = nullptr, *recordsT = nullptr;
+    // history tables: views over `cardio`, `strength` and `weightLogs` with typed sort keys
+    QTableView *cardioT = nullptr, *strT = nullptr, *weightT = nullptr;
+    RecordTableModel<CardioWorkout> *cardioModel = nullptr;
+    RecordTableModel<StrengthWorkout> *strModel = nullptr;
+    RecordTableModel<BodyweightLog> *weightModel = nullptr;
+    QLineEdit *historySearchEd = nullptr;
+    QCheckBox *historyRangeCb = nullptr;
+    QDateEdit *historyFromEd = nullptr, *historyToEd = nullptr;
     QListWidget *exList = nullptr;
+    QTableWidget *progressT = nullptr;
+    QComboBox *progressMetricCb = nullptr;
+    TrendChart *progressChart = nullptr;
+    QComboBox *heatmapMetricCb = nullptr;
+    ActivityHeatmap *heatmap = nullptr;
+    // Reports tab: datasets come from Reports::compute() on a worker; a newer request cancels the running one
+    QComboBox *reportRangeCb = nullptr;
+    QLabel *reportInfoLbl = nullptr;
+    QTableWidget *reportMonthsT = nullptr;
+    ShareChart *reportShareChart = nullptr;
+    RankedBarChart *reportVolumeChart = nullptr;
+    TrendChart *reportWeightChart = nullptr;
+    QFutureWatcher<ReportData> *reportWatcher = nullptr;
+    ReportData shownReport; // what the tab displays; the PDF export prints exactly this
+    QPushButton *reportPdfBtn = nullptr;
+    QFutureWatcher<QString> *pdfWatcher = nullptr; // error text, empty on success
+    // GPX/TCX/FIT import: files are parsed and analysed on the pool, committed as one batch when all are done
+    QFutureWatcher<RouteImport::FileResult> *importWatcher = nullptr;
+    QProgressDialog *importProgress = nullptr;
     QLabel *welLblMain = nullptr, *userLbl = nullptr, *cCnt = nullptr, *cDist = nullptr, *cCal = nullptr, *sCnt = nullptr, *sVol = nullptr, *sCal = nullptr, *bmiLbl = nullptr, *bmiCat = nullptr;
     QProgressBar *cGoalBar = nullptr, *sGoalBar = nullptr;
 
@@ -244,6 +407,13 @@ private:
     QLabel *strengthWeeklyLbl = nullptr;
     QLabel *strengthWeeklySub = nullptr;
     QLabel *bwCurrentLbl = nullptr;
+    QLabel *bwTrendSub = nullptr;
+    QLabel *bwForecastLbl = nullptr;
+    TrendChart *bwHistoryChart = nullptr;
+    QLabel *loadLbl = nullptr;
+    QLabel *loadSub = nullptr;
+    QProgressBar *loadBar = nullptr;
+    WeeklyBarChart *loadChart = nullptr;
     WeeklyBarChart *cardioChart = nullptr;
     WeeklyBarChart *strengthChart = nullptr;
     WeeklyBarChart *bwChart = nullptr;
@@ -260,6 +430,17 @@ private:
     QSpinBox *goalExRepsSp = nullptr;
 
     QCheckBox *perSetWeightCb = nullptr;
+    QPushButton *encryptBtn = nullptr;
+
+    TraceOverlay *traceOverlay = nullptr; // tracing builds only
+
+    // Gym-wide leaderboard (leaderboard.dat, shared by every account)
+    Leaderboard leaderboard;
+    QWidget *boardPage = nullptr;
+    QComboBox *boardPeriodCb = nullptr, *boardMetricCb = nullptr;
+    QTableWidget *boardT = nullptr;
+    QLabel *boardInfoLbl = nullptr;
+    QFutureWatcher<std::vector<MemberBoardStats>> *boardWatcher = nullptr;
 
     // Profile/bodyweight controls
     QDoubleSpinBox *targetBodyweightSp = nullptr;
@@ -356,6 +537,14 @@ private:
         logUser->setPlaceholderText("Enter Username");
         logUser->setStyleSheet("font-weight:700; color:#ffffff;");
         gl->addWidget(logUser);
+        prefetchTimer = new QTimer(this);
+        prefetchTimer->setSingleShot(true);
+        prefetchTimer->setInterval(PrefetchDelayMs);
+        connect(prefetchTimer, &QTimer::timeout, [this]{ startPrefetch(); });
+        connect(logUser, &QLineEdit::textChanged, [this](const QString &t){
+            if (t.trimmed() != prefetchUser) dropPrefetch();
+            prefetchTimer->start();
+        });
 
         QLabel *pLbl = new QLabel("Password:");
         pLbl->setStyleSheet("font-weight:900; color:#ffffff; font-size:13px;");
@@ -539,25 +728,91 @@ private:
         welcomeLayout->addWidget(userLbl);
         lo->addWidget(welcomeWidget);
 
-        auto *tabs = new QTabWidget;
-        tabs->addTab(buildDashboard(), "Dashboard");
+        auto *tabs = mainTabs = new QTabWidget;
+        tabs->addTab(viewPages[ViewDashboard] = buildDashboard(), "Dashboard");
         tabs->addTab(buildLogTab(), "Log");
-        tabs->addTab(buildGoalsTab(), "Goals");
-        tabs->addTab(buildProfileTab(), "Profile");
+        tabs->addTab(viewPages[ViewProgress] = buildProgressTab(), "Progress");
+        tabs->addTab(viewPages[ViewCalendar] = buildCalendarTab(), "Calendar");
+        tabs->addTab(viewPages[ViewReports] = buildReportsTab(), "Reports");
+        tabs->addTab(viewPages[ViewGoals] = buildGoalsTab(), "Goals");
+        tabs->addTab(buildLeaderboardTab(), "Leaderboard");
+        tabs->addTab(viewPages[ViewProfile] = buildProfileTab(), "Profile");
+        connect(tabs, &QTabWidget::currentChanged, [this, tabs](int){
+            if (tabs->currentWidget() == boardPage) refreshLeaderboard();
+            flushStaleViews();
+        });
         lo->addWidget(tabs);
     }
 
     QWidget* buildLogTab() {
         auto *w = new QWidget;
         auto *lo = new QVBoxLayout(w);
-        auto *subTabs = new QTabWidget;
+        auto *subTabs = logTabs = new QTabWidget;
         subTabs->addTab(buildCardioTab(), "Cardio");
         subTabs->addTab(buildStrengthTab(), "Strength");
-        subTabs->addTab(buildBodyweightTab(), "Bodyweight");
+        subTabs->addTab(viewPages[ViewWeight] = buildBodyweightTab(), "Bodyweight");
+        subTabs->addTab(viewPages[ViewRecords] = buildRecordsTab(), "Records");
+        connect(subTabs, &QTabWidget::currentChanged, [this](int){ flushStaleViews(); });
+
+        // one filter bar drives all three history tables
+        auto *fb = new QHBoxLayout;
+        historySearchEd = new QLineEdit; historySearchEd->setPlaceholderText("Filter by type or exercise");
+        historySearchEd->setClearButtonEnabled(true);
+        fb->addWidget(historySearchEd, 1);
+        historyRangeCb = new QCheckBox("Date range");
+        fb->addWidget(historyRangeCb);
+        historyFromEd = new QDateEdit(QDate::currentDate().addMonths(-1)); historyFromEd->setCalendarPopup(true); historyFromEd->setEnabled(false);
+        historyToEd = new QDateEdit(QDate::currentDate()); historyToEd->setCalendarPopup(true); historyToEd->setEnabled(false);
+        fb->addWidget(historyFromEd); fb->addWidget(new QLabel("to")); fb->addWidget(historyToEd);
+        auto *clr = new QPushButton("Clear");
+        fb->addWidget(clr);
+        auto *bulk = new QPushButton("Bulk Entry");
+        bulk->setToolTip("Backfill many cardio, strength or bodyweight entries and save them in one go");
+        connect(bulk, &QPushButton::clicked, [this]{ bulkEntry(); });
+        fb->addWidget(bulk);
+        connect(historySearchEd, &QLineEdit::textChanged, [this]{ applyHistoryFilter(); });
+        connect(historyRangeCb, &QCheckBox::toggled, [this](bool on){ historyFromEd->setEnabled(on); historyToEd->setEnabled(on); applyHistoryFilter(); });
+        connect(historyFromEd, &QDateEdit::dateChanged, [this]{ applyHistoryFilter(); });
+        connect(historyToEd, &QDateEdit::dateChanged, [this]{ applyHistoryFilter(); });
+        connect(clr, &QPushButton::clicked, [this]{ historySearchEd->clear(); historyRangeCb->setChecked(false); });
+        lo->addLayout(fb);
+
         lo->addWidget(subTabs);
         return w;
     }
 
+    QTableView* makeHistoryView(HistoryModel *model) {
+        auto *v = new QTableView;
+        v->setModel(model);
+        v->setSelectionBehavior(QAbstractItemView::SelectRows);
+        v->setSelectionMode(QAbstractItemView::SingleSelection);
+        v->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        v->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+        v->setSortingEnabled(true);
+        v->sortByColumn(0, Qt::AscendingOrder);
+        return v;
+    }
+
+    static qint64 dateKey(const QString &date) {
+        const QDate d = QDate::fromString(date, "yyyy-MM-dd");
+        return d.isValid() ? d.toJulianDay() : 0;
+    }
+
+    void applyHistoryFilter() {
+        FT_TRACE_SCOPE("applyHistoryFilter");
+        HistoryFilter f;
+        f.text = historySearchEd->text();
+        if (historyRangeCb->isChecked()) { f.from = historyFromEd->date(); f.to = historyToEd->date(); }
+        cardioModel->setFilter(f);
+        strModel->setFilter(f);
+        f.text.clear(); // weigh-ins have nothing to search, only the date range applies
+        weightModel->setFilter(f);
+    }
+
+    void resetHistoryModels() {
+        cardioModel->reset(); strModel->reset(); weightModel->reset();
+    }
+
     QWidget* buildDashboard() {
         auto *w = new QWidget;
         auto *lo = new QVBoxLayout(w);
@@ -628,7 +883,7 @@ private:
         CardWidgets bwCW = makeCard("Bodyweight");
         bwCurrentLbl = bwCW.bigLbl;
         if (bwCW.bar) bwCW.bar->hide();        // hide progress bar for bodyweight card
-        if (bwCW.subLbl) bwCW.subLbl->clear(); // remove any sub-label text
+        bwTrendSub = bwCW.subLbl;              // trend, weekly rate and goal forecast
         lo->addWidget(bwCW.card);
 
         // bodyweight chart (same style as others)
@@ -636,6 +891,17 @@ private:
         bwChart->setFixedHeight(56);
         static_cast<QVBoxLayout*>(bwCW.card->layout())->addWidget(bwChart);
 
+        // Training load - acute:chronic ratio, bar scaled so 1.5 (high risk) sits at 75%
+        CardWidgets loadCW = makeCard("Training Load (ACWR)");
+        loadLbl = loadCW.bigLbl;
+        loadBar = loadCW.bar;
+        loadSub = loadCW.subLbl;
+        lo->addWidget(loadCW.card);
+
+        loadChart = new WeeklyBarChart;
+        loadChart->setFixedHeight(56);
+        static_cast<QVBoxLayout*>(loadCW.card->layout())->addWidget(loadChart);
+
         // small spacer at bottom
         lo->addStretch();
 
@@ -688,6 +954,14 @@ private:
 
         fl->addLayout(gr);
         auto *sv = new QPushButton("Save Cardio"); connect(sv, &QPushButton::clicked, [this]{ saveCardio(); }); fl->addWidget(sv);
+        auto *ib = new QHBoxLayout;
+        auto *imp = new QPushButton("Import GPX / TCX / FIT...");
+        imp->setToolTip("Add runs and rides recorded by a GPS watch or app, with distance, moving time, splits and elevation gain");
+        connect(imp, &QPushButton::clicked, [this]{ importRoutes(false); }); ib->addWidget(imp);
+        auto *impDir = new QPushButton("Import Folder...");
+        impDir->setToolTip("Import every GPX, TCX and FIT file in a folder and its subfolders");
+        connect(impDir, &QPushButton::clicked, [this]{ importRoutes(true); }); ib->addWidget(impDir);
+        fl->addLayout(ib);
         fl->addStretch();
         fgVBox->addLayout(fl);
         fg->setLayout(fgVBox);
@@ -701,13 +975,28 @@ private:
         hgHeading->setStyleSheet("font-weight:900; font-size:16px; color:#ffffff;");
         hgVBox->addWidget(hgHeading);
 
-        cardioT = new QTableWidget; cardioT->setColumnCount(6);
-        cardioT->setHorizontalHeaderLabels({"Date","Type","Duration","Distance","Avg Speed (Km/H)","Calories"});
-        cardioT->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-        cardioT->setAlternatingRowColors(true);
+        using CardioCol = RecordTableModel<CardioWorkout>::Column;
+        using K = HistoryModel::KeyKind;
+        cardioModel = new RecordTableModel<CardioWorkout>(&cardio, {
+            CardioCol{"Date", K::Number, [](const CardioWorkout &w){ return w.date; }, [](const CardioWorkout &w){ return double(dateKey(w.date)); }, {}},
+            CardioCol{"Type", K::Text, [](const CardioWorkout &w){ return w.type; }, {}, [](const CardioWorkout &w){ return w.type; }},
+            CardioCol{"Duration", K::Number, [](const CardioWorkout &w){ return QString::number(w.duration) + " min"; }, [](const CardioWorkout &w){ return double(w.duration); }, {}},
+            CardioCol{"Distance", K::Number, [](const CardioWorkout &w){ return QString::number(w.distance, 'f', 2) + " km"; }, [](const CardioWorkout &w){ return w.distance; }, {}},
+            CardioCol{"Avg Speed (Km/H)", K::Number, [](const CardioWorkout &w){ return QString::number(w.avgSpeed, 'f', 2) + " km/h"; }, [](const CardioWorkout &w){ return w.avgSpeed; }, {}},
+            CardioCol{"Calories", K::Number, [](const CardioWorkout &w){ return QString::number((int)w.calories) + " cal"; }, [](const CardioWorkout &w){ return w.calories; }, {}},
+            CardioCol{"Avg HR", K::Number, [](const CardioWorkout &w){ return w.heartRate.average ? QString::number(w.heartRate.average) + " bpm" : QString("-"); }, [](const CardioWorkout &w){ return double(w.heartRate.average); }, {}},
+            CardioCol{"Elev. Gain", K::Number, [](const CardioWorkout &w){ return w.elevationGain > 0 ? QString::number((int)w.elevationGain) + " m" : QString("-"); }, [](const CardioWorkout &w){ return w.elevationGain; }, {}},
+        }, [](const CardioWorkout &w){ return w.type; }, this);
+        cardioT = makeHistoryView(cardioModel);
         hgVBox->addWidget(cardioT);
 
-        auto *db = new QPushButton("Delete"); connect(db, &QPushButton::clicked, [this]{ delCardio(); }); hgVBox->addWidget(db);
+        connect(cardioT, &QTableView::doubleClicked, [this]{ showActivity(); });
+        auto *cb = new QHBoxLayout;
+        auto *vs = new QPushButton("View Samples");
+        vs->setToolTip("Heart rate, speed, cadence and altitude over time, for activities imported from a GPS file");
+        connect(vs, &QPushButton::clicked, [this]{ showActivity(); }); cb->addWidget(vs);
+        auto *db = new QPushButton("Delete"); connect(db, &QPushButton::clicked, [this]{ delCardio(); }); cb->addWidget(db);
+        hgVBox->addLayout(cb);
         hg->setLayout(hgVBox);
 
         lo->addWidget(hg);
@@ -815,10 +1104,21 @@ private:
         hgHeading->setStyleSheet("font-weight:900; font-size:16px; color:#ffffff;");
         hgVBox->addWidget(hgHeading);
 
-        strT = new QTableWidget; strT->setColumnCount(5);
-        strT->setHorizontalHeaderLabels({"Date","Exercises","Sets","Reps","Volume"});
-        strT->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-        connect(strT, &QTableWidget::cellDoubleClicked, [this](int r, int){ showStrDetails(r); });
+        using StrCol = RecordTableModel<StrengthWorkout>::Column;
+        using K = HistoryModel::KeyKind;
+        strModel = new RecordTableModel<StrengthWorkout>(&strength, {
+            StrCol{"Date", K::Number, [](const StrengthWorkout &w){ return w.date; }, [](const StrengthWorkout &w){ return double(dateKey(w.date)); }, {}},
+            StrCol{"Exercises", K::Number, [](const StrengthWorkout &w){ return QString::number(w.exercises.size()); }, [](const StrengthWorkout &w){ return double(w.exercises.size()); }, {}},
+            StrCol{"Sets", K::Number, [](const StrengthWorkout &w){ return QString::number(w.setCount); }, [](const StrengthWorkout &w){ return double(w.setCount); }, {}},
+            StrCol{"Reps", K::Number, [](const StrengthWorkout &w){ return QString::number(w.repCount); }, [](const StrengthWorkout &w){ return double(w.repCount); }, {}},
+            StrCol{"Volume", K::Number, [](const StrengthWorkout &w){ return QString::number((int)w.totalVolume) + " kg"; }, [](const StrengthWorkout &w){ return w.totalVolume; }, {}},
+        }, [](const StrengthWorkout &w){
+            QStringList names;
+            for (auto &e : w.exercises) names << e.name;
+            return names.join(' ');
+        }, this);
+        strT = makeHistoryView(strModel);
+        connect(strT, &QTableView::doubleClicked, [this](const QModelIndex &i){ showStrDetails(strModel->recordAt(i.row())); });
         hgVBox->addWidget(strT);
         auto *db = new QPushButton("Delete"); connect(db, &QPushButton::clicked, [this]{ delStrength(); }); hgVBox->addWidget(db);
         hg->setLayout(hgVBox);
@@ -860,15 +1160,169 @@ private:
         auto *saveBtn = new QPushButton("Save Weight"); connect(saveBtn, &QPushButton::clicked, [this]{ saveBodyweight(); });
         lo->addWidget(saveBtn);
 
-        weightT = new QTableWidget;
-        weightT->setColumnCount(2);
-        weightT->setHorizontalHeaderLabels({"Date","Weight (Kg)"});
-        weightT->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+        using WeightCol = RecordTableModel<BodyweightLog>::Column;
+        using K = HistoryModel::KeyKind;
+        weightModel = new RecordTableModel<BodyweightLog>(&weightLogs, {
+            WeightCol{"Date", K::Number, [](const BodyweightLog &b){ return b.date; }, [](const BodyweightLog &b){ return double(dateKey(b.date)); }, {}},
+            WeightCol{"Weight (Kg)", K::Number, [](const BodyweightLog &b){ return QString::number(b.weight, 'f', 1) + " kg"; }, [](const BodyweightLog &b){ return b.weight; }, {}},
+        }, {}, this);
+        weightT = makeHistoryView(weightModel);
         lo->addWidget(weightT);
 
         auto *delBtn = new QPushButton("Delete"); connect(delBtn, &QPushButton::clicked, [this]{ delBodyweight(); });
         lo->addWidget(delBtn);
 
+        // full history: raw weigh-ins, smoothed trend and the rolling regression
+        bwHistoryChart = new TrendChart;
+        lo->addWidget(bwHistoryChart);
+        bwForecastLbl = new QLabel("");
+        bwForecastLbl->setAlignment(Qt::AlignCenter);
+        bwForecastLbl->setStyleSheet("font-weight:700; color:#ffffff; font-size:12px;");
+        lo->addWidget(bwForecastLbl);
+
+        return w;
+    }
+
+    QWidget* buildRecordsTab() {
+        auto *w = new QWidget;
+        auto *lo = new QVBoxLayout(w);
+
+        auto *heading = new QLabel("Personal Records");
+        heading->setAlignment(Qt::AlignCenter);
+        heading->setStyleSheet("font-weight:900; font-size:16px; color:#ffffff;");
+        lo->addWidget(heading);
+
+        recordsT = new QTableWidget; recordsT->setColumnCount(6);
+        recordsT->setHorizontalHeaderLabels({"Exercise","Heaviest","Best Reps","Est. 1RM (Epley)","Est. 1RM (Brzycki)","Best Session Volume"});
+        recordsT->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+        recordsT->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        lo->addWidget(recordsT);
+        return w;
+    }
+
+    QWidget* buildProgressTab() {
+        auto *w = new QWidget; auto *lo = new QVBoxLayout(w);
+
+        auto *heading = new QLabel("Progressive Overload");
+        heading->setAlignment(Qt::AlignCenter);
+        heading->setStyleSheet("font-weight:900; font-size:18px; color:#ffffff;");
+        lo->addWidget(heading);
+
+        auto *row = new QHBoxLayout;
+        auto *metricLbl = new QLabel("Metric:"); metricLbl->setStyleSheet("font-weight:900;"); row->addWidget(metricLbl);
+        progressMetricCb = new QComboBox; progressMetricCb->addItems({"Session Volume","Top Set","Est. 1RM","Avg Intensity"});
+        progressMetricCb->setCurrentIndex(2);
+        row->addWidget(progressMetricCb); row->addStretch();
+        lo->addLayout(row);
+
+        progressT = new QTableWidget; progressT->setColumnCount(6);
+        progressT->setHorizontalHeaderLabels({"Exercise","Sessions","Latest","Moving Avg","Trend / Week","Status"});
+        progressT->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+        progressT->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        progressT->setSelectionBehavior(QAbstractItemView::SelectRows);
+        progressT->setSelectionMode(QAbstractItemView::SingleSelection);
+        lo->addWidget(progressT, 1);
+
+        progressChart = new TrendChart;
+        lo->addWidget(progressChart, 1);
+
+        connect(progressMetricCb, QOverload<int>::of(&QComboBox::currentIndexChanged), [this](int){ refreshProgress(); });
+        connect(progressT, &QTableWidget::currentCellChanged, [this](int r, int, int, int){ showProgressChart(r); });
+        return w;
+    }
+
+    QWidget* buildCalendarTab() {
+        auto *w = new QWidget;
+        auto *lo = new QVBoxLayout(w);
+        auto *heading = new QLabel("Training Calendar");
+        heading->setAlignment(Qt::AlignCenter);
+        heading->setStyleSheet("font-weight:900; font-size:16px; color:#ffffff;");
+        lo->addWidget(heading);
+
+        auto *row = new QHBoxLayout;
+        auto *metricLbl = new QLabel("Show:");
+        metricLbl->setStyleSheet("font-weight:900; color:#ffffff; font-size:13px;");
+        row->addWidget(metricLbl);
+        heatmapMetricCb = new QComboBox;
+        heatmapMetricCb->addItems({"Cardio distance", "Strength volume", "Training load"});
+        connect(heatmapMetricCb, QOverload<int>::of(&QComboBox::currentIndexChanged), [this](int){ refreshHeatmap(); });
+        row->addWidget(heatmapMetricCb);
+        row->addStretch();
+        lo->addLayout(row);
+
+        heatmap = new ActivityHeatmap;
+        auto *scroll = new QScrollArea;
+        scroll->setWidget(heatmap);
+        scroll->setWidgetResizable(true);
+        scroll->setFrameShape(QFrame::NoFrame);
+        lo->addWidget(scroll, 1);
+        return w;
+    }
+
+    QWidget* buildReportsTab() {
+        auto *w = new QWidget;
+        auto *lo = new QVBoxLayout(w);
+        auto *heading = new QLabel("Reports");
+        heading->setAlignment(Qt::AlignCenter);
+        heading->setStyleSheet("font-weight:900; font-size:16px; color:#ffffff;");
+        lo->addWidget(heading);
+
+        auto *row = new QHBoxLayout;
+        auto *rangeLbl = new QLabel("Range:");
+        rangeLbl->setStyleSheet("font-weight:900; color:#ffffff; font-size:13px;");
+        row->addWidget(rangeLbl);
+        reportRangeCb = new QComboBox;
+        reportRangeCb->addItems({"Last 3 months", "Last 6 months", "Last 12 months", "All time"}); // Reports::Range order
+        reportRangeCb->setCurrentIndex(1);
+        connect(reportRangeCb, QOverload<int>::of(&QComboBox::currentIndexChanged), [this](int){ refreshReports(); });
+        row->addWidget(reportRangeCb);
+        row->addStretch();
+        reportInfoLbl = new QLabel("");
+        reportInfoLbl->setStyleSheet("font-weight:700; color:#ffffff; font-size:12px;");
+        row->addWidget(reportInfoLbl);
+        reportPdfBtn = new QPushButton("Export PDF");
+        reportPdfBtn->setEnabled(false);
+        connect(reportPdfBtn, &QPushButton::clicked, [this]{ exportReportPdf(); });
+        row->addWidget(reportPdfBtn);
+        lo->addLayout(row);
+
+        reportMonthsT = new QTableWidget; reportMonthsT->setColumnCount(8);
+        reportMonthsT->setHorizontalHeaderLabels({"Month","Cardio","Km","Minutes","Strength","Volume (kg)","Calories","Avg Weight"});
+        reportMonthsT->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+        reportMonthsT->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        lo->addWidget(reportMonthsT, 1);
+
+        auto *grid = new QGridLayout;
+        auto caption = [](const QString &text) {
+            auto *l = new QLabel(text);
+            l->setStyleSheet("font-weight:900; color:#ffffff; font-size:13px;");
+            return l;
+        };
+        grid->addWidget(caption("Activity Mix (minutes)"), 0, 0);
+        grid->addWidget(caption("Volume by Exercise"), 0, 1);
+        reportShareChart = new ShareChart;
+        reportVolumeChart = new RankedBarChart;
+        grid->addWidget(reportShareChart, 1, 0);
+        grid->addWidget(reportVolumeChart, 1, 1);
+        grid->addWidget(caption("Bodyweight"), 2, 0, 1, 2);
+        reportWeightChart = new TrendChart;
+        grid->addWidget(reportWeightChart, 3, 0, 1, 2);
+        lo->addLayout(grid, 2);
+
+        reportWatcher = new QFutureWatcher<ReportData>(this);
+        connect(reportWatcher, &QFutureWatcherBase::finished, [this]{
+            // cancelled runs finish too, and add no result
+            if (reportWatcher->isCanceled() || reportWatcher->future().resultCount() == 0) return;
+            showReport(reportWatcher->result());
+        });
+        pdfWatcher = new QFutureWatcher<QString>(this);
+        connect(pdfWatcher, &QFutureWatcherBase::finished, [this]{
+            reportPdfBtn->setText("Export PDF");
+            reportPdfBtn->setEnabled(canExportReport() && !reportWatcher->isRunning()); // the member may have logged out meanwhile
+            const QString error = pdfWatcher->result();
+            if (!error.isEmpty()) QMessageBox::warning(this, "Error", "Could not export the report: " + error);
+            else notify("Success", "Report exported!");
+        });
         return w;
     }
 
@@ -968,6 +1422,46 @@ private:
         return w;
     }
 
+    QWidget* buildLeaderboardTab() {
+        boardPage = new QWidget; auto *lo = new QVBoxLayout(boardPage);
+
+        auto *heading = new QLabel("Gym Leaderboard");
+        heading->setAlignment(Qt::AlignCenter);
+        heading->setStyleSheet("font-weight:900; font-size:18px; color:#ffffff;");
+        lo->addWidget(heading);
+
+        auto *row = new QHBoxLayout;
+        auto *periodLbl = new QLabel("Period:"); periodLbl->setStyleSheet("font-weight:900;"); row->addWidget(periodLbl);
+        boardPeriodCb = new QComboBox; boardPeriodCb->addItems({"This Week","Last Week","This Month","Last Month"}); row->addWidget(boardPeriodCb);
+        auto *metricLbl = new QLabel("Ranked By:"); metricLbl->setStyleSheet("font-weight:900;"); row->addWidget(metricLbl);
+        boardMetricCb = new QComboBox; boardMetricCb->addItems({"Distance","Strength Volume","Workouts","Active Days","Current Streak"}); row->addWidget(boardMetricCb);
+        auto *rb = new QPushButton("Rebuild"); rb->setToolTip("Re-read every member's files and rebuild leaderboard.dat");
+        connect(rb, &QPushButton::clicked, [this]{ rebuildLeaderboard(); }); row->addWidget(rb);
+        lo->addLayout(row);
+        connect(boardPeriodCb, QOverload<int>::of(&QComboBox::currentIndexChanged), [this](int){ refreshLeaderboard(); });
+        connect(boardMetricCb, QOverload<int>::of(&QComboBox::currentIndexChanged), [this](int){ refreshLeaderboard(); });
+
+        boardT = new QTableWidget; boardT->setColumnCount(3);
+        boardT->setHorizontalHeaderLabels({"Rank","Member","Total"});
+        boardT->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+        boardT->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        lo->addWidget(boardT);
+
+        boardInfoLbl = new QLabel("");
+        boardInfoLbl->setAlignment(Qt::AlignCenter);
+        boardInfoLbl->setStyleSheet("font-weight:700; color:#ffffff; font-size:12px;");
+        lo->addWidget(boardInfoLbl);
+
+        boardWatcher = new QFutureWatcher<std::vector<MemberBoardStats>>(this);
+        connect(boardWatcher, &QFutureWatcherBase::finished, [this]{
+            leaderboard.replaceAll(boardWatcher->result());
+            // a save made while the scan was running may have been read before it hit disk
+            if (!user.username.isEmpty()) leaderboard.updateMember(user.username, user.name, cardio, strength);
+            refreshLeaderboard();
+        });
+        return boardPage;
+    }
+
     QWidget* buildProfileTab() {
         auto *w = new QWidget; auto *lo = new QVBoxLayout(w);
 
@@ -992,6 +1486,12 @@ private:
         addBoldLeftLabel("Height (Cm):", 3, 0); editHeight = new QDoubleSpinBox; editHeight->setRange(100,250); g->addWidget(wrapDoubleSpinBox(editHeight), 3, 1);
         addBoldLeftLabel("Age:", 4, 0); editAge = new QSpinBox; editAge->setRange(10,120); g->addWidget(wrapSpinBox(editAge), 4, 1);
         auto *ub = new QPushButton("Update"); connect(ub, &QPushButton::clicked, [this]{ updateProfile(); }); g->addWidget(ub, 5, 0, 1, 2);
+        auto *rb = new QPushButton("Recalculate Calories");
+        rb->setToolTip("Recompute every workout's calories from the bodyweight logged on or before its date");
+        connect(rb, &QPushButton::clicked, [this]{ recalcCalories(); }); g->addWidget(rb, 6, 0, 1, 2);
+        encryptBtn = new QPushButton("Encrypt My Data Files");
+        encryptBtn->setToolTip("Encrypt your workout files with a key derived from your password");
+        connect(encryptBtn, &QPushButton::clicked, [this]{ toggleEncryption(); }); g->addWidget(encryptBtn, 7, 0, 1, 2);
         lo->addWidget(pg);
 
         // BMI group centered & bold
@@ -1010,8 +1510,6 @@ private:
     }
 
     // Helpers: file/user storage
-    QString hash(const QString &s) { return QString(QCryptographicHash::hash(s.toUtf8(), QCryptographicHash::Sha256).toHex()); }
-
     bool userExists(const QString &u) {
         QFile f("users.dat");
         if (!f.open(QIODevice::ReadOnly)) return false;
@@ -1021,301 +1519,345 @@ private:
         return false;
     }
 
+    // Accounts still on an unsalted SHA-256 (or a weaker PBKDF2) hash get a new one on their next login
     bool checkLogin(const QString &u, const QString &p) {
         QFile f("users.dat");
         if (!f.open(QIODevice::ReadOnly)) return false;
+        QStringList lines;
         QTextStream in(&f);
-        QString h = hash(p);
-        while (!in.atEnd()) {
-            auto parts = in.readLine().split("|");
-            if (parts.size() >= 3 && parts[0] == u && parts[1] == h) { pName = parts[2]; f.close(); return true; }
-        }
+        while (!in.atEnd()) lines << in.readLine();
         f.close();
+        for (QString &line : lines) {
+            auto parts = line.split("|");
+            bool outdated = false;
+            if (parts.size() < 3 || parts[0] != u || !SecureStore::verifyPassword(p, parts[1], &outdated)) continue;
+            pName = parts[2];
+            if (outdated) {
+                parts[1] = SecureStore::hashPassword(p);
+                line = parts.join("|");
+                QSaveFile out("users.dat");
+                if (out.open(QIODevice::WriteOnly)) {
+                    QTextStream ts(&out);
+                    for (const QString &l : std::as_const(lines)) ts << l << "\n";
+                    ts.flush();
+                    out.commit(); // on failure the old hash stays and the next login tries again
+                }
+            }
+            return true;
+        }
         return false;
     }
 
     void saveUser(const QString &u, const QString &p, const QString &n) {
         QFile f("users.dat");
         f.open(QIODevice::Append);
-        QTextStream(&f) << u << "|" << hash(p) << "|" << n << "\n";
+        QTextStream(&f) << u << "|" << SecureStore::hashPassword(p) << "|" << n << "\n";
         f.close();
     }
 
-    void loadData() {
-        cardio.clear(); strength.clear(); weightLogs.clear(); goals.clear();
+    // Size and mtime of the five per-user files, to tell whether a prefetched copy is still current
+    static QList<qint64> dataStamp(const QString &u) {
+        QList<qint64> stamp;
+        for (const char *prefix : {"profile_", "cardio_", "strength_", "weight_", "goals_"}) {
+            const QFileInfo fi(DatParser::userFilePath(QString(), prefix, u));
+            stamp << (fi.exists() ? fi.lastModified().toMSecsSinceEpoch() : -1) << fi.size();
+        }
+        return stamp;
+    }
+
+    void startPrefetch() {
+        const QString u = logUser->text().trimmed();
+        // encrypted accounts cannot be read before the password is in
+        if (u.isEmpty() || u == prefetchUser || !userExists(u) || SecureStore::hasKey(QString(), u)) return;
+        FT_TRACE_SCOPE("startPrefetch");
+        prefetchUser = u;
+        prefetchStamp = dataStamp(u);
+        // one worker reads the files in turn: nesting loadUserData's own fan-out inside a pool thread could starve
+        prefetch = QtConcurrent::run([u]{ return DatParser::loadUserData(u, QString(), false); });
+    }
+
+    // A running load is left to finish on its own; its result is simply never read
+    void dropPrefetch() {
+        prefetchUser.clear();
+        prefetchStamp.clear();
+        prefetch = QFuture<UserData>();
+    }
+
+    // The prefetched data if it is for `u` and still current (waiting for it if needed), else a fresh load
+    UserData takeUserData(const QString &u) {
+        FT_TRACE_SCOPE("takeUserData");
+        UserData d;
+        if (u == prefetchUser && prefetch.isValid() && dataStamp(u) == prefetchStamp) d = prefetch.result();
+        else d = DatParser::loadUserData(u, QString(), true, dataKey); // all five files parsed concurrently from mapped buffers (see datparser.cpp)
+        dropPrefetch();
+        return d;
+    }
+
+    void loadData(UserData d) {
+        FT_TRACE_SCOPE("loadData");
+        FT_ALLOC_SCOPE("loadData");
+        if (d.hasProfile) { user.gender = d.profile.gender; user.weight = d.profile.weight; user.targetBodyweight = d.profile.targetBodyweight; user.height = d.profile.height; user.age = d.profile.age; }
+        cardio = std::move(d.cardio);
+        strength = std::move(d.strength);
+        weightLogs = std::move(d.weightLogs);
+        weightTrend.rebuild(weightLogs);
+        trainingLoad.rebuild(cardio, strength, QDate::currentDate());
+        goals = std::move(d.goals);
+        records.rebuild(strength);
+        progressSeries = Progress::buildSeries(strength);
+        resetHistoryModels();
+    }
+
+    // False if any file could not be replaced (that file keeps its previous contents)
+    bool saveData() {
+        FT_TRACE_SCOPE("saveData");
+        FT_ALLOC_SCOPE("saveData");
         QString u = user.username;
+        bool ok = true;
+        // each file is formatted into memory, then replaced in one go (sealed while encryption is on,
+        // CRC32C-checked otherwise)
+        auto write = [&](const char *prefix, const std::function<void(QTextStream &)> &fill) {
+            QByteArray bytes;
+            QTextStream ts(&bytes);
+            fill(ts);
+            ts.flush();
+            ok &= DataFile::write(DatParser::userFilePath(QString(), prefix, u), bytes, dataKey, snapshotPending);
+        };
 
-        QFile pf("profile_" + u + ".dat");
-        if (pf.open(QIODevice::ReadOnly)) {
-            auto p = QTextStream(&pf).readLine().split("|");
-            // profile format: gender|weight|targetBodyweight|height|age
-            if (p.size() >= 5) { user.gender = p[0]; user.weight = p[1].toDouble(); user.targetBodyweight = p[2].toDouble(); user.height = p[3].toDouble(); user.age = p[4].toInt(); }
-            pf.close();
-        }
+        write("profile_", [&](QTextStream &po) {
+            po << user.gender << "|" << user.weight << "|" << user.targetBodyweight << "|" << user.height << "|" << user.age << "\n";
+        });
 
-        QFile cf("cardio_" + u + ".dat");
-        if (cf.open(QIODevice::ReadOnly)) {
-            QTextStream in(&cf);
-            while (!in.atEnd()) {
-                auto p = in.readLine().split("|");
-                // Format: date|type|duration|distance|calories|avgSpeed
-                if (p.size() >= 6) {
-                    CardioWorkout w;
-                    w.date = p[0];
-                    w.type = p[1];
-                    w.duration = p[2].toInt();
-                    w.distance = p[3].toDouble();
-                    w.calories = p[4].toDouble();
-                    w.avgSpeed = p[5].toDouble();
-                    cardio.push_back(w);
+        write("cardio_", [&](QTextStream &co) {
+            for (auto &w : cardio) {
+                co << w.date << "|" << w.type << "|" << w.duration << "|" << w.distance << "|" << w.calories << "|" << w.avgSpeed;
+                if (w.elevationGain > 0 || !w.splits.empty() || !w.samples.isEmpty()) {
+                    co << "|" << w.elevationGain << "|";
+                    for (size_t i = 0; i < w.splits.size(); i++) { co << w.splits[i]; if (i < w.splits.size()-1) co << ";"; }
+                    co << "|" << w.samples << "|" << w.heartRate.average << ";" << w.heartRate.maximum;
+                    for (int z : w.heartRate.zoneSeconds) co << ";" << z;
                 }
+                co << "\n";
             }
-            cf.close();
-        }
+        });
 
-        QFile sf("strength_" + u + ".dat");
-        if (sf.open(QIODevice::ReadOnly)) {
-            QTextStream in(&sf);
-            while (!in.atEnd()) {
-                auto p = in.readLine().split("|");
-                // Format: date|calories|exercises
-                if (p.size() >= 3) {
-                    StrengthWorkout w; w.date = p[0]; if (p.size() >= 2) w.calories = p[1].toDouble();
-                    if (p.size() >= 3) {
-                        for (const QString &es : p[2].split(";")) {
-                            auto ep = es.split(":");
-                            if (ep.size() >= 2) {
-                                Exercise ex; ex.name = ep[0];
-                                for (const QString &ss : ep[1].split(",")) {
-                                    auto sp = ss.split("x");
-                                    if (sp.size() >= 2) { ExerciseSet s; s.reps = sp[0].toInt(); s.weight = sp[1].toDouble(); ex.sets.push_back(s); }
-                                }
-                                w.exercises.push_back(ex);
-                            }
-                        }
-                    }
-                    strength.push_back(w);
+        write("strength_", [&](QTextStream &so) {
+            for (auto &w : strength) {
+                so << w.date << "|" << w.calories << "|";
+                for (size_t i = 0; i < w.exercises.size(); i++) {
+                    auto &ex = w.exercises[i];
+                    so << ex.name << ":";
+                    for (size_t j = 0; j < ex.sets.size(); j++) { so << ex.sets[j].reps << "x" << ex.sets[j].weight; if (j < ex.sets.size()-1) so << ","; }
+                    if (i < w.exercises.size()-1) so << ";";
                 }
+                // derived totals ride along as trailing fields; older readers stop at the third
+                so << "|" << QString::number(w.totalVolume, 'f', 2) << "|" << w.setCount << "|" << w.repCount << "|";
+                for (size_t i = 0; i < w.exercises.size(); i++) { so << QString::number(w.exercises[i].volume, 'f', 2); if (i < w.exercises.size()-1) so << ";"; }
+                so << "\n";
             }
-            sf.close();
-        }
+        });
 
-        QFile wf("weight_" + u + ".dat");
-        if (wf.open(QIODevice::ReadOnly)) {
-            QTextStream in(&wf);
-            while (!in.atEnd()) {
-                auto p = in.readLine().split("|");
-                // Format: date|weight
-                if (p.size() >= 2) {
-                    BodyweightLog b; b.date = p[0]; b.weight = p[1].toDouble();
-                    weightLogs.push_back(b);
-                }
+        write("weight_", [&](QTextStream &wout) {
+            for (auto &b : weightLogs) wout << b.date << "|" << b.weight << "\n";
+        });
+
+        write("goals_", [&](QTextStream &go) {
+            for (auto &g : goals) {
+                go << g.name << "|" << g.type << "|" << g.target << "|" << g.progress << "|" << g.targetTime << "|" << g.progressTime << "|"
+                   << g.exerciseName << "|" << g.exWeight << "|" << g.exSets << "|" << g.exReps << "\n";
             }
-            wf.close();
+        });
+        snapshotPending = false;
+        return ok;
+    }
+
+    // Rewrites every sample file of the account from `oldKey` to the current dataKey
+    void rekeySamples(const QByteArray &oldKey) {
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        for (const CardioWorkout &w : cardio) {
+            if (w.samples.isEmpty()) continue;
+            const DataFile::Contents c = DataFile::read(samplePath(w), oldKey);
+            if (c.status == DataFile::Status::Ok) DataFile::write(samplePath(w), c.view.toByteArray(), dataKey, false);
         }
+        QApplication::restoreOverrideCursor();
+    }
 
-        QFile gf("goals_" + u + ".dat");
-        if (gf.open(QIODevice::ReadOnly)) {
-            QTextStream in(&gf);
-            while (!in.atEnd()) {
-                auto p = in.readLine().split("|");
-                if (p.size() >= 10) {
-                    Goal g;
-                    g.name = p[0]; g.type = p[1]; g.target = p[2].toDouble(); g.progress = p[3].toDouble();
-                    g.targetTime = p[4].toInt(); g.progressTime = p[5].toInt();
-                    g.exerciseName = p[6]; g.exWeight = p[7].toDouble(); g.exSets = p[8].toInt(); g.exReps = p[9].toInt();
-                    goals.push_back(g);
-                } else if (p.size() >= 6) {
-                    Goal g; g.name = p[0]; g.type = p[1]; g.target = p[2].toDouble(); g.progress = p[3].toDouble();
-                    g.targetTime = p[4].toInt(); g.progressTime = p[5].toInt();
-                    goals.push_back(g);
-                }
+    // Snapshots in the previous encryption state would be plaintext, or sealed with a key that is gone
+    void dropSnapshots() {
+        for (const char *prefix : {"profile_", "cardio_", "strength_", "weight_", "goals_"})
+            QFile::remove(DataFile::snapshotPath(DatParser::userFilePath(QString(), prefix, user.username)));
+    }
+
+    void dumpTrace() {
+        QString path = QString("fittrack-trace-%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss")), err;
+        if (Tracing::writeChromeTrace(path, &err)) QMessageBox::information(this, "Trace", "Trace written to " + QFileInfo(path).absoluteFilePath());
+        else QMessageBox::warning(this, "Error", "Could not write trace: " + err);
+    }
+
+    void showAllocReport() {
+        QDialog dlg(this);
+        dlg.setWindowTitle("Allocations per action");
+        dlg.resize(760, 460);
+        auto *lo = new QVBoxLayout(&dlg);
+        auto *t = new QTableWidget; t->setColumnCount(6);
+        t->setHorizontalHeaderLabels({"Region","Calls","Allocs/Call","KB/Call","Peak Live KB","Last Allocs"});
+        t->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+        t->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        auto fill = [t] {
+            const auto rs = AllocStats::regions();
+            t->setRowCount((int)rs.size());
+            for (size_t i = 0; i < rs.size(); ++i) {
+                const auto &r = rs[i];
+                const double calls = qMax<quint64>(1, r.calls);
+                t->setItem((int)i, 0, new QTableWidgetItem(r.name));
+                t->setItem((int)i, 1, new QTableWidgetItem(QString::number(r.calls)));
+                t->setItem((int)i, 2, new QTableWidgetItem(QString::number(r.allocs / calls, 'f', 0)));
+                t->setItem((int)i, 3, new QTableWidgetItem(QString::number(r.bytes / calls / 1024.0, 'f', 1)));
+                t->setItem((int)i, 4, new QTableWidgetItem(QString::number(r.maxPeak / 1024.0, 'f', 1)));
+                t->setItem((int)i, 5, new QTableWidgetItem(QString::number(r.lastAllocs)));
             }
-            gf.close();
-        }
+        };
+        fill();
+        lo->addWidget(t);
+
+        auto *btns = new QHBoxLayout; btns->setAlignment(Qt::AlignCenter);
+        auto *saveBtn = new QPushButton("Save CSV");
+        connect(saveBtn, &QPushButton::clicked, [&dlg]{
+            QString path = QFileDialog::getSaveFileName(&dlg, "Save allocation report", "fittrack-allocs.csv", "CSV (*.csv)"), err;
+            if (!path.isEmpty() && !AllocStats::writeReport(path, &err)) QMessageBox::warning(&dlg, "Error", "Could not write report: " + err);
+        });
+        auto *resetBtn = new QPushButton("Reset");
+        connect(resetBtn, &QPushButton::clicked, [fill]{ AllocStats::reset(); fill(); });
+        auto *closeBtn = new QPushButton("Close");
+        connect(closeBtn, &QPushButton::clicked, &dlg, &QDialog::accept);
+        btns->addWidget(saveBtn); btns->addWidget(resetBtn); btns->addWidget(closeBtn);
+        lo->addLayout(btns);
+        dlg.exec();
     }
 
-    void saveData() {
-        QString u = user.username;
-        QFile pf("profile_" + u + ".dat"); pf.open(QIODevice::WriteOnly);
-        QTextStream(&pf) << user.gender << "|" << user.weight << "|" << user.targetBodyweight << "|" << user.height << "|" << user.age << "\n";
-        pf.close();
-
-        QFile cf("cardio_" + u + ".dat"); cf.open(QIODevice::WriteOnly);
-        QTextStream co(&cf);
-        for (auto &w : cardio) co << w.date << "|" << w.type << "|" << w.duration << "|" << w.distance << "|" << w.calories << "|" << w.avgSpeed << "\n";
-        cf.close();
-
-        QFile sf("strength_" + u + ".dat"); sf.open(QIODevice::WriteOnly);
-        QTextStream so(&sf);
-        for (auto &w : strength) {
-            so << w.date << "|" << w.calories << "|";
-            for (size_t i = 0; i < w.exercises.size(); i++) {
-                auto &ex = w.exercises[i];
-                so << ex.name << ":";
-                for (size_t j = 0; j < ex.sets.size(); j++) { so << ex.sets[j].reps << "x" << ex.sets[j].weight; if (j < ex.sets.size()-1) so << ","; }
-                if (i < w.exercises.size()-1) so << ";";
+    // Leaderboard: the journal is read once, then kept current by publishToLeaderboard()
+    void refreshLeaderboard() {
+        FT_TRACE_SCOPE("refreshLeaderboard");
+        FT_ALLOC_SCOPE("refreshLeaderboard");
+        if (!boardT || (boardWatcher && boardWatcher->isRunning())) return;
+        if (!leaderboard.isLoaded() && !leaderboard.load()) { rebuildLeaderboard(); return; } // first run: no leaderboard.dat yet
+
+        const BoardMetric metric = static_cast<BoardMetric>(boardMetricCb->currentIndex());
+        const BoardPeriod period = static_cast<BoardPeriod>(boardPeriodCb->currentIndex());
+        int myRank = 0;
+        const std::vector<BoardEntry> rows = leaderboard.top(metric, period, QDate::currentDate(), 25, user.username, &myRank);
+        boardT->setRowCount((int)rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const BoardEntry &e = rows[i];
+            QString value;
+            switch (metric) {
+            case BoardMetric::Distance: value = QString::number(e.value, 'f', 1) + " km"; break;
+            case BoardMetric::Volume: value = QString::number((int)e.value) + " kg"; break;
+            case BoardMetric::Workouts: value = QString::number((int)e.value); break;
+            case BoardMetric::ActiveDays:
+            case BoardMetric::Streak: value = QString::number((int)e.value) + ((int)e.value == 1 ? " day" : " days"); break;
             }
-            so << "\n";
+            boardT->setItem((int)i, 0, new QTableWidgetItem(QString::number(i + 1)));
+            boardT->setItem((int)i, 1, new QTableWidgetItem(e.name.isEmpty() ? e.username : e.name));
+            boardT->setItem((int)i, 2, new QTableWidgetItem(value));
+            if (e.username == user.username)
+                for (int c = 0; c < 3; ++c) boardT->item((int)i, c)->setForeground(QColor("#FFB86B"));
         }
-        sf.close();
-
-        QFile wf("weight_" + u + ".dat"); wf.open(QIODevice::WriteOnly);
-        QTextStream wout(&wf);
-        for (auto &b : weightLogs) wout << b.date << "|" << b.weight << "\n";
-        wf.close();
-
-        QFile gf("goals_" + u + ".dat"); gf.open(QIODevice::WriteOnly);
-        QTextStream go(&gf);
-        for (auto &g : goals) {
-            go << g.name << "|" << g.type << "|" << g.target << "|" << g.progress << "|" << g.targetTime << "|" << g.progressTime << "|"
-               << g.exerciseName << "|" << g.exWeight << "|" << g.exSets << "|" << g.exReps << "\n";
-        }
-        gf.close();
+        boardInfoLbl->setText(QString("%1 members • your rank: %2").arg(leaderboard.memberCount()).arg(myRank > 0 ? QString("#%1").arg(myRank) : QString("--")));
+    }
+
+    void rebuildLeaderboard() {
+        if (!boardWatcher || boardWatcher->isRunning()) return;
+        boardInfoLbl->setText("Rebuilding leaderboard from all members...");
+        boardWatcher->setFuture(QtConcurrent::run([]{ return Leaderboard::scanAll(QString()); }));
+    }
+
+    // Called after every save that changes cardio or strength history
+    void publishToLeaderboard() {
+        leaderboard.updateMember(user.username, user.name, cardio, strength);
+        if (boardPage && boardPage->isVisible()) refreshLeaderboard();
     }
 
     // Utility calculators
-    double calcCardioCal(const QString &t, int d) {
-        double met = t == "Running" ? 9.8 : (t == "Swimming" ? 8.0 : (t == "Walking" ? 3.5 : 7.5));
-        return met * (user.weight > 0 ? user.weight : 70) * (d / 60.0);
-    }
-
-    double calcStrCal(double v) { return 5.0 * (user.weight > 0 ? user.weight : 70) * 0.15 + v * 0.01; }
-
-    // Refresh UI (tables, dashboard, profile)
-    void refresh() {
-        // Aggregate weekly values and per-day arrays for charts
-        QDate today = QDate::currentDate();
-        QDate wkAgo = today.addDays(-6); // include today, last 7 days (6 days ago..today)
-
-        QVector<double> cardioPerDay(7, 0.0);     // index 0 = 6 days ago, 6 = today
-        QVector<double> strengthPerDay(7, 0.0);
-        QVector<double> weightPerDay(7, 0.0);
-
-        double cardioKmWeek = 0.0;
-        double cardioCaloriesWeek = 0.0;
-        for (auto &w : cardio) {
-            QDate d = QDate::fromString(w.date, "yyyy-MM-dd");
-            if (!d.isValid()) continue;
-            int days = d.daysTo(today); // days from that day to today (0 = today)
-            if (days >= 0 && days < 7) {
-                int idx = 6 - days;
-                cardioPerDay[idx] += w.distance;
-            }
-            if (d >= wkAgo && d <= today) {
-                cardioKmWeek += w.distance;
-                cardioCaloriesWeek += w.calories;
-            }
-        }
+    double calcCardioCal(const QString &t, int d) { return Calories::cardio(t, user.weight > 0 ? user.weight : Calories::DefaultWeightKg, d); }
 
-        int strengthWorkoutsWeek = 0;
-        double strengthVolumeWeek = 0.0;
-        double strengthCaloriesWeek = 0.0;
-        for (auto &w : strength) {
-            QDate d = QDate::fromString(w.date, "yyyy-MM-dd");
-            if (!d.isValid()) continue;
-            int days = d.daysTo(today);
-            if (days >= 0 && days < 7) {
-                int idx = 6 - days;
-                double vol = 0;
-                for (auto &e : w.exercises) for (auto &s : e.sets) vol += s.reps * s.weight;
-                strengthPerDay[idx] += vol; // per-day volume (kg)
-            }
-            if (d >= wkAgo && d <= today) {
-                strengthWorkoutsWeek++;
-                for (auto &e : w.exercises) for (auto &s : e.sets) strengthVolumeWeek += s.reps * s.weight;
-                strengthCaloriesWeek += w.calories;
-            }
-        }
+    double calcStrCal(double v) { return Calories::strength(user.weight > 0 ? user.weight : Calories::DefaultWeightKg, v); }
 
-        // Bodyweight: build a map date->weight for quick lookup, then fill last 7 days
-        QMap<QDate,double> weightByDate;
-        for (auto &b : weightLogs) {
-            QDate d = QDate::fromString(b.date, "yyyy-MM-dd");
-            if (!d.isValid()) continue;
-            weightByDate[d] = b.weight; // overwrite ensures latest for that date
-        }
-        for (int i = 0; i < 7; ++i) {
-            QDate d = today.addDays(i - 6); // i=0 => 6 days ago, i=6 => today
-            if (weightByDate.contains(d)) weightPerDay[i] = weightByDate[d];
-            else weightPerDay[i] = 0.0;
-        }
+    // Marks views stale and recomputes the visible ones now; history tables update through their models
+    void invalidate(unsigned views) {
+        staleViews |= views;
+        flushStaleViews();
+    }
+
+    void flushStaleViews() {
+        if (!staleViews) return;
+        unsigned due = 0;
+        for (auto it = viewPages.cbegin(); it != viewPages.cend(); ++it)
+            if ((staleViews & it.key()) && it.value()->isVisible()) due |= it.key();
+        if (!due) return;
+        FT_TRACE_SCOPE("flushStaleViews");
+        FT_ALLOC_SCOPE("flushStaleViews");
+        staleViews &= ~due;
+        if (due & ViewDashboard) refreshDashboard();
+        if (due & ViewGoals) refreshGoals();
+        if (due & ViewRecords) refreshRecords();
+        if (due & ViewProgress) refreshProgress();
+        if (due & ViewWeight) refreshWeightTrend(false);
+        if (due & ViewProfile) refreshProfile();
+        if (due & ViewCalendar) refreshHeatmap();
+        if (due & ViewReports) refreshReports();
+    }
+
+    void refreshDashboard() {
+        FT_TRACE_SCOPE("refreshDashboard");
+        // Aggregate weekly values and per-day arrays for charts (shared with the batch report)
+        const WeeklySummary ws = computeWeeklySummary(user, cardio, strength, weightLogs, goals, QDate::currentDate());
 
         // Update cardio widgets
-        if (cardioWeeklyLbl) {
-            double sumKm = 0.0;
-            for (double v : cardioPerDay) sumKm += v;
-            cardioWeeklyLbl->setText(QString("%1 km").arg(sumKm, 0, 'f', 1));
-        }
-        double cardioTarget = 20.0;
-        for (auto &g : goals) if (g.type == "cardio_km") cardioTarget = g.target > 0 ? g.target : cardioTarget;
-        double cardioSum = 0;
-        for (double v : cardioPerDay) cardioSum += v;
-        int cardioPct = cardioTarget > 0 ? qBound(0, (int)qRound(cardioSum * 100.0 / cardioTarget), 100) : 0;
-        if (cGoalBar) { cGoalBar->setValue(cardioPct); cGoalBar->setFormat(QString("%1%").arg(cardioPct)); }
-        if (cardioWeeklySub) cardioWeeklySub->setText(QString("%1 km in last 7d • target %2 km").arg(QString::number(cardioSum, 'f', 1)).arg(cardioTarget,0,'f',1));
+        if (cardioWeeklyLbl) cardioWeeklyLbl->setText(QString("%1 km").arg(ws.cardioKmWeek, 0, 'f', 1));
+        if (cGoalBar) { cGoalBar->setValue(ws.cardioPct); cGoalBar->setFormat(QString("%1%").arg(ws.cardioPct)); }
+        if (cardioWeeklySub) cardioWeeklySub->setText(QString("%1 km in last 7d • target %2 km").arg(QString::number(ws.cardioKmWeek, 'f', 1)).arg(ws.cardioTarget,0,'f',1));
 
         // Update strength widgets
-        if (strengthWeeklyLbl) strengthWeeklyLbl->setText(QString("%1").arg(strengthWorkoutsWeek));
-        int strengthTarget = 3;
-        for (auto &g : goals) if (g.type == "strength_exercise") { strengthTarget = qMax(1, g.target > 0 ? (int)g.target : strengthTarget); }
-        int strengthPct = strengthTarget > 0 ? qBound(0, (int)qRound((strengthWorkoutsWeek * 100.0) / (double)strengthTarget), 100) : 0;
-        if (sGoalBar) { sGoalBar->setValue(strengthPct); sGoalBar->setFormat(QString("%1%").arg(strengthPct)); }
+        if (strengthWeeklyLbl) strengthWeeklyLbl->setText(QString("%1").arg(ws.strengthWorkoutsWeek));
+        if (sGoalBar) { sGoalBar->setValue(ws.strengthPct); sGoalBar->setFormat(QString("%1%").arg(ws.strengthPct)); }
         if (strengthWeeklySub) strengthWeeklySub->setText(QString("%1/%2 workouts • %3 kg vol")
-                                           .arg(strengthWorkoutsWeek)
-                                           .arg(strengthTarget)
-                                           .arg((int)strengthVolumeWeek));
+                                           .arg(ws.strengthWorkoutsWeek)
+                                           .arg(ws.strengthTarget)
+                                           .arg((int)ws.strengthVolumeWeek));
 
         // Update bodyweight widgets
-        double currentWeight = user.weight > 0 ? user.weight : (weightLogs.empty() ? 0.0 : weightLogs.back().weight);
         if (bwCurrentLbl) {
-            if (currentWeight > 0) bwCurrentLbl->setText(QString("%1 kg").arg(currentWeight,0,'f',1));
+            if (ws.currentWeight > 0) bwCurrentLbl->setText(QString("%1 kg").arg(ws.currentWeight,0,'f',1));
             else bwCurrentLbl->setText("-- kg");
         }
 
         // update charts
-        if (cardioChart) cardioChart->setData(cardioPerDay);
-        if (strengthChart) strengthChart->setData(strengthPerDay);
-        if (bwChart) bwChart->setData(weightPerDay); // <-- bodyweight chart shows daily weights over last 7 days
+        if (cardioChart) cardioChart->setData(ws.cardioPerDay);
+        if (strengthChart) strengthChart->setData(ws.strengthPerDay);
+        if (bwChart) {
+            // days without a weigh-in show the smoothed trend instead of an empty bar
+            QVector<double> bw = ws.weightPerDay;
+            for (int i = 0; i < bw.size(); ++i) if (bw[i] <= 0) bw[i] = weightTrend.trendAt(QDate::currentDate().addDays(i - 6));
+            bwChart->setData(bw);
+        }
+        refreshWeightTrend(true);
+        refreshTrainingLoad();
 
         // populate small stats and tables
-        double cd = 0, cc = 0;
-        for (auto &w : cardio) { cd += w.distance; cc += w.calories; }
         if (!cCnt) cCnt = new QLabel; if (!cDist) cDist = new QLabel; if (!cCal) cCal = new QLabel;
-        cCnt->setText(QString::number(cardio.size()));
-        cDist->setText(QString::number(cd, 'f', 1));
-        cCal->setText(QString::number((int)cc));
+        cCnt->setText(QString::number(ws.cardioCount));
+        cDist->setText(QString::number(ws.cardioKmTotal, 'f', 1));
+        cCal->setText(QString::number((int)ws.cardioCaloriesTotal));
 
-        double sv = 0, sc = 0;
-        for (auto &w : strength) { sc += w.calories; for (auto &e : w.exercises) for (auto &s : e.sets) sv += s.reps * s.weight; }
         if (!sCnt) sCnt = new QLabel; if (!sVol) sVol = new QLabel; if (!sCal) sCal = new QLabel;
-        sCnt->setText(QString::number(strength.size()));
-        sVol->setText(QString::number((int)sv));
-        sCal->setText(QString::number((int)sc));
-
-        cardioT->setRowCount((int)cardio.size());
-        for (size_t i = 0; i < cardio.size(); i++) {
-            auto &w = cardio[i];
-            cardioT->setItem((int)i, 0, new QTableWidgetItem(w.date));
-            cardioT->setItem((int)i, 1, new QTableWidgetItem(w.type));
-            cardioT->setItem((int)i, 2, new QTableWidgetItem(QString::number(w.duration) + " min"));
-            cardioT->setItem((int)i, 3, new QTableWidgetItem(QString::number(w.distance, 'f', 2) + " km"));
-            cardioT->setItem((int)i, 4, new QTableWidgetItem(QString::number(w.avgSpeed, 'f', 2) + " km/h"));
-            cardioT->setItem((int)i, 5, new QTableWidgetItem(QString::number((int)w.calories) + " cal"));
-        }
-
-        strT->setRowCount((int)strength.size());
-        for (size_t i = 0; i < strength.size(); i++) {
-            auto &w = strength[i];
-            int ts = 0, tr = 0; double tv = 0;
-            for (auto &e : w.exercises) { ts += (int)e.sets.size(); for (auto &s : e.sets) { tr += s.reps; tv += s.reps * s.weight; } }
-            strT->setItem((int)i, 0, new QTableWidgetItem(w.date));
-            strT->setItem((int)i, 1, new QTableWidgetItem(QString::number(w.exercises.size())));
-            strT->setItem((int)i, 2, new QTableWidgetItem(QString::number(ts)));
-            strT->setItem((int)i, 3, new QTableWidgetItem(QString::number(tr)));
-            strT->setItem((int)i, 4, new QTableWidgetItem(QString::number((int)tv) + " kg"));
-        }
+        sCnt->setText(QString::number(ws.strengthCount));
+        sVol->setText(QString::number((int)ws.strengthVolumeTotal));
+        sCal->setText(QString::number((int)ws.strengthCaloriesTotal));
+    }
 
+    void refreshGoals() {
+        FT_TRACE_SCOPE("refreshGoals");
         goalsT->setRowCount((int)goals.size());
         for (size_t i = 0; i < goals.size(); i++) {
             auto &g = goals[i];
@@ -1337,19 +1879,37 @@ private:
                 goalsT->setItem((int)i, 4, new QTableWidgetItem("--"));
             }
 
-            int pct = g.target > 0 ? qMin(100, (int)(g.progress * 100 / g.target)) : 0;
-            auto *bar = new QProgressBar; bar->setValue(pct);
-            bar->setFormat(pct >= 100 ? "Done" : QString("%1%").arg(pct));
+            const GoalStatus st = goalStatus(g);
+            auto *bar = new QProgressBar; bar->setValue(st.pct);
+            bar->setFormat(st.done ? "Done" : QString("%1%").arg(st.pct));
             goalsT->setCellWidget((int)i, 5, bar);
         }
+    }
 
-        weightT->setRowCount((int)weightLogs.size());
-        for (size_t i = 0; i < weightLogs.size(); ++i) {
-            weightT->setItem((int)i, 0, new QTableWidgetItem(weightLogs[i].date));
-            weightT->setItem((int)i, 1, new QTableWidgetItem(QString::number(weightLogs[i].weight, 'f', 1) + " kg"));
+    void refreshRecords() {
+        FT_TRACE_SCOPE("refreshRecords");
+        // personal records: each cell is the best mark of an ordered index, no history scan
+        const auto prs = records.all();
+        recordsT->setRowCount((int)prs.size());
+        auto markText = [](const PrMark *m, const QString &unit) {
+            return m ? QString("%1 %2 (%3)").arg(m->value, 0, 'f', 1).arg(unit, m->date) : QString("--");
+        };
+        for (size_t i = 0; i < prs.size(); ++i) {
+            const ExerciseRecords &r = *prs[i];
+            QStringList reps; // best reps at the three heaviest weights
+            for (auto it = r.repsAtWeight.rbegin(); it != r.repsAtWeight.rend() && reps.size() < 3; ++it)
+                reps << QString("%1 @ %2 kg").arg((int)it->second.rbegin()->value).arg(it->first);
+            recordsT->setItem((int)i, 0, new QTableWidgetItem(r.name));
+            recordsT->setItem((int)i, 1, new QTableWidgetItem(markText(ExerciseRecords::best(r.heaviest), "kg")));
+            recordsT->setItem((int)i, 2, new QTableWidgetItem(reps.isEmpty() ? QString("--") : reps.join(", ")));
+            recordsT->setItem((int)i, 3, new QTableWidgetItem(markText(ExerciseRecords::best(r.epley), "kg")));
+            recordsT->setItem((int)i, 4, new QTableWidgetItem(markText(ExerciseRecords::best(r.brzycki), "kg")));
+            recordsT->setItem((int)i, 5, new QTableWidgetItem(markText(ExerciseRecords::best(r.sessionVolume), "kg")));
         }
+    }
 
-        // update profile fields & BMI
+    void refreshProfile() {
+        // profile fields & BMI
         editGender->setCurrentIndex(user.gender == "Female" ? 1 : (user.gender == "Other" ? 2 : 0));
         editWeight->setValue(user.weight > 0 ? user.weight : 70);
         editTargetBodyweight->setValue(user.targetBodyweight > 0 ? user.targetBodyweight : (user.weight>0?user.weight:70));
@@ -1359,13 +1919,226 @@ private:
         bmiLbl->setText(bmi > 0 ? QString::number(bmi, 'f', 1) : "--");
         QString cat = "N/A"; if (bmi > 0) { if (bmi < 18.5) cat = "Underweight"; else if (bmi < 25) cat = "Normal"; else if (bmi < 30) cat = "Overweight"; else cat = "Obese"; }
         bmiCat->setText("Category: " + cat);
+        encryptBtn->setText(dataKey.isEmpty() ? "Encrypt My Data Files" : "Stop Encrypting My Data Files");
+    }
 
-        // update welcome
-        userLbl->setText(user.name);
-        welLblMain->setText("Welcome");
+    // Bodyweight trend: the dashboard card's sub-label, or the Bodyweight tab's chart and goal forecast
+    void refreshWeightTrend(bool card) {
+        if (weightTrend.isEmpty()) {
+            if (card && bwTrendSub) bwTrendSub->setText("");
+            if (!card && bwForecastLbl) bwForecastLbl->setText("");
+            if (!card && bwHistoryChart) bwHistoryChart->setData({}, {}, {}, LinearFit(), -1, QString());
+            return;
+        }
+        const double rate = weightTrend.ratePerWeek();
+        QString forecast;
+        if (user.targetBodyweight > 0) {
+            const QDate eta = weightTrend.projectedDate(user.targetBodyweight);
+            forecast = eta.isValid() ? QString("%1 kg by %2").arg(user.targetBodyweight, 0, 'f', 1).arg(eta.toString("yyyy-MM-dd"))
+                                     : QString("%1 kg: not on current trend").arg(user.targetBodyweight, 0, 'f', 1);
+        }
+        const QString rateText = QString("%1%2 kg/wk").arg(rate >= 0 ? "+" : "").arg(rate, 0, 'f', 2);
+        if (card) {
+            if (bwTrendSub) bwTrendSub->setText(QString("trend %1 kg • %2%3").arg(weightTrend.trend(), 0, 'f', 1).arg(rateText)
+                                                .arg(forecast.isEmpty() ? QString() : " • goal " + forecast));
+            return;
+        }
+        if (bwForecastLbl) bwForecastLbl->setText(QString("Trend %1 kg • %2 over the last %3 days%4")
+                                                  .arg(weightTrend.trend(), 0, 'f', 1).arg(rateText).arg(WeightTrend::WindowDays)
+                                                  .arg(forecast.isEmpty() ? QString() : " • goal " + forecast));
+        if (bwHistoryChart) {
+            const auto &h = weightTrend.history();
+            std::vector<double> x(h.size()), y(h.size()), t(h.size());
+            for (size_t i = 0; i < h.size(); ++i) { x[i] = double(h[i].day); y[i] = h[i].weight; t[i] = h[i].trend; }
+            bwHistoryChart->setData(std::move(x), std::move(y), std::move(t), weightTrend.fit(), weightTrend.windowStart(), "Bodyweight (kg)");
+        }
+    }
+
+    void refreshTrainingLoad() {
+        if (!loadLbl) return;
+        const QDate today = QDate::currentDate();
+        trainingLoad.extendTo(today); // rest days since the last workout still decay the curves
+        const LoadState st = trainingLoad.at(today);
+        const LoadRisk risk = TrainingLoad::risk(st);
+        QVector<double> perDay(7, 0.0);
+        for (int i = 0; i < 7; ++i) perDay[i] = trainingLoad.loadOn(today.addDays(i - 6));
+        if (loadChart) loadChart->setData(perDay);
+
+        if (risk == LoadRisk::None) {
+            loadLbl->setText("--");
+            loadLbl->setStyleSheet("font-size:30px; font-weight:900; color:#FFB86B;");
+            loadBar->setValue(0); loadBar->setFormat("building baseline");
+            loadSub->setText(QString("acute %1 • chronic %2 • log a few weeks for a ratio").arg(st.acute(), 0, 'f', 0).arg(st.chronic(), 0, 'f', 0));
+            return;
+        }
+        const double acwr = st.acwr();
+        const char *color = risk == LoadRisk::High ? "#FF4D4D" : (risk == LoadRisk::Caution ? "#FFD24D" : "#FFB86B");
+        loadLbl->setText(QString::number(acwr, 'f', 2));
+        loadLbl->setStyleSheet(QString("font-size:30px; font-weight:900; color:%1;").arg(color));
+        loadBar->setValue(qBound(0, (int)qRound(acwr * 50), 100));
+        loadBar->setFormat(risk == LoadRisk::High ? "High injury risk" : risk == LoadRisk::Caution ? "Caution"
+                           : risk == LoadRisk::Optimal ? "Optimal" : "Undertraining");
+        QString sub = QString("acute %1 • chronic %2 • form %3%4").arg(st.acute(), 0, 'f', 0).arg(st.chronic(), 0, 'f', 0)
+                          .arg(st.form() >= 0 ? "+" : "").arg(st.form(), 0, 'f', 0);
+        if (risk == LoadRisk::High) sub = QString("Load spike: this week is %1x your 4-week base - ease off • ").arg(acwr, 0, 'f', 1) + sub;
+        loadSub->setText(sub);
+    }
+
+    // Calendar tab: one cell per day from the first workout through today
+    void refreshHeatmap() {
+        FT_TRACE_SCOPE("refreshHeatmap");
+        if (!heatmap) return;
+        const int metric = heatmapMetricCb->currentIndex();
+        qint64 lo = QDate::currentDate().toJulianDay(), hi = lo;
+        auto span = [&](const QString &date) {
+            const QDate d = QDate::fromString(date, "yyyy-MM-dd");
+            if (d.isValid()) { lo = qMin(lo, d.toJulianDay()); hi = qMax(hi, d.toJulianDay()); }
+        };
+        if (metric != 1) for (auto &w : cardio) span(w.date);
+        if (metric != 0) for (auto &w : strength) span(w.date);
+
+        std::vector<double> v(size_t(hi - lo + 1), 0.0);
+        auto add = [&](const QString &date, double x) {
+            const QDate d = QDate::fromString(date, "yyyy-MM-dd");
+            if (d.isValid()) v[size_t(d.toJulianDay() - lo)] += x;
+        };
+        if (metric == 0) for (auto &w : cardio) add(w.date, w.distance);
+        else if (metric == 1) for (auto &w : strength) add(w.date, w.totalVolume);
+        else for (qint64 d = lo; d <= hi; ++d) v[size_t(d - lo)] = trainingLoad.loadOn(QDate::fromJulianDay(d));
+        heatmap->setData(lo, std::move(v), hi, metric == 0 ? "km" : metric == 1 ? "kg" : "load");
+    }
+
+    // Keeps the calendar in step with one saved (+) or deleted (-) workout: only that month's tile redraws
+    void heatmapAdd(const QString &date, double km, double kg) {
+        if (!heatmap || (staleViews & ViewCalendar)) return; // rebuilt in full when next shown
+        const QDate d = QDate::fromString(date, "yyyy-MM-dd");
+        if (!d.isValid()) return;
+        const qint64 jd = d.toJulianDay();
+        switch (heatmapMetricCb->currentIndex()) {
+        case 0: if (km != 0) heatmap->setDay(jd, heatmap->valueAt(jd) + km); break;
+        case 1: if (kg != 0) heatmap->setDay(jd, heatmap->valueAt(jd) + kg); break;
+        default: heatmap->setDay(jd, trainingLoad.loadOn(d)); break;
+        }
+    }
+
+    // Reports tab: the worker reads a snapshot of the data (an O(1) copy of the persistent vectors), so
+    // saves made meanwhile cannot race it; they mark the view stale and the next refresh cancels this run
+    void refreshReports() {
+        FT_TRACE_SCOPE("refreshReports");
+        if (!reportWatcher) return;
+        reportWatcher->cancel();
+        auto snap = std::make_shared<const ReportSnapshot>(ReportSnapshot{cardio, strength, weightLogs});
+        const QDate to = QDate::currentDate();
+        const QDate from = Reports::rangeStart(static_cast<Reports::Range>(reportRangeCb->currentIndex()), *snap, to);
+        reportInfoLbl->setText("Computing...");
+        reportPdfBtn->setEnabled(false);
+        reportWatcher->setFuture(QtConcurrent::run([snap, from, to](QPromise<ReportData> &promise) {
+            ReportData d;
+            if (Reports::compute(*snap, from, to, d, [&promise]{ return promise.isCanceled(); }))
+                promise.addResult(std::move(d));
+        }));
+    }
+
+    void showReport(const ReportData &d) {
+        FT_TRACE_SCOPE("showReport");
+        int sessions = 0, workouts = 0;
+        reportMonthsT->setRowCount((int)d.months.size());
+        for (size_t i = 0; i < d.months.size(); ++i) {
+            const MonthSummary &m = d.months[d.months.size() - 1 - i]; // newest first
+            const int r = (int)i;
+            reportMonthsT->setItem(r, 0, new QTableWidgetItem(m.month.toString("MMM yyyy")));
+            reportMonthsT->setItem(r, 1, new QTableWidgetItem(QString::number(m.cardioSessions)));
+            reportMonthsT->setItem(r, 2, new QTableWidgetItem(QString::number(m.cardioKm, 'f', 1)));
+            reportMonthsT->setItem(r, 3, new QTableWidgetItem(QString::number(m.cardioMinutes)));
+            reportMonthsT->setItem(r, 4, new QTableWidgetItem(QString::number(m.strengthWorkouts)));
+            reportMonthsT->setItem(r, 5, new QTableWidgetItem(QString::number(m.strengthVolume, 'f', 0)));
+            reportMonthsT->setItem(r, 6, new QTableWidgetItem(QString::number(m.cardioKcal + m.strengthKcal, 'f', 0)));
+            reportMonthsT->setItem(r, 7, new QTableWidgetItem(m.weighIns ? QString::number(m.avgWeight, 'f', 1) : QString("--")));
+            sessions += m.cardioSessions; workouts += m.strengthWorkouts;
+        }
+
+        QStringList labels; QVector<double> values;
+        for (const ActivityShare &a : d.activities) { labels << a.type; values << a.minutes; }
+        reportShareChart->setData(labels, values, "min");
+        labels.clear(); values.clear();
+        for (const ExerciseVolume &e : d.exercises) { labels << e.name; values << e.volume; }
+        reportVolumeChart->setData(labels, values, "kg");
+        reportWeightChart->setData(d.weightDay, d.weight, d.weightAvg, d.weightFit, 0, "Bodyweight (kg)");
+
+        reportInfoLbl->setText(QString("%1 - %2 • %3 cardio sessions • %4 strength workouts")
+                                   .arg(d.from.toString("MMM yyyy"), d.to.toString("MMM yyyy")).arg(sessions).arg(workouts));
+        shownReport = d;
+        reportPdfBtn->setEnabled(canExportReport());
+    }
+
+    // A member is logged in, a report is on screen and no export is running
+    bool canExportReport() const { return !user.username.isEmpty() && !shownReport.months.empty() && !pdfWatcher->isRunning(); }
+
+    // Paints the shown report into a PDF on a worker; the tab stays usable meanwhile
+    void exportReportPdf() {
+        if (pdfWatcher->isRunning()) return;
+        const QString suggested = QString("%1_report_%2.pdf").arg(user.username, QDate::currentDate().toString("yyyy-MM-dd"));
+        const QString path = QFileDialog::getSaveFileName(this, "Export Report", QDir::home().filePath(suggested), "PDF files (*.pdf)");
+        if (path.isEmpty()) return;
+        FT_TRACE_SCOPE("exportReportPdf");
+        PdfReportInput in{user, shownReport, goals, QDate::currentDate()};
+        reportPdfBtn->setEnabled(false);
+        reportPdfBtn->setText("Exporting...");
+        pdfWatcher->setFuture(QtConcurrent::run([in = std::move(in), path]{
+            QString error;
+            return PdfReport::write(in, path, &error) ? QString() : error;
+        }));
+    }
+
+    // Progress tab: per-exercise trends over the whole strength history
+
+    void refreshProgress() {
+        FT_TRACE_SCOPE("refreshProgress");
+        if (!progressT) return;
+        const ProgressMetric metric = static_cast<ProgressMetric>(progressMetricCb->currentIndex());
+        const QString unit = "kg"; // every metric is a load
+        const int keep = progressT->currentRow();
+        QSignalBlocker block(progressT);
+        progressT->setRowCount((int)progressSeries.size());
+        for (size_t i = 0; i < progressSeries.size(); ++i) {
+            const Trend t = Progress::analyze(progressSeries[i], metric);
+            QString status = "--";
+            if (t.sessions >= 2) {
+                if (t.plateau) status = "Plateau";
+                else if (t.pctPerMonth > 1.0) status = "Progressing";
+                else if (t.pctPerMonth < -1.0) status = "Declining";
+                else status = "Steady";
+            }
+            progressT->setItem((int)i, 0, new QTableWidgetItem(progressSeries[i].name));
+            progressT->setItem((int)i, 1, new QTableWidgetItem(QString::number(t.sessions)));
+            progressT->setItem((int)i, 2, new QTableWidgetItem(QString::number(t.latest, 'f', 1) + " " + unit));
+            progressT->setItem((int)i, 3, new QTableWidgetItem(QString::number(t.movingAvg, 'f', 1) + " " + unit));
+            progressT->setItem((int)i, 4, new QTableWidgetItem(QString("%1%2 %3").arg(t.slopePerWeek >= 0 ? "+" : "").arg(t.slopePerWeek, 0, 'f', 2).arg(unit)));
+            auto *st = new QTableWidgetItem(status);
+            if (t.plateau) st->setForeground(QColor("#FFB86B"));
+            progressT->setItem((int)i, 5, st);
+        }
+        const int row = (keep >= 0 && keep < (int)progressSeries.size()) ? keep : (progressSeries.empty() ? -1 : 0);
+        if (row >= 0) progressT->setCurrentCell(row, 0);
+        showProgressChart(row);
+    }
+
+    void showProgressChart(int r) {
+        if (!progressChart) return;
+        if (r < 0 || r >= (int)progressSeries.size()) { progressChart->setData({}, {}, {}, LinearFit(), -1, QString()); return; }
+        const ExerciseSeries &s = progressSeries[r];
+        const ProgressMetric metric = static_cast<ProgressMetric>(progressMetricCb->currentIndex());
+        const std::vector<double> &y = s.values(metric);
+        std::vector<double> avg(y.size());
+        Progress::movingAverage(y.data(), (int)y.size(), Progress::TrendWindow, avg.data());
+        const int from = qMax(0, s.size() - Progress::TrendWindow);
+        const LinearFit fit = Progress::linearFit(s.day.data() + from, y.data() + from, s.size() - from);
+        progressChart->setData(s.day, y, std::move(avg), fit, from, s.name + " (kg)");
     }
 
     void updateSetsTable(int n) {
+        FT_TRACE_SCOPE("updateSetsTable");
+        FT_ALLOC_SCOPE("updateSetsTable");
         if (!setsT) return;
         setsT->setRowCount(n);
         for (int i = 0; i < n; i++) {
@@ -1404,17 +2177,50 @@ private:
         setsT->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Interactive);
     }
 
-    // Actions
+    void notify(const QString &title, const QString &text) {
+        if (!quiet) QMessageBox::information(this, title, text);
+    }
+
+    // Actions. Message boxes are shown after the action's trace and allocation scopes close: their
+    // nested event loop would otherwise be timed and counted (and its events nested) as part of the action.
     void doLogin() {
         QString u = logUser->text().trimmed(), p = logPass->text();
         if (u.isEmpty() || p.isEmpty()) { QMessageBox::warning(this, "Error", "Enter username and password"); return; }
-        if (checkLogin(u, p)) {
-            user.username = u; user.name = pName; loadData(); // set user and load
-            userLbl->setText(pName);
-            welLblMain->setText("Welcome");
-            logUser->clear(); logPass->clear(); stack->setCurrentWidget(mainPage);
-            refresh();
-        } else { QMessageBox::warning(this, "Error", "Invalid credentials"); }
+        prefetchTimer->stop();
+        QString error, damaged;
+        {
+            FT_TRACE_SCOPE("doLogin");
+            FT_ALLOC_SCOPE("doLogin");
+            error = logIn(u, p, &damaged);
+        }
+        if (!error.isEmpty()) QMessageBox::warning(this, "Error", error);
+        else if (!damaged.isEmpty()) QMessageBox::warning(this, "Data Files", "Some of your data files were damaged:\n" + damaged);
+    }
+
+    // Returns the error to show, empty once the member is logged in (`damaged` lists recovered files)
+    QString logIn(const QString &u, const QString &p, QString *damaged) {
+        if (!checkLogin(u, p)) { dropPrefetch(); return "Invalid credentials"; }
+        if (SecureStore::hasKey(QString(), u)) {
+            QApplication::setOverrideCursor(Qt::WaitCursor);
+            dataKey = SecureStore::unlock(QString(), u, p);
+            QApplication::restoreOverrideCursor();
+            if (dataKey.isEmpty()) return "Your data files could not be unlocked";
+        }
+        UserData d = takeUserData(u);
+        *damaged = d.damaged.join("\n");
+        // never continue on partial data: the next save would overwrite the files that failed to open
+        if (d.locked) {
+            dataKey.fill('\0'); dataKey.clear();
+            return damaged->isEmpty() ? "Some of your data files could not be decrypted" : "Some of your data files are damaged:\n" + *damaged;
+        }
+        // after a recovery the snapshot may be the only good copy, so this session leaves it alone
+        snapshotPending = damaged->isEmpty();
+        user.username = u; user.name = pName; loadData(std::move(d)); // set user and load
+        userLbl->setText(pName);
+        welLblMain->setText("Welcome");
+        invalidate(ViewAll);
+        logUser->clear(); logPass->clear(); stack->setCurrentWidget(mainPage);
+        return QString();
     }
 
     void doSignup() {
@@ -1423,119 +2229,214 @@ private:
         if (p.length() < 6) { QMessageBox::warning(this, "Error", "Password min 6 chars"); return; }
         if (p != c) { QMessageBox::warning(this, "Error", "Passwords don't match"); return; }
         if (userExists(u)) { QMessageBox::warning(this, "Error", "Username taken"); return; }
+        FT_TRACE_SCOPE("doSignup");
+        FT_ALLOC_SCOPE("doSignup");
         pUser = u; pName = n; saveUser(u, p, n);
         sigName->clear(); sigUser->clear(); sigPass->clear(); sigConf->clear();
         stack->setCurrentWidget(profilePage);
     }
 
     void doCompleteProfile() {
-        user.username = pUser; user.name = pName;
-        user.gender = profGender->currentText(); user.weight = profWeight->value(); user.targetBodyweight = targetBodyweightSp->value(); user.height = profHeight->value(); user.age = profAge->value();
-        saveData();
-        userLbl->setText(pName);
-        welLblMain->setText("Welcome");
-        refresh();
-        QMessageBox::information(this, "Success", "Profile created!"); stack->setCurrentWidget(mainPage);
+        {
+            FT_TRACE_SCOPE("doCompleteProfile");
+            FT_ALLOC_SCOPE("doCompleteProfile");
+            user.username = pUser; user.name = pName;
+            user.gender = profGender->currentText(); user.weight = profWeight->value(); user.targetBodyweight = targetBodyweightSp->value(); user.height = profHeight->value(); user.age = profAge->value();
+            saveData();
+            userLbl->setText(pName);
+            welLblMain->setText("Welcome");
+            invalidate(ViewAll);
+        }
+        notify("Success", "Profile created!"); stack->setCurrentWidget(mainPage);
     }
 
     void doLogout() {
-        saveData(); user = UserProfile(); cardio.clear(); strength.clear(); weightLogs.clear(); goals.clear(); curEx.clear(); if (exList) exList->clear();
+        FT_TRACE_SCOPE("doLogout");
+        FT_ALLOC_SCOPE("doLogout");
+        if (reportWatcher) reportWatcher->cancel(); // a late result must not land on the next account
+        if (importWatcher) importWatcher->cancel();
+        shownReport = ReportData(); if (reportPdfBtn) reportPdfBtn->setEnabled(false);
+        saveData(); dataKey.fill('\0'); dataKey.clear(); snapshotPending = false;
+        user = UserProfile(); cardio.clear(); strength.clear(); records.clear(); progressSeries.clear(); weightLogs.clear(); weightTrend.clear(); trainingLoad.clear(); goals.clear(); curEx.clear(); if (exList) exList->clear();
+        resetHistoryModels();
         userLbl->setText("");
         welLblMain->setText("Welcome");
         stack->setCurrentWidget(loginPage);
     }
 
     void saveCardio() {
-        CardioWorkout w; w.date = cardioDateEd->date().toString("yyyy-MM-dd"); w.type = cardioTypeCb->currentText(); w.duration = cardioDur->value(); w.distance = cardioDist->value();
-        w.calories = calcCardioCal(w.type, w.duration);
-        w.avgSpeed = (w.duration > 0) ? (w.distance * 60.0 / w.duration) : 0.0;
-        cardio.push_back(w);
-
-        for (auto &g : goals) {
-            if (g.type == "cardio_km") {
-                g.progress += w.distance;
-                if (g.targetTime > 0) g.progressTime += w.duration;
-            }
+        {
+            FT_TRACE_SCOPE("saveCardio");
+            FT_ALLOC_SCOPE("saveCardio");
+            CardioWorkout w; w.date = cardioDateEd->date().toString("yyyy-MM-dd"); w.type = cardioTypeCb->currentText(); w.duration = cardioDur->value(); w.distance = cardioDist->value();
+            w.calories = calcCardioCal(w.type, w.duration);
+            w.avgSpeed = (w.duration > 0) ? (w.distance * 60.0 / w.duration) : 0.0;
+            cardio.push_back(w);
+            cardioModel->appended();
+            trainingLoad.add(w);
+            heatmapAdd(w.date, w.distance, 0);
+            applyGoalProgress({w}, {});
+
+            saveData(); publishToLeaderboard(); invalidate(ViewDashboard | ViewGoals | ViewReports);
         }
-
-        saveData(); refresh(); QMessageBox::information(this, "Success", "Cardio saved!");
+        notify("Success", "Cardio saved!");
     }
 
     void delCardio() {
-        int r = cardioT->currentRow();
-        if (r >= 0 && r < (int)cardio.size()) { cardio.erase(cardio.begin() + r); saveData(); refresh(); }
+        FT_TRACE_SCOPE("delCardio");
+        FT_ALLOC_SCOPE("delCardio");
+        int r = cardioModel->recordAt(cardioT->currentIndex().row());
+        if (r < 0 || r >= (int)cardio.size()) return;
+        const CardioWorkout w = cardio[size_t(r)];
+        trainingLoad.remove(w); heatmapAdd(w.date, -w.distance, 0);
+        cardioModel->remove(r, [&] { cardio.erase(size_t(r)); });
+        // the sample file goes only once no cardio file on disk refers to it any more
+        if (saveData()) removeSamples(w);
+        publishToLeaderboard(); invalidate(ViewDashboard | ViewReports);
+    }
+
+    QString samplePath(const CardioWorkout &w) const { return SampleStore::filePath(QString(), user.username, w.samples); }
+
+    void removeSamples(const CardioWorkout &w) {
+        if (w.samples.isEmpty()) return;
+        QFile::remove(samplePath(w));
+    }
+
+    // Sample files are only read here, when one activity is opened
+    void showActivity() {
+        const int r = cardioModel->recordAt(cardioT->currentIndex().row());
+        if (r < 0 || r >= (int)cardio.size()) return;
+        const CardioWorkout &w = cardio[size_t(r)];
+        if (w.samples.isEmpty()) { QMessageBox::information(this, "Samples", "Only activities imported from a GPX, TCX or FIT file have sensor samples."); return; }
+        SampleSeries s;
+        bool ok = false;
+        QString problem;
+        {
+            FT_TRACE_SCOPE("showActivity");
+            const DataFile::Contents c = DataFile::read(samplePath(w), dataKey);
+            ok = c.status == DataFile::Status::Ok && SampleStore::decode(c.view, s);
+            problem = c.problem;
+        }
+        if (!ok) {
+            QMessageBox::warning(this, "Samples", "The samples of this activity could not be read" + (problem.isEmpty() ? QString() : ": " + problem));
+            return;
+        }
+        ActivityDialog dlg(w, std::move(s), this);
+        dlg.exec();
     }
 
     void addExercise() {
         QString n = exName->text().trimmed();
         if (n.isEmpty()) { QMessageBox::warning(this, "Error", "Enter exercise name"); return; }
-        Exercise ex; ex.name = n;
-
-        for (int i = 0; i < setsT->rowCount(); ++i) {
-            auto *repWidget = qobject_cast<QSpinBox*>(setsT->cellWidget(i, 1));
-            int reps = repWidget ? repWidget->value() : 0;
-            double weightForSet = exWeight->value();
-            if (perSetWeightCb && perSetWeightCb->isChecked()) {
-                auto *wWidget = qobject_cast<QDoubleSpinBox*>(setsT->cellWidget(i, 2));
-                if (wWidget) weightForSet = wWidget->value();
+        {
+            FT_TRACE_SCOPE("addExercise");
+            FT_ALLOC_SCOPE("addExercise");
+            Exercise ex; ex.name = n;
+
+            for (int i = 0; i < setsT->rowCount(); ++i) {
+                auto *repWidget = qobject_cast<QSpinBox*>(setsT->cellWidget(i, 1));
+                int reps = repWidget ? repWidget->value() : 0;
+                double weightForSet = exWeight->value();
+                if (perSetWeightCb && perSetWeightCb->isChecked()) {
+                    auto *wWidget = qobject_cast<QDoubleSpinBox*>(setsT->cellWidget(i, 2));
+                    if (wWidget) weightForSet = wWidget->value();
+                }
+                ExerciseSet s; s.reps = reps; s.weight = weightForSet;
+                ex.sets.push_back(s);
             }
-            ExerciseSet s; s.reps = reps; s.weight = weightForSet;
-            ex.sets.push_back(s);
-        }
 
-        curEx.push_back(ex);
-        QString disp = n + " - ";
-        for (size_t i = 0; i < ex.sets.size(); i++) { disp += QString::number(ex.sets[i].reps); if (i < ex.sets.size()-1) disp += ","; }
-        disp += QString(" reps @ %1kg").arg(ex.sets.empty() ? exWeight->value() : ex.sets[0].weight);
-        exList->addItem(disp);
-        exName->clear();
-        QMessageBox::information(this, "Added", "Exercise added!");
+            curEx.push_back(ex);
+            QString disp = n + " - ";
+            for (size_t i = 0; i < ex.sets.size(); i++) { disp += QString::number(ex.sets[i].reps); if (i < ex.sets.size()-1) disp += ","; }
+            disp += QString(" reps @ %1kg").arg(ex.sets.empty() ? exWeight->value() : ex.sets[0].weight);
+            exList->addItem(disp);
+            exName->clear();
+        }
+        notify("Added", "Exercise added!");
     }
 
     void saveStrength() {
         if (curEx.empty()) { QMessageBox::warning(this, "Error", "Add at least one exercise"); return; }
-        StrengthWorkout w; w.date = strDateEd->date().toString("yyyy-MM-dd"); w.exercises = curEx;
-        double v = 0; for (auto &e : w.exercises) for (auto &s : e.sets) v += s.reps * s.weight; w.calories = calcStrCal(v);
-        strength.push_back(w);
-
-        for (auto &g : goals) {
-            if (g.type == "strength_exercise" && !g.exerciseName.isEmpty()) {
-                bool achievedThisWorkout = false;
-                for (auto &e : w.exercises) {
-                    if (e.name.compare(g.exerciseName, Qt::CaseInsensitive) == 0) {
-                        if ((int)e.sets.size() >= g.exSets) {
-                            for (auto &s : e.sets) {
-                                if (s.reps >= g.exReps && s.weight >= g.exWeight) { achievedThisWorkout = true; break; }
+        QString msg = "Strength workout saved!";
+        {
+            FT_TRACE_SCOPE("saveStrength");
+            FT_ALLOC_SCOPE("saveStrength");
+            StrengthWorkout w; w.date = strDateEd->date().toString("yyyy-MM-dd"); w.exercises = curEx;
+            w.updateTotals(); w.calories = calcStrCal(w.totalVolume);
+            const QStringList newPrs = records.newRecords(w);
+            strength.push_back(w);
+            strModel->appended();
+            records.add(w);
+            trainingLoad.add(w);
+            heatmapAdd(w.date, 0, w.totalVolume);
+            progressSeries = Progress::buildSeries(strength);
+            applyGoalProgress({}, {w});
+
+            curEx.clear(); exList->clear(); saveData(); publishToLeaderboard(); invalidate(ViewDashboard | ViewGoals | ViewRecords | ViewProgress | ViewReports);
+            if (!newPrs.isEmpty()) msg += "\n\nNew personal records:\n" + newPrs.join("\n");
+        }
+        notify("Success", msg);
+    }
+
+    // Credits new workouts to the goals: km/minutes for cardio goals, one per qualifying workout for
+    // strength goals. A batch goes through in a single pass over the goals.
+    void applyGoalProgress(const std::vector<CardioWorkout> &newCardio, const std::vector<StrengthWorkout> &newStrength) {
+        for (size_t i = 0; i < goals.size(); ++i) goals.update(i, [&](Goal &g) {
+            if (g.type == "cardio_km") {
+                for (auto &w : newCardio) {
+                    g.progress += w.distance;
+                    if (g.targetTime > 0) g.progressTime += w.duration;
+                }
+            } else if (g.type == "strength_exercise" && !g.exerciseName.isEmpty()) {
+                for (auto &w : newStrength) {
+                    bool achievedThisWorkout = false;
+                    for (auto &e : w.exercises) {
+                        if (e.name.compare(g.exerciseName, Qt::CaseInsensitive) == 0) {
+                            if ((int)e.sets.size() >= g.exSets) {
+                                for (auto &s : e.sets) {
+                                    if (s.reps >= g.exReps && s.weight >= g.exWeight) { achievedThisWorkout = true; break; }
+                                }
                             }
                         }
+                        if (achievedThisWorkout) break;
                     }
-                    if (achievedThisWorkout) break;
+                    if (achievedThisWorkout) g.progress += 1;
                 }
-                if (achievedThisWorkout) g.progress += 1;
             }
-        }
-
-        curEx.clear(); exList->clear(); saveData(); refresh(); QMessageBox::information(this, "Success", "Strength workout saved!");
+        });
     }
 
     void delStrength() {
-        int r = strT->currentRow();
-        if (r >= 0 && r < (int)strength.size()) { strength.erase(strength.begin() + r); saveData(); refresh(); }
+        FT_TRACE_SCOPE("delStrength");
+        FT_ALLOC_SCOPE("delStrength");
+        int r = strModel->recordAt(strT->currentIndex().row());
+        if (r >= 0 && r < (int)strength.size()) { records.remove(strength[r]); trainingLoad.remove(strength[r]); heatmapAdd(strength[r].date, 0, -strength[r].totalVolume); strModel->remove(r, [&] { strength.erase(size_t(r)); }); progressSeries = Progress::buildSeries(strength); saveData(); publishToLeaderboard(); invalidate(ViewDashboard | ViewRecords | ViewProgress | ViewReports); }
     }
 
     void showStrDetails(int r) {
         if (r < 0 || r >= (int)strength.size()) return;
-        auto &w = strength[r];
-        QString msg = "Workout: " + w.date + "\n\n"; double tv = 0;
-        for (auto &e : w.exercises) {
-            msg += e.name + "\n"; double ev = 0;
-            for (size_t j = 0; j < e.sets.size(); j++) {
-                msg += QString("   Set %1: %2 reps @ %3 kg\n").arg(j+1).arg(e.sets[j].reps).arg(e.sets[j].weight);
-                ev += e.sets[j].reps * e.sets[j].weight;
+        QString msg;
+        {
+            FT_TRACE_SCOPE("showStrDetails");
+            FT_ALLOC_SCOPE("showStrDetails");
+            auto &w = strength[r];
+            msg = "Workout: " + w.date + "\n\n";
+            for (auto &e : w.exercises) {
+                msg += e.name + "\n";
+                const ExerciseRecords *pr = records.find(e.name);
+                const PrMark *heaviest = pr ? ExerciseRecords::best(pr->heaviest) : nullptr;
+                for (size_t j = 0; j < e.sets.size(); j++) {
+                    msg += QString("   Set %1: %2 reps @ %3 kg").arg(j+1).arg(e.sets[j].reps).arg(e.sets[j].weight);
+                    // flag sets that still hold a record that was first set in this workout
+                    if (heaviest && heaviest->date == w.date && e.sets[j].weight == heaviest->value) msg += "  [PR: heaviest]";
+                    else if (const PrMark *reps = pr ? pr->bestRepsMark(e.sets[j].weight) : nullptr; reps && reps->date == w.date && (int)reps->value == e.sets[j].reps) msg += "  [PR: reps]";
+                    msg += "\n";
+                }
+                const PrMark *vol = pr ? ExerciseRecords::best(pr->sessionVolume) : nullptr;
+                msg += QString("   Volume: %1 kg%2\n\n").arg((int)e.volume).arg(vol && vol->date == w.date && qAbs(vol->value - e.volume) < 1e-6 ? "  [PR]" : "");
             }
-            msg += QString("   Volume: %1 kg\n\n").arg((int)ev); tv += ev;
+            msg += QString("Total Volume: %1 kg\nCalories: %2").arg((int)w.totalVolume).arg((int)w.calories);
         }
-        msg += QString("Total Volume: %1 kg\nCalories: %2").arg((int)tv).arg((int)w.calories);
         QMessageBox::information(this, "Workout Details", msg);
     }
 
@@ -1556,52 +2457,420 @@ private:
             g.target = 1;
         }
 
-        goals.push_back(g); saveData(); refresh();
-
-        goalNameEd->clear();
-        goalTargetTimeSp->setValue(0);
-        goalExNameEd->clear();
-        goalExWeightSp->setValue(20);
-        goalExSetsSp->setValue(3);
-        goalExRepsSp->setValue(12);
-        goalTargetSp->setValue(10);
-
-        QMessageBox::information(this, "Success", "Goal created!");
+        {
+            FT_TRACE_SCOPE("addGoal");
+            FT_ALLOC_SCOPE("addGoal");
+            goals.push_back(g); saveData(); invalidate(ViewGoals | ViewDashboard);
+
+            goalNameEd->clear();
+            goalTargetTimeSp->setValue(0);
+            goalExNameEd->clear();
+            goalExWeightSp->setValue(20);
+            goalExSetsSp->setValue(3);
+            goalExRepsSp->setValue(12);
+            goalTargetSp->setValue(10);
+        }
+        notify("Success", "Goal created!");
     }
 
     void delGoal() {
+        FT_TRACE_SCOPE("delGoal");
+        FT_ALLOC_SCOPE("delGoal");
         int r = goalsT->currentRow();
-        if (r >= 0 && r < (int)goals.size()) { goals.erase(goals.begin() + r); saveData(); refresh(); }
+        if (r >= 0 && r < (int)goals.size()) { goals.erase(size_t(r)); saveData(); invalidate(ViewGoals | ViewDashboard); }
     }
 
     void saveBodyweight() {
-        BodyweightLog b; b.date = bwDateEd->date().toString("yyyy-MM-dd"); b.weight = bwWeightSp->value();
-        weightLogs.push_back(b);
+        {
+            FT_TRACE_SCOPE("saveBodyweight");
+            FT_ALLOC_SCOPE("saveBodyweight");
+            BodyweightLog b; b.date = bwDateEd->date().toString("yyyy-MM-dd"); b.weight = bwWeightSp->value();
+            weightLogs.push_back(b);
+            weightModel->appended();
+            if (!weightTrend.add(b)) weightTrend.rebuild(weightLogs); // back-dated entry
+
+            // Keep user's profile weight synced with last logged bodyweight
+            user.weight = b.weight;
+
+            saveData(); invalidate(ViewDashboard | ViewWeight | ViewProfile | ViewReports);
+        }
+        notify("Success", "Weight logged!");
+    }
 
-        // Keep user's profile weight synced with last logged bodyweight
-        user.weight = b.weight;
+    void delBodyweight() {
+        FT_TRACE_SCOPE("delBodyweight");
+        FT_ALLOC_SCOPE("delBodyweight");
+        int r = weightModel->recordAt(weightT->currentIndex().row());
+        if (r >= 0 && r < (int)weightLogs.size()) { weightModel->remove(r, [&] { weightLogs.erase(size_t(r)); }); weightTrend.rebuild(weightLogs); saveData(); invalidate(ViewDashboard | ViewWeight | ViewReports); }
+    }
 
-        saveData(); refresh(); QMessageBox::information(this, "Success", "Weight logged!");
+    void bulkEntry() {
+        BulkEntryDialog dlg(this);
+        if (dlg.exec() != QDialog::Accepted) return;
+        BulkBatch b = dlg.batch();
+        if (b.isEmpty()) return;
+        int prCount = 0;
+        {
+            FT_TRACE_SCOPE("bulkEntry");
+            FT_ALLOC_SCOPE("bulkEntry");
+            prCount = commitBatch(b);
+        }
+        QString msg = QString("Saved %1 cardio, %2 strength and %3 bodyweight entries.")
+                          .arg(b.cardio.size()).arg(b.strength.size()).arg(b.weights.size());
+        if (prCount) msg += QString("\n%1 new personal records.").arg(prCount);
+        notify("Success", msg);
     }
 
-    void delBodyweight() {
-        int r = weightT->currentRow();
-        if (r >= 0 && r < (int)weightLogs.size()) { weightLogs.erase(weightLogs.begin() + r); saveData(); refresh(); }
+    // Commits a batch (bulk entry, route import) as one transaction: one save, one goal pass, one
+    // view update. Fills in calories and returns the number of new personal records; *saved tells
+    // whether every file was written.
+    int commitBatch(BulkBatch &b, bool *saved = nullptr) {
+        // weigh-ins first, so backfilled workouts are costed at the bodyweight of their own date
+        weightLogs.append(b.weights.begin(), b.weights.end());
+        if (!b.weights.empty()) {
+            weightTrend.rebuild(weightLogs);
+            user.weight = Calories::WeightHistory(weightLogs, user.weight).on(QDate::currentDate().toString("yyyy-MM-dd"));
+        }
+        const Calories::WeightHistory history(weightLogs, user.weight);
+
+        for (auto &w : b.cardio) {
+            w.calories = Calories::cardio(w.type, history.on(w.date), w.duration);
+            trainingLoad.add(w);
+        }
+        int prCount = 0;
+        for (auto &w : b.strength) {
+            w.calories = Calories::strength(history.on(w.date), w.totalVolume);
+            prCount += (int)records.newRecords(w).size();
+            records.add(w);
+            trainingLoad.add(w);
+        }
+        cardio.append(b.cardio.begin(), b.cardio.end());
+        strength.append(b.strength.begin(), b.strength.end());
+        if (!b.strength.empty()) progressSeries = Progress::buildSeries(strength);
+        applyGoalProgress(b.cardio, b.strength);
+
+        if (!b.cardio.empty()) cardioModel->reset();
+        if (!b.strength.empty()) strModel->reset();
+        if (!b.weights.empty()) weightModel->reset();
+        const bool ok = saveData();
+        if (saved) *saved = ok;
+        if (!b.cardio.empty() || !b.strength.empty()) publishToLeaderboard();
+        unsigned views = ViewDashboard | ViewGoals | ViewCalendar | ViewReports;
+        if (!b.strength.empty()) views |= ViewRecords | ViewProgress;
+        if (!b.weights.empty()) views |= ViewWeight | ViewProfile;
+        invalidate(views);
+        return prCount;
+    }
+
+    // Files picked one by one, or every activity file under a folder (a watch's export, a sync folder)
+    void importRoutes(bool folder) {
+        if (importWatcher && importWatcher->isRunning()) return;
+        QStringList paths;
+        if (folder) {
+            const QString dir = QFileDialog::getExistingDirectory(this, "Import Activities", QDir::homePath());
+            if (dir.isEmpty()) return;
+            QDirIterator it(dir, {"*.gpx", "*.tcx", "*.fit"}, QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) paths << it.next();
+            if (paths.isEmpty()) { QMessageBox::information(this, "Import", "No GPX, TCX or FIT files in " + dir + "."); return; }
+        } else {
+            paths = QFileDialog::getOpenFileNames(this, "Import Activities", QDir::homePath(),
+                                                  "GPS activities (*.gpx *.tcx *.fit);;All files (*)");
+        }
+        if (paths.isEmpty()) return;
+        if (!importWatcher) {
+            importWatcher = new QFutureWatcher<RouteImport::FileResult>(this);
+            importProgress = new QProgressDialog("Importing activities...", "Cancel", 0, 0, this);
+            importProgress->setWindowModality(Qt::WindowModal);
+            importProgress->setMinimumDuration(300);
+            importProgress->reset();
+            connect(importWatcher, &QFutureWatcherBase::progressRangeChanged, importProgress, &QProgressDialog::setRange);
+            connect(importWatcher, &QFutureWatcherBase::progressValueChanged, importProgress, &QProgressDialog::setValue);
+            connect(importProgress, &QProgressDialog::canceled, importWatcher, &QFutureWatcherBase::cancel);
+            connect(importWatcher, &QFutureWatcherBase::finished, [this]{ finishRouteImport(); });
+        }
+        const int maxHr = user.age > 0 ? 220 - user.age : 190; // the usual age estimate; zones are relative to it
+        importWatcher->setFuture(QtConcurrent::mapped(paths, [maxHr](const QString &path) { return RouteImport::importFile(path, maxHr); }));
+    }
+
+    void finishRouteImport() {
+        importProgress->reset();
+        if (importWatcher->isCanceled()) return; // cancelled, or the member logged out meanwhile
+
+        BulkBatch b;
+        QStringList errors;
+        int duplicates = 0;
+        double km = 0, climb = 0;
+        {
+            FT_TRACE_SCOPE("finishRouteImport");
+            FT_ALLOC_SCOPE("finishRouteImport");
+            // a file imported before (same day, type, minutes and distance) is skipped, so re-importing a folder is harmless
+            auto key = [](const CardioWorkout &w) { return QString("%1|%2|%3|%4").arg(w.date, w.type).arg(w.duration).arg(w.distance, 0, 'f', 2); };
+            QSet<QString> known, sampleIds;
+            for (const CardioWorkout &w : cardio) { known.insert(key(w)); if (!w.samples.isEmpty()) sampleIds.insert(w.samples); }
+            for (const RouteImport::FileResult &r : importWatcher->future().results()) {
+                if (!r.error.isEmpty()) { errors << r.error; continue; }
+                for (const RouteImport::FileResult::Activity &a : r.activities) {
+                    const CardioWorkout &w = a.summary.workout;
+                    if (known.contains(key(w))) { duplicates++; continue; }
+                    known.insert(key(w));
+                    km += w.distance; climb += w.elevationGain;
+                    b.cardio.push_back(w);
+                    if (!w.samples.isEmpty()) {
+                        // sealed like the rest of the account's files while encryption is on; an id already
+                        // taken (same start time) is not overwritten, so no two records share one file
+                        const QString path = samplePath(w);
+                        if (sampleIds.contains(w.samples) || !QDir().mkpath(QFileInfo(path).path())
+                            || !DataFile::write(path, a.sampleData, dataKey, false))
+                            b.cardio.back().samples.clear();
+                        else
+                            sampleIds.insert(w.samples);
+                    }
+                }
+            }
+            std::sort(b.cardio.begin(), b.cardio.end(), [](const CardioWorkout &a, const CardioWorkout &c) { return a.date < c.date; });
+            bool saved = true;
+            if (!b.isEmpty()) commitBatch(b, &saved);
+            // the sample files were written first, so a saved record never points at a missing file; if the
+            // cardio file could not be saved they belong to nothing on disk: remove them and drop the ids
+            if (!saved) {
+                for (size_t i = cardio.size() - b.cardio.size(); i < cardio.size(); ++i) {
+                    if (cardio[i].samples.isEmpty()) continue;
+                    removeSamples(cardio[i]);
+                    cardio.update(i, [](CardioWorkout &w) { w.samples.clear(); });
+                }
+            }
+        }
+
+        QString msg = QString("Imported %1 activities: %2 km, %3 m climbed.").arg(b.cardio.size()).arg(km, 0, 'f', 1).arg(climb, 0, 'f', 0);
+        if (duplicates) msg += QString("\n%1 already in your history, skipped.").arg(duplicates);
+        if (!errors.isEmpty()) {
+            msg += QString("\n%1 could not be read:\n").arg(errors.size()) + errors.mid(0, 5).join("\n");
+            if (errors.size() > 5) msg += QString("\n... and %1 more").arg(errors.size() - 5);
+            QMessageBox::warning(this, "Import", msg);
+        } else {
+            notify("Success", msg);
+        }
+    }
+
+    void recalcCalories() {
+        if (cardio.empty() && strength.empty()) { QMessageBox::information(this, "Calories", "No workouts to recalculate."); return; }
+        if (QMessageBox::question(this, "Recalculate Calories",
+                                  "Recompute calories for all workouts using the bodyweight in effect on each workout's date?")
+            != QMessageBox::Yes) return;
+        Calories::RecomputeResult res;
+        {
+            FT_TRACE_SCOPE("recalcCalories");
+            FT_ALLOC_SCOPE("recalcCalories");
+            QApplication::setOverrideCursor(Qt::WaitCursor);
+            res = Calories::recompute(cardio, strength, weightLogs, user.weight);
+            QApplication::restoreOverrideCursor();
+            cardioModel->reset(); strModel->reset();
+            saveData(); invalidate(ViewDashboard | ViewReports);
+        }
+        notify("Success", QString("Updated %1 cardio and %2 strength workouts.\nTotal calories: %3 -> %4")
+                                 .arg(res.cardioChanged).arg(res.strengthChanged).arg((int)res.before).arg((int)res.after));
+    }
+
+    // Turns at-rest encryption on (new salt, key from the password, every file rewritten sealed) or off
+    void toggleEncryption() {
+        const bool enable = dataKey.isEmpty();
+        QByteArray oldKey = dataKey;
+        bool ok = false;
+        const QString p = QInputDialog::getText(this, "Data Encryption",
+                                                enable ? "Enter your password. Your files can only be opened with it from now on:"
+                                                       : "Enter your password to store your files unencrypted:",
+                                                QLineEdit::Password, QString(), &ok);
+        if (!ok) return;
+        if (!checkLogin(user.username, p)) { QMessageBox::warning(this, "Error", "Incorrect password"); return; }
+        bool keyWritten = true;
+        {
+            FT_TRACE_SCOPE("toggleEncryption");
+            if (enable) {
+                QApplication::setOverrideCursor(Qt::WaitCursor);
+                dataKey = SecureStore::enroll(QString(), user.username, p);
+                QApplication::restoreOverrideCursor();
+                keyWritten = !dataKey.isEmpty();
+                if (keyWritten) saveData();
+            } else {
+                dataKey.fill('\0'); dataKey.clear();
+                saveData(); // plaintext first, so the files never outlive the key that opens them
+            }
+            if (keyWritten) {
+                rekeySamples(oldKey);
+                if (!enable) SecureStore::removeKey(QString(), user.username);
+                dropSnapshots();
+                invalidate(ViewProfile);
+            }
+            oldKey.fill('\0');
+        }
+        if (!keyWritten) { QMessageBox::warning(this, "Error", "Could not write the key file"); return; }
+        notify("Success", enable ? "Your data files are now encrypted." : "Your data files are no longer encrypted.");
     }
 
     void updateProfile() {
-        user.gender = editGender->currentText(); user.weight = editWeight->value(); user.targetBodyweight = editTargetBodyweight->value(); user.height = editHeight->value(); user.age = editAge->value();
-        saveData(); refresh(); QMessageBox::information(this, "Success", "Profile updated!");
+        {
+            FT_TRACE_SCOPE("updateProfile");
+            FT_ALLOC_SCOPE("updateProfile");
+            user.gender = editGender->currentText(); user.weight = editWeight->value(); user.targetBodyweight = editTargetBodyweight->value(); user.height = editHeight->value(); user.age = editAge->value();
+            saveData(); invalidate(ViewDashboard | ViewWeight | ViewProfile);
+        }
+        notify("Success", "Profile updated!");
     }
 };
 
-int main(int argc, char *argv[]) {
+// --bench-gui [rows...]: drives a real window through the offscreen platform plugin on synthetic
+// accounts (default 1k/10k/100k cardio rows) and prints per-scenario wall times as JSON on stdout.
+// Every timed scenario ends with a grab(), so layout and painting are included.
+int runGuiBenchmark(const QStringList &args) {
+    QTextStream out(stdout);
+    std::vector<int> sizes;
+    for (int i = args.indexOf("--bench-gui") + 1; i < args.size() && args[i].toInt() > 0; ++i) sizes.push_back(args[i].toInt());
+    if (sizes.empty()) sizes = {1000, 10000, 100000};
+
+    QJsonArray results;
+    auto record = [&](int rows, const QString &name, std::vector<double> ms) {
+        std::sort(ms.begin(), ms.end());
+        results.append(QJsonObject{{"rows", rows}, {"scenario", name}, {"runs", (int)ms.size()},
+                                   {"median_ms", ms[ms.size() / 2]}, {"min_ms", ms.front()}, {"max_ms", ms.back()}});
+    };
+    auto timeRuns = [](int runs, const std::function<void()> &setup, const std::function<void()> &body) {
+        std::vector<double> ms;
+        for (int i = 0; i < runs; ++i) {
+            if (setup) setup();
+            QElapsedTimer t; t.start();
+            body();
+            ms.push_back(t.nsecsElapsed() / 1e6);
+        }
+        return ms;
+    };
 
+    const QString startDir = QDir::currentPath();
+    for (int rows : sizes) {
+        // the window reads and writes its .dat files in the working directory
+        QTemporaryDir tmp;
+        if (!tmp.isValid() || !QDir::setCurrent(tmp.path())) { out << "bench: cannot create temp dir\n"; return 1; }
+        const QString user = "bench_gui", pass = "benchpass";
+        writeBenchAccount(tmp.path(), user, rows);
+
+        int rc = 0;
+        {
+            FitTrackPro w;
+            w.quiet = true;
+            w.saveUser(user, pass, "Bench User");
+            w.resize(1280, 860);
+            w.show();
+            QCoreApplication::processEvents();
+            const int loginRuns = rows >= 100000 ? 3 : 5;
+
+            record(rows, "login_to_dashboard", timeRuns(loginRuns, [&] {
+                if (w.stack->currentWidget() == w.mainPage) w.doLogout();
+                QCoreApplication::processEvents();
+            }, [&] {
+                w.logUser->setText(user); w.logPass->setText(pass);
+                w.doLogin();
+                QCoreApplication::processEvents();
+                w.grab();
+            }));
+            if (w.stack->currentWidget() != w.mainPage) { out << "bench: login failed\n"; rc = 2; }
+
+            if (!rc) {
+                w.mainTabs->setCurrentIndex(1); // Log
+                w.logTabs->setCurrentIndex(0);
+                record(rows, "save_cardio_to_table", timeRuns(5, nullptr, [&] {
+                    w.cardioDur->setValue(45); w.cardioDist->setValue(8.5);
+                    w.saveCardio();
+                    QCoreApplication::processEvents();
+                    w.cardioT->grab();
+                }));
+                w.logTabs->setCurrentWidget(w.viewPages[FitTrackPro::ViewWeight]);
+                record(rows, "save_bodyweight_to_table", timeRuns(5, nullptr, [&] {
+                    w.bwWeightSp->setValue(80.0);
+                    w.saveBodyweight();
+                    QCoreApplication::processEvents();
+                    w.viewPages[FitTrackPro::ViewWeight]->grab();
+                }));
+
+                // every view stale, as after a save, so the switch pays for the lazy recompute
+                for (int tab = 1; tab < w.mainTabs->count(); ++tab) {
+                    const QString name = "tab_switch_" + w.mainTabs->tabText(tab).toLower();
+                    record(rows, name, timeRuns(5, [&] {
+                        w.mainTabs->setCurrentIndex(0);
+                        w.staleViews = FitTrackPro::ViewAll;
+                        QCoreApplication::processEvents();
+                    }, [&] {
+                        w.mainTabs->setCurrentIndex(tab);
+                        QCoreApplication::processEvents();
+                        w.mainTabs->currentWidget()->grab();
+                    }));
+                }
+
+                w.mainTabs->setCurrentIndex(0);
+                w.invalidate(FitTrackPro::ViewAll);
+                record(rows, "paint_weekly_bar_chart", timeRuns(20, nullptr, [&] { w.cardioChart->grab(); }));
+                record(rows, "paint_bodyweight_trend_chart", timeRuns(10, [&] { w.refreshWeightTrend(false); }, [&] { w.bwHistoryChart->grab(); }));
+                record(rows, "paint_background", timeRuns(10, nullptr, [&] { w.loginPage->grab(); }));
+                record(rows, "paint_heatmap", timeRuns(10, nullptr, [&] { w.heatmap->grab(); }));
+                record(rows, "sets_table_rebuild", timeRuns(10, nullptr, [&] { w.updateSetsTable(10); w.updateSetsTable(3); }));
+            }
+            w.doLogout();
+            w.close();
+        }
+        QDir::setCurrent(startDir);
+        if (rc) return rc;
+    }
+
+    QJsonObject doc{{"benchmark", "gui"}, {"platform", QGuiApplication::platformName()}, {"qt", qVersion()},
+                    {"date", QDate::currentDate().toString("yyyy-MM-dd")}, {"results", results}};
+    out << QJsonDocument(doc).toJson(QJsonDocument::Indented);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    // headless modes (benchmarks, batch reports): no display needed
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--batch-report") == 0) {
+            QCoreApplication c(argc, argv);
+            return runBatchReport(c.arguments());
+        }
+        if (qstrcmp(argv[i], "--batch-pdf") == 0) {
+            // QPdfWriter needs fonts, hence a gui application, but never a display
+            if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+            QGuiApplication g(argc, argv);
+            return runBatchPdf(g.arguments());
+        }
+        if (qstrcmp(argv[i], "--bench-parse") == 0) {
+            QCoreApplication c(argc, argv);
+            return runParseBenchmark(c.arguments());
+        }
+        if (qstrcmp(argv[i], "--bench-crypto") == 0) {
+            QCoreApplication c(argc, argv);
+            return runCryptoBenchmark(c.arguments());
+        }
+        if (qstrcmp(argv[i], "--bench-route") == 0) {
+            QCoreApplication c(argc, argv);
+            return runRouteBenchmark(c.arguments());
+        }
+        if (qstrcmp(argv[i], "--bench-trace") == 0) {
+            QCoreApplication c(argc, argv);
+            return runTraceBenchmark();
+        }
+        if (qstrcmp(argv[i], "--bench-gui") == 0) {
+            // real widgets, but no display: default to the offscreen platform plugin
+            if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+            QApplication a(argc, argv);
+            return runGuiBenchmark(a.arguments());
+        }
+    }
 
     QApplication a(argc, argv);
     FitTrackPro w;
     w.show();
-    return a.exec();
+    int rc = a.exec();
+
+    // allocstats builds: FITTRACK_ALLOC_REPORT=<file.csv> dumps the per-action counts on exit
+    if (AllocStats::enabled() && qEnvironmentVariableIsSet("FITTRACK_ALLOC_REPORT"))
+        AllocStats::writeReport(qEnvironmentVariable("FITTRACK_ALLOC_REPORT"));
+    return rc;
 }
 
 // at end of main.cpp (after all class definitions)
@@ -0,0 +1,81 @@
+#ifndef MODELS_H
+#define MODELS_H
+
+// FitTrack Pro - plain data records shared by the window, the parsers and the batch tools
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include "persistentvector.h"
+
+struct ExerciseSet { int reps; double weight; };
+struct Exercise { QString name; std::vector<ExerciseSet> sets; double volume = 0; };
+
+// volume/setCount/repCount (and each Exercise::volume) are derived from the sets once, by updateTotals(),
+// when a workout is built or loaded, and persisted with it; nothing else sums sets.
+struct StrengthWorkout {
+    QString date;
+    std::vector<Exercise> exercises;
+    double calories = 0;
+    double totalVolume = 0;
+    int setCount = 0;
+    int repCount = 0;
+
+    void updateTotals() {
+        totalVolume = 0; setCount = 0; repCount = 0;
+        for (auto &e : exercises) {
+            e.volume = 0;
+            for (auto &s : e.sets) { e.volume += s.reps * s.weight; repCount += s.reps; }
+            totalVolume += e.volume;
+            setCount += (int)e.sets.size();
+        }
+    }
+};
+// Precomputed from the samples when an activity is imported, so lists never open the sample files
+struct HeartRateSummary {
+    int average = 0, maximum = 0; // bpm, 0 without a heart-rate sensor
+    int zoneSeconds[5] = {};
+};
+
+struct CardioWorkout {
+    QString date; QString type; int duration; double distance; double calories; double avgSpeed;
+    // only known for workouts imported from a GPS track (routeimport.h)
+    double elevationGain = 0; // metres
+    std::vector<int> splits;  // seconds per full km, in order; 0 where the track had no time
+    QString samples;          // id of the activity's sample file (samplestore.h), empty if none
+    HeartRateSummary heartRate;
+};
+struct BodyweightLog { QString date; double weight; };
+
+struct Goal {
+    QString name;
+    QString type; // "cardio_km", "strength_exercise"
+    double target = 0;
+    double progress = 0;
+    int targetTime = 0;
+    int progressTime = 0;
+    QString exerciseName;
+    double exWeight = 0;
+    int exSets = 0;
+    int exReps = 0;
+};
+
+struct UserProfile { QString username; QString name; QString gender; double weight = 0; double targetBodyweight = 0; double height = 0; int age = 0; };
+
+// One line of users.dat: username|password hash (SecureStore::hashPassword)|display name
+struct UserAccount { QString username; QString passwordHash; QString name; };
+
+// Everything stored for one account (profile_/cardio_/strength_/weight_/goals_<user>.dat). The record
+// lists are persistent vectors: copying a UserData (or one list) is a snapshot a worker can read
+// while the GUI goes on changing its own copy.
+struct UserData {
+    UserProfile profile;
+    bool hasProfile = false;
+    PersistentVector<CardioWorkout> cardio;
+    PersistentVector<StrengthWorkout> strength;
+    PersistentVector<BodyweightLog> weightLogs;
+    PersistentVector<Goal> goals;
+    bool locked = false; // some files are encrypted and no matching key was given; their records stay empty
+    QStringList damaged; // "<file>: what failed verification and what was loaded instead"
+};
+
+#endif // MODELS_H
@@ -0,0 +1,271 @@
+// pdfreport.cpp
+#include "pdfreport.h"
+#include "analytics.h"
+#include "reportcharts.h"
+#include "tracing.h"
+
+#include <QFileInfo>
+#include <QPageLayout>
+#include <QPageSize>
+#include <QPainter>
+#include <QPdfWriter>
+
+namespace {
+
+constexpr int Dpi = 150;
+const QColor Accent("#FF5F1F");
+const QColor Rule("#d0d0d0");
+const QColor Shade("#f3f3f3");
+
+// A y cursor over the writer's pages; tables call room() before each row and continue on a new page
+class Page {
+public:
+    Page(QPdfWriter &w, QPainter &p) : writer(w), painter(p), width(w.width()), height(w.height()) {}
+
+    void room(double h)
+    {
+        if (y + h > height) next();
+    }
+    void next()
+    {
+        writer.newPage();
+        y = 0;
+    }
+
+    QPdfWriter &writer;
+    QPainter &painter;
+    double width = 0, height = 0, y = 0;
+};
+
+void setFont(QPainter &p, double pt, bool bold = false)
+{
+    QFont f("Helvetica");
+    f.setPointSizeF(pt);
+    f.setBold(bold);
+    p.setFont(f);
+}
+
+void heading(Page &pg, const QString &text)
+{
+    setFont(pg.painter, 13, true);
+    const double h = pg.painter.fontMetrics().height() * 1.8;
+    pg.room(h * 2); // keep a heading with at least one line of what follows
+    pg.painter.setPen(Accent);
+    pg.painter.drawText(QRectF(0, pg.y, pg.width, h), Qt::AlignLeft | Qt::AlignBottom, text);
+    pg.y += h + 6;
+}
+
+// Columns share the width by `weights`; the header repeats on every page the table spans
+void table(Page &pg, const QStringList &header, const QVector<double> &weights, const std::vector<QStringList> &rows)
+{
+    double total = 0;
+    for (double w : weights) total += w;
+    QVector<double> xs{0};
+    for (double w : weights) xs << xs.back() + w / total * pg.width;
+
+    setFont(pg.painter, 9);
+    const double rowH = pg.painter.fontMetrics().height() * 1.6;
+    auto drawRow = [&](const QStringList &cells, bool head, bool shaded) {
+        QPainter &p = pg.painter;
+        if (shaded) p.fillRect(QRectF(0, pg.y, pg.width, rowH), Shade);
+        setFont(p, 9, head);
+        p.setPen(head ? Accent : QColor("#1a1a1a"));
+        for (int c = 0; c < cells.size() && c + 1 < xs.size(); ++c) {
+            const QRectF cell(xs[c] + 4, pg.y, xs[c + 1] - xs[c] - 8, rowH);
+            p.drawText(cell, (c ? Qt::AlignRight : Qt::AlignLeft) | Qt::AlignVCenter,
+                       p.fontMetrics().elidedText(cells[c], Qt::ElideRight, int(cell.width())));
+        }
+        pg.y += rowH;
+        if (head) { p.setPen(QPen(Rule, 2)); p.drawLine(QPointF(0, pg.y), QPointF(pg.width, pg.y)); }
+    };
+
+    pg.room(rowH * 2);
+    drawRow(header, true, false);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (pg.y + rowH > pg.height) { pg.next(); drawRow(header, true, false); }
+        drawRow(rows[i], false, i % 2);
+    }
+    pg.y += rowH * 0.8;
+}
+
+void statTiles(Page &pg, const QVector<QPair<QString, QString>> &tiles)
+{
+    QPainter &p = pg.painter;
+    const int perRow = 4;
+    const double gap = 12, w = (pg.width - gap * (perRow - 1)) / perRow;
+    setFont(p, 16, true);
+    const double valueH = p.fontMetrics().height();
+    setFont(p, 8);
+    const double labelH = p.fontMetrics().height();
+    const double h = valueH + labelH + 24;
+    for (int i = 0; i < tiles.size(); ++i) {
+        if (i % perRow == 0) { if (i) pg.y += h + gap; pg.room(h); }
+        const QRectF r((i % perRow) * (w + gap), pg.y, w, h);
+        p.setPen(QPen(Rule, 1.5));
+        p.setBrush(Qt::NoBrush);
+        p.drawRoundedRect(r, 8, 8);
+        setFont(p, 16, true);
+        p.setPen(QColor("#1a1a1a"));
+        p.drawText(QRectF(r.left(), r.top() + 8, r.width(), valueH), Qt::AlignCenter, tiles[i].second);
+        setFont(p, 8);
+        p.setPen(QColor("#666666"));
+        p.drawText(QRectF(r.left(), r.top() + 10 + valueH, r.width(), labelH), Qt::AlignCenter, tiles[i].first);
+    }
+    pg.y += h + gap * 2;
+}
+
+void weightLine(QPainter &p, const QRectF &r, const ReportData &d)
+{
+    p.save();
+    p.setRenderHint(QPainter::Antialiasing);
+    setFont(p, 8);
+    if (d.weight.size() < 2) {
+        p.setPen(QColor("#666666"));
+        p.drawText(r, Qt::AlignCenter, "Fewer than two weigh-ins in this range");
+        p.restore();
+        return;
+    }
+    double lo = d.weight[0], hi = d.weight[0];
+    for (double v : d.weight) { lo = qMin(lo, v); hi = qMax(hi, v); }
+    if (hi - lo < 1e-9) { hi += 1; lo -= 1; }
+    const QRectF plot = r.adjusted(60, 8, -8, -8);
+    const double x0 = d.weightDay.front(), x1 = qMax(d.weightDay.back(), x0 + 1);
+    auto pt = [&](double x, double y) {
+        return QPointF(plot.left() + (x - x0) / (x1 - x0) * plot.width(), plot.bottom() - (y - lo) / (hi - lo) * plot.height());
+    };
+    p.setPen(QPen(Rule, 1));
+    p.drawRect(plot);
+    p.setPen(QColor("#666666"));
+    p.drawText(QRectF(r.left(), plot.top() - 8, 56, 16), Qt::AlignRight | Qt::AlignVCenter, QString::number(hi, 'f', 1));
+    p.drawText(QRectF(r.left(), plot.bottom() - 8, 56, 16), Qt::AlignRight | Qt::AlignVCenter, QString::number(lo, 'f', 1));
+
+    QPolygonF raw, avg;
+    for (size_t i = 0; i < d.weight.size(); ++i) {
+        raw << pt(d.weightDay[i], d.weight[i]);
+        avg << pt(d.weightDay[i], d.weightAvg[i]);
+    }
+    p.setPen(QPen(QColor("#9bb0c0"), 2));
+    p.drawPolyline(raw);
+    p.setPen(QPen(Accent, 3));
+    p.drawPolyline(avg);
+    p.setPen(QPen(QColor("#1a1a1a"), 1.5, Qt::DashLine));
+    p.drawLine(pt(x0, d.weightFit.intercept + d.weightFit.slope * x0), pt(x1, d.weightFit.intercept + d.weightFit.slope * x1));
+    p.restore();
+}
+
+QString goalTarget(const Goal &g)
+{
+    if (g.type == "cardio_km") return g.targetTime > 0 ? QString("%1 km in %2 min").arg(g.target).arg(g.targetTime) : QString("%1 km").arg(g.target);
+    return QString("%1 %2 kg %3x%4").arg(g.exerciseName).arg(g.exWeight).arg(g.exSets).arg(g.exReps);
+}
+
+} // namespace
+
+namespace PdfReport {
+
+bool write(const PdfReportInput &in, const QString &path, QString *error)
+{
+    FT_TRACE_SCOPE("PdfReport::write");
+    const ReportData &d = in.data;
+    QPdfWriter writer(path);
+    writer.setResolution(Dpi);
+    writer.setPageLayout(QPageLayout(QPageSize(QPageSize::A4), QPageLayout::Portrait, QMarginsF(15, 15, 15, 15), QPageLayout::Millimeter));
+    writer.setTitle(QString("FitTrack Pro report - %1").arg(in.profile.name));
+    writer.setCreator("FitTrack Pro");
+    QPainter p;
+    if (!p.begin(&writer)) {
+        if (error) *error = QString("cannot write %1").arg(QFileInfo(path).absoluteFilePath());
+        return false;
+    }
+    Page pg(writer, p);
+
+    // title block
+    setFont(p, 20, true);
+    p.setPen(QColor("#1a1a1a"));
+    const double titleH = p.fontMetrics().height();
+    p.drawText(QRectF(0, 0, pg.width, titleH), Qt::AlignLeft | Qt::AlignVCenter, "FitTrack Pro - Member Report");
+    pg.y += titleH + 4;
+    setFont(p, 10);
+    p.setPen(QColor("#666666"));
+    const double lineH = p.fontMetrics().height() * 1.3;
+    p.drawText(QRectF(0, pg.y, pg.width, lineH), Qt::AlignLeft | Qt::AlignVCenter,
+               QString("%1 (%2)").arg(in.profile.name, in.profile.username));
+    p.drawText(QRectF(0, pg.y, pg.width, lineH), Qt::AlignRight | Qt::AlignVCenter,
+               QString("%1 - %2").arg(d.from.toString("d MMM yyyy"), d.to.toString("d MMM yyyy")));
+    pg.y += lineH;
+    p.drawText(QRectF(0, pg.y, pg.width, lineH), Qt::AlignRight | Qt::AlignVCenter,
+               QString("Generated %1").arg(in.generated.toString("d MMM yyyy")));
+    pg.y += lineH + 8;
+    p.setPen(QPen(Accent, 3));
+    p.drawLine(QPointF(0, pg.y), QPointF(pg.width, pg.y));
+    pg.y += 16;
+
+    // summary
+    int sessions = 0, minutes = 0, workouts = 0;
+    double km = 0, volume = 0, kcal = 0;
+    for (const MonthSummary &m : d.months) {
+        sessions += m.cardioSessions; minutes += m.cardioMinutes; km += m.cardioKm;
+        workouts += m.strengthWorkouts; volume += m.strengthVolume; kcal += m.cardioKcal + m.strengthKcal;
+    }
+    const bool hasWeight = !d.weight.empty();
+    heading(pg, "Summary");
+    statTiles(pg, {{"Cardio sessions", QString::number(sessions)},
+                   {"Distance", QString("%1 km").arg(km, 0, 'f', 1)},
+                   {"Cardio time", QString("%1 h").arg(minutes / 60.0, 0, 'f', 1)},
+                   {"Calories", QString::number(kcal, 'f', 0)},
+                   {"Strength workouts", QString::number(workouts)},
+                   {"Volume lifted", QString("%1 t").arg(volume / 1000.0, 0, 'f', 1)},
+                   {"Bodyweight", hasWeight ? QString("%1 kg").arg(d.weight.back(), 0, 'f', 1) : QString("--")},
+                   {"Weight trend", d.weight.size() >= 2 ? QString("%1%2 kg/wk").arg(d.weightFit.slope >= 0 ? "+" : "").arg(d.weightFit.slope * 7, 0, 'f', 2) : QString("--")}});
+
+    // charts
+    QStringList labels; QVector<double> values;
+    for (const ActivityShare &a : d.activities) { labels << a.type; values << a.minutes; }
+    const double chartW = (pg.width - 24) / 2, chartH = 420;
+    heading(pg, "Activity Mix and Volume by Exercise");
+    pg.room(chartH);
+    setFont(p, 9);
+    ReportCharts::drawShare(p, QRectF(0, pg.y, chartW, chartH), labels, values, "min", ReportCharts::Theme::print());
+    labels.clear(); values.clear();
+    for (const ExerciseVolume &e : d.exercises) { labels << e.name; values << e.volume; }
+    ReportCharts::foldTail(labels, values, RankedBarChart::maxBars);
+    ReportCharts::drawRankedBars(p, QRectF(chartW + 24, pg.y, chartW, chartH), labels, values, "kg", ReportCharts::Theme::print());
+    pg.y += chartH + 16;
+
+    heading(pg, "Bodyweight");
+    pg.room(300);
+    weightLine(p, QRectF(0, pg.y, pg.width, 300), d);
+    pg.y += 316;
+
+    // monthly table, newest first as in the Reports tab
+    std::vector<QStringList> rows;
+    for (auto it = d.months.rbegin(); it != d.months.rend(); ++it)
+        rows.push_back({it->month.toString("MMM yyyy"), QString::number(it->cardioSessions), QString::number(it->cardioKm, 'f', 1),
+                        QString::number(it->cardioMinutes), QString::number(it->strengthWorkouts), QString::number(it->strengthVolume, 'f', 0),
+                        QString::number(it->cardioKcal + it->strengthKcal, 'f', 0), it->weighIns ? QString::number(it->avgWeight, 'f', 1) : QString("--")});
+    heading(pg, "By Month");
+    table(pg, {"Month", "Cardio", "Km", "Minutes", "Strength", "Volume (kg)", "Calories", "Avg Weight"}, {2, 1, 1, 1, 1, 1.4, 1.2, 1.3}, rows);
+
+    rows.clear();
+    for (const Goal &g : in.goals) {
+        const GoalStatus st = goalStatus(g);
+        rows.push_back({g.name, g.type == "cardio_km" ? "Cardio" : g.type == "strength_exercise" ? "Strength" : g.type, goalTarget(g),
+                        QString::number(g.progress, 'f', 1), st.done ? QString("Done") : QString("%1%").arg(st.pct)});
+    }
+    heading(pg, "Goals");
+    if (rows.empty()) {
+        setFont(p, 9);
+        p.setPen(QColor("#666666"));
+        p.drawText(QRectF(0, pg.y, pg.width, lineH), Qt::AlignLeft | Qt::AlignVCenter, "No goals set");
+    } else {
+        table(pg, {"Goal", "Type", "Target", "Progress", "Status"}, {2.5, 1, 2.5, 1, 1}, rows);
+    }
+
+    if (!p.end()) {
+        if (error) *error = QString("failed writing %1").arg(QFileInfo(path).absoluteFilePath());
+        return false;
+    }
+    return true;
+}
+
+} // namespace PdfReport
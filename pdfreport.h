@@ -0,0 +1,27 @@
+#ifndef PDFREPORT_H
+#define PDFREPORT_H
+
+// FitTrack Pro - printable member report: summary stats, activity and volume charts, monthly table, goals.
+// write() paints onto its own QPdfWriter and touches no widgets or shared state, so the GUI runs it
+// on a worker and the roster batch runs one per pool thread.
+#include <QDate>
+#include <QString>
+#include <vector>
+#include "models.h"
+#include "reports.h"
+
+struct PdfReportInput {
+    UserProfile profile;
+    ReportData data; // Reports::compute() over the reported range
+    PersistentVector<Goal> goals;
+    QDate generated;
+};
+
+namespace PdfReport {
+
+// Returns false and sets `error` if the file cannot be written
+bool write(const PdfReportInput &in, const QString &path, QString *error = nullptr);
+
+} // namespace PdfReport
+
+#endif // PDFREPORT_H
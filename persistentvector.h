@@ -0,0 +1,240 @@
+#ifndef PERSISTENTVECTOR_H
+#define PERSISTENTVECTOR_H
+
+// FitTrack Pro - persistent (copy-on-write) vector for the member's history
+// A B-tree of chunks: leaves hold up to LeafMax records, branches up to BranchMax children and the
+// running element counts below them. Copying a PersistentVector copies one pointer, so a worker
+// gets a consistent snapshot in O(1); a later push_back / set / erase on the original copies only
+// the nodes on the path to the record (O(log n)) and the snapshot keeps the old ones. Nodes that
+// nobody else holds are changed in place, so appends on an unshared vector stay amortized O(1).
+// Readers need no locks: a node is never modified once a second owner can see it. Writes are not
+// synchronised: one thread (the GUI) owns each PersistentVector object, workers read copies.
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+template <class T>
+class PersistentVector {
+    static constexpr size_t LeafMax = 64;
+    static constexpr size_t BranchMax = 32;
+
+    struct Node;
+    using NodePtr = std::shared_ptr<Node>;
+    struct Node {
+        bool leaf = true;
+        std::vector<T> items;          // leaf
+        std::vector<NodePtr> children; // branch
+        std::vector<size_t> ends;      // branch: elements in children[0..i]
+        size_t size() const { return leaf ? items.size() : (ends.empty() ? 0 : ends.back()); }
+        void recount() {
+            ends.resize(children.size());
+            size_t n = 0;
+            for (size_t i = 0; i < children.size(); ++i) ends[i] = n += children[i]->size();
+        }
+        // child holding element i (i == size() picks the last child, for appends), and its first index
+        size_t childFor(size_t i, size_t *first) const {
+            size_t c = size_t(std::upper_bound(ends.begin(), ends.end(), i) - ends.begin());
+            if (c == children.size()) c = children.size() - 1;
+            *first = c ? ends[c - 1] : 0;
+            return c;
+        }
+    };
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() = default;
+        reference operator*() const { return *cur; }
+        pointer operator->() const { return cur; }
+        const_iterator &operator++() {
+            ++index;
+            if (++cur == leafEnd && index < owner->count) seek();
+            return *this;
+        }
+        const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+        bool operator==(const const_iterator &o) const { return index == o.index; }
+        bool operator!=(const const_iterator &o) const { return index != o.index; }
+
+    private:
+        friend class PersistentVector;
+        const_iterator(const PersistentVector *v, size_t i) : owner(v), index(i) { if (i < v->count) seek(); }
+        void seek() {
+            const Node *n = owner->root.get();
+            size_t i = index, first = 0;
+            while (!n->leaf) {
+                const size_t c = n->childFor(i, &first);
+                i -= first;
+                n = n->children[c].get();
+            }
+            cur = n->items.data() + i;
+            leafEnd = n->items.data() + n->items.size();
+        }
+        const PersistentVector *owner = nullptr;
+        size_t index = 0;
+        const T *cur = nullptr, *leafEnd = nullptr;
+    };
+    using iterator = const_iterator;
+
+    PersistentVector() = default;
+    PersistentVector(const PersistentVector &) = default;
+    PersistentVector &operator=(const PersistentVector &) = default;
+    PersistentVector(PersistentVector &&o) noexcept : root(std::move(o.root)), count(std::exchange(o.count, 0)) {}
+    PersistentVector &operator=(PersistentVector &&o) noexcept {
+        root = std::move(o.root);
+        count = std::exchange(o.count, 0);
+        return *this;
+    }
+    // Bulk build: leaves filled in order, O(n)
+    explicit PersistentVector(std::vector<T> &&items) { assign(std::move(items)); }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+    const T &front() const { return (*this)[0]; }
+    const T &back() const { return (*this)[count - 1]; }
+
+    const T &operator[](size_t i) const {
+        const Node *n = root.get();
+        size_t first = 0;
+        while (!n->leaf) {
+            const size_t c = n->childFor(i, &first);
+            i -= first;
+            n = n->children[c].get();
+        }
+        return n->items[i];
+    }
+
+    void assign(std::vector<T> &&items) {
+        clear();
+        std::vector<NodePtr> level;
+        for (size_t i = 0; i < items.size(); i += LeafMax) {
+            auto leaf = std::make_shared<Node>();
+            const size_t end = std::min(items.size(), i + LeafMax);
+            leaf->items.assign(std::make_move_iterator(items.begin() + std::ptrdiff_t(i)), std::make_move_iterator(items.begin() + std::ptrdiff_t(end)));
+            level.push_back(std::move(leaf));
+        }
+        while (level.size() > 1) {
+            std::vector<NodePtr> up;
+            for (size_t i = 0; i < level.size(); i += BranchMax) {
+                auto branch = std::make_shared<Node>();
+                branch->leaf = false;
+                branch->children.assign(level.begin() + std::ptrdiff_t(i), level.begin() + std::ptrdiff_t(std::min(level.size(), i + BranchMax)));
+                branch->recount();
+                up.push_back(std::move(branch));
+            }
+            level.swap(up);
+        }
+        if (!level.empty()) root = std::move(level.front());
+        count = items.size();
+    }
+    void clear() { root.reset(); count = 0; }
+
+    void push_back(T v) { insert(count, std::move(v)); }
+    template <class It>
+    void append(It first, It last) { for (; first != last; ++first) push_back(*first); }
+
+    void insert(size_t i, T v) {
+        if (!root) root = std::make_shared<Node>();
+        if (NodePtr extra = insertAt(root, i, std::move(v))) { // the root split: grow a level
+            auto up = std::make_shared<Node>();
+            up->leaf = false;
+            up->children = {std::move(root), std::move(extra)};
+            up->recount();
+            root = std::move(up);
+        }
+        ++count;
+    }
+
+    void set(size_t i, T v) { update(i, [&v](T &x) { x = std::move(v); }); }
+    // fn(T &) edits a private copy of the record (and of the nodes above it) if anyone else shares them
+    template <class Fn>
+    void update(size_t i, Fn &&fn) {
+        NodePtr *p = &root;
+        for (;;) {
+            Node &n = writable(*p);
+            if (n.leaf) { fn(n.items[i]); return; }
+            size_t first = 0;
+            const size_t c = n.childFor(i, &first);
+            i -= first;
+            p = &n.children[c];
+        }
+    }
+
+    // Emptied nodes are dropped but neighbours are not merged: deletes are rare and the depth never grows from them
+    void erase(size_t i) {
+        eraseAt(root, i);
+        --count;
+        while (root && !root->leaf && root->children.size() == 1) {
+            NodePtr only = root->children.front();
+            root = std::move(only);
+        }
+        if (!count) root.reset();
+    }
+
+private:
+    // The node behind p, copied first unless this vector is its only owner. A count of one means no
+    // other thread can reach it any more; the fence orders that thread's last reads before our writes.
+    static Node &writable(NodePtr &p) {
+        if (p.use_count() == 1) std::atomic_thread_fence(std::memory_order_acquire);
+        else p = std::make_shared<Node>(*p);
+        return *p;
+    }
+
+    // Returns the new right sibling if the node split. Appends split off only the new element,
+    // so a vector built by push_back has full leaves
+    static NodePtr insertAt(NodePtr &p, size_t i, T &&v) {
+        Node &n = writable(p);
+        if (n.leaf) {
+            n.items.insert(n.items.begin() + std::ptrdiff_t(i), std::move(v));
+            if (n.items.size() <= LeafMax) return nullptr;
+            const size_t keep = i + 1 == n.items.size() ? LeafMax : n.items.size() / 2;
+            auto right = std::make_shared<Node>();
+            right->items.assign(std::make_move_iterator(n.items.begin() + std::ptrdiff_t(keep)), std::make_move_iterator(n.items.end()));
+            n.items.resize(keep);
+            return right;
+        }
+        size_t first = 0;
+        const size_t c = n.childFor(i, &first);
+        if (NodePtr extra = insertAt(n.children[c], i - first, std::move(v)))
+            n.children.insert(n.children.begin() + std::ptrdiff_t(c) + 1, std::move(extra));
+        n.recount();
+        if (n.children.size() <= BranchMax) return nullptr;
+        const size_t keep = c + 2 == n.children.size() ? BranchMax : n.children.size() / 2;
+        auto right = std::make_shared<Node>();
+        right->leaf = false;
+        right->children.assign(std::make_move_iterator(n.children.begin() + std::ptrdiff_t(keep)), std::make_move_iterator(n.children.end()));
+        n.children.resize(keep);
+        n.recount();
+        right->recount();
+        return right;
+    }
+
+    static void eraseAt(NodePtr &p, size_t i) {
+        Node &n = writable(p);
+        if (n.leaf) { n.items.erase(n.items.begin() + std::ptrdiff_t(i)); return; }
+        size_t first = 0;
+        const size_t c = n.childFor(i, &first);
+        eraseAt(n.children[c], i - first);
+        if (n.children[c]->size() == 0) n.children.erase(n.children.begin() + std::ptrdiff_t(c));
+        n.recount();
+    }
+
+    NodePtr root;
+    size_t count = 0;
+};
+
+#endif // PERSISTENTVECTOR_H
@@ -0,0 +1,167 @@
+// progress.cpp
+#include "progress.h"
+#include "records.h"
+#include "tracing.h"
+
+#include <QDate>
+#include <QHash>
+#include <algorithm>
+#include <cmath>
+
+const std::vector<double> &ExerciseSeries::values(ProgressMetric m) const
+{
+    switch (m) {
+    case ProgressMetric::Volume: return volume;
+    case ProgressMetric::TopSet: return topSet;
+    case ProgressMetric::E1RM: return e1rm;
+    case ProgressMetric::Intensity: break;
+    }
+    return intensity;
+}
+
+namespace Progress {
+
+// Reductions keep four independent accumulators so the adds are not one serial dependency chain;
+// this is what lets the loops vectorize without -ffast-math.
+constexpr int Lanes = 4;
+
+void movingAverage(const double *y, int n, int window, double *out)
+{
+    if (window < 1) window = 1;
+    double sum = 0;
+    for (int i = 0; i < n; ++i) {
+        sum += y[i];
+        if (i >= window) sum -= y[i - window];
+        out[i] = sum / (i < window ? i + 1 : window);
+    }
+}
+
+LinearFit linearFit(const double *x, const double *y, int n)
+{
+    LinearFit f;
+    if (n < 1) return f;
+    // x is centred on its first value: julian days (~2.46e6) squared would swamp the sums
+    const double x0 = x[0];
+    double sx[Lanes] = {}, sy[Lanes] = {}, sxx[Lanes] = {}, sxy[Lanes] = {}, syy[Lanes] = {};
+    int i = 0;
+    for (; i + Lanes <= n; i += Lanes) {
+        for (int l = 0; l < Lanes; ++l) {
+            const double xv = x[i + l] - x0, yv = y[i + l];
+            sx[l] += xv; sy[l] += yv; sxx[l] += xv * xv; sxy[l] += xv * yv; syy[l] += yv * yv;
+        }
+    }
+    for (; i < n; ++i) {
+        const double xv = x[i] - x0, yv = y[i];
+        sx[0] += xv; sy[0] += yv; sxx[0] += xv * xv; sxy[0] += xv * yv; syy[0] += yv * yv;
+    }
+    double Sx = 0, Sy = 0, Sxx = 0, Sxy = 0, Syy = 0;
+    for (int l = 0; l < Lanes; ++l) { Sx += sx[l]; Sy += sy[l]; Sxx += sxx[l]; Sxy += sxy[l]; Syy += syy[l]; }
+
+    const double den = n * Sxx - Sx * Sx;
+    if (den <= 0) { f.intercept = Sy / n; return f; } // all sessions on one day
+    const double num = n * Sxy - Sx * Sy;
+    f.slope = num / den;
+    f.intercept = (Sy - f.slope * Sx) / n - f.slope * x0;
+    const double vy = n * Syy - Sy * Sy;
+    f.r2 = vy > 0 ? (num * num) / (den * vy) : 0.0;
+    return f;
+}
+
+double maxOf(const double *y, int n)
+{
+    double m[Lanes] = {};
+    int i = 0;
+    for (; i + Lanes <= n; i += Lanes)
+        for (int l = 0; l < Lanes; ++l) m[l] = std::max(m[l], y[i + l]);
+    for (; i < n; ++i) m[0] = std::max(m[0], y[i]);
+    return std::max(std::max(m[0], m[1]), std::max(m[2], m[3]));
+}
+
+std::vector<ExerciseSeries> buildSeries(const PersistentVector<StrengthWorkout> &workouts)
+{
+    FT_TRACE_SCOPE("Progress::buildSeries");
+    struct Session { qint64 day; double volume, topSet, e1rm; int reps; };
+    QHash<QString, int> byKey;
+    std::vector<QString> names;
+    std::vector<std::vector<Session>> sessions;
+
+    for (auto &w : workouts) {
+        const QDate d = QDate::fromString(w.date, "yyyy-MM-dd");
+        if (!d.isValid()) continue;
+        for (auto &e : w.exercises) {
+            const QString key = e.name.trimmed().toLower();
+            if (key.isEmpty()) continue;
+            auto it = byKey.find(key);
+            if (it == byKey.end()) { it = byKey.insert(key, (int)names.size()); names.push_back(e.name.trimmed()); sessions.emplace_back(); }
+            Session s{d.toJulianDay(), e.volume, 0, 0, 0};
+            for (auto &set : e.sets) {
+                if (set.reps <= 0) continue;
+                s.reps += set.reps;
+                s.topSet = std::max(s.topSet, set.weight);
+                s.e1rm = std::max(s.e1rm, PersonalRecords::epley(set.weight, set.reps));
+            }
+            if (s.reps > 0) sessions[*it].push_back(s);
+        }
+    }
+
+    std::vector<ExerciseSeries> out(names.size());
+    for (size_t k = 0; k < names.size(); ++k) {
+        auto &ss = sessions[k];
+        std::stable_sort(ss.begin(), ss.end(), [](const Session &a, const Session &b) { return a.day < b.day; });
+        // the same exercise twice on one day counts as one session
+        std::vector<Session> merged;
+        merged.reserve(ss.size());
+        for (const Session &s : ss) {
+            if (!merged.empty() && merged.back().day == s.day) {
+                Session &m = merged.back();
+                m.volume += s.volume; m.reps += s.reps;
+                m.topSet = std::max(m.topSet, s.topSet); m.e1rm = std::max(m.e1rm, s.e1rm);
+            } else merged.push_back(s);
+        }
+        ExerciseSeries &es = out[k];
+        es.name = names[k];
+        const size_t n = merged.size();
+        es.day.resize(n); es.volume.resize(n); es.topSet.resize(n); es.e1rm.resize(n); es.intensity.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            es.day[i] = double(merged[i].day);
+            es.volume[i] = merged[i].volume;
+            es.topSet[i] = merged[i].topSet;
+            es.e1rm[i] = merged[i].e1rm;
+            es.intensity[i] = merged[i].volume / merged[i].reps;
+        }
+    }
+    std::sort(out.begin(), out.end(), [](const ExerciseSeries &a, const ExerciseSeries &b) {
+        return a.name.compare(b.name, Qt::CaseInsensitive) < 0;
+    });
+    return out;
+}
+
+Trend analyze(const ExerciseSeries &s, ProgressMetric m, int window)
+{
+    Trend t;
+    const std::vector<double> &y = s.values(m);
+    const int n = s.size();
+    t.sessions = n;
+    if (n == 0) return t;
+    t.latest = y[n - 1];
+
+    const int w = std::min(std::max(window, 2), n);
+    const int start = n - w;
+    double sum = 0;
+    for (int i = start; i < n; ++i) sum += y[i];
+    t.movingAvg = sum / w;
+    if (w >= 2) {
+        const LinearFit f = linearFit(s.day.data() + start, y.data() + start, w);
+        t.slopePerWeek = f.slope * 7.0;
+        t.pctPerMonth = t.movingAvg > 0 ? f.slope * 30.0 / t.movingAvg * 100.0 : 0.0;
+    }
+    // plateau: a full window after some history, no new best inside it, and under 1% drift a month
+    if (start >= 2 && w >= 4) {
+        const double prior = maxOf(y.data(), start);
+        const double recent = maxOf(y.data() + start, w);
+        t.plateau = recent <= prior && std::abs(t.pctPerMonth) < 1.0;
+    }
+    return t;
+}
+
+} // namespace Progress
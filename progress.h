@@ -0,0 +1,54 @@
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+// FitTrack Pro - per-exercise progressive-overload series and trend kernels
+// Each exercise's history is stored column-wise (one contiguous array per metric) so the kernels
+// below are plain loops over double arrays that the compiler can unroll and vectorize.
+#include <QString>
+#include <vector>
+#include "models.h"
+
+enum class ProgressMetric { Volume, TopSet, E1RM, Intensity };
+
+struct ExerciseSeries {
+    QString name;
+    std::vector<double> day;       // julian day of each session, ascending
+    std::vector<double> volume;    // reps * weight for the session
+    std::vector<double> topSet;    // heaviest set weight
+    std::vector<double> e1rm;      // best Epley estimate
+    std::vector<double> intensity; // volume / reps, i.e. average kg per rep
+    int size() const { return (int)day.size(); }
+    const std::vector<double> &values(ProgressMetric m) const;
+};
+
+struct LinearFit { double slope = 0, intercept = 0, r2 = 0; };
+
+struct Trend {
+    int sessions = 0;
+    double latest = 0;
+    double movingAvg = 0;     // mean of the trailing window
+    double slopePerWeek = 0;  // regression slope over the trailing window
+    double pctPerMonth = 0;   // slope relative to the window mean
+    bool plateau = false;     // no new best and a flat slope over the trailing window
+};
+
+namespace Progress {
+
+// Sessions in the trailing window: the table's moving average and trend and the chart's smoothed
+// line use the same one, so both show the same value for an exercise
+constexpr int TrendWindow = 8;
+
+// Kernels: x, y and out are contiguous arrays of length n
+void movingAverage(const double *y, int n, int window, double *out);
+LinearFit linearFit(const double *x, const double *y, int n);
+double maxOf(const double *y, int n);
+
+// One series per exercise name (case-insensitive), sessions sorted by date
+std::vector<ExerciseSeries> buildSeries(const PersistentVector<StrengthWorkout> &workouts);
+
+// Trend of one metric over the last `window` sessions
+Trend analyze(const ExerciseSeries &s, ProgressMetric m, int window = TrendWindow);
+
+} // namespace Progress
+
+#endif // PROGRESS_H
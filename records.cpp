@@ -0,0 +1,171 @@
+// records.cpp
+#include "records.h"
+#include "tracing.h"
+
+#include <algorithm>
+
+namespace {
+
+enum class Kind { Heaviest, Epley, Brzycki, Reps, Volume };
+
+QString exerciseKey(const QString &name) { return name.trimmed().toLower(); } // goals match names case-insensitively too
+
+// Calls f(key, name, kind, mark, weight) for every mark `w` contributes. Set marks come first and each
+// exercise's session volume last, so remove() can drop an exercise once its volume marks are gone.
+template <class F>
+void forEachMark(const StrengthWorkout &w, F &&f)
+{
+    QHash<QString, std::pair<QString, double>> volumes; // an exercise may appear twice in one workout
+    QStringList order;
+    for (auto &e : w.exercises) {
+        const QString k = exerciseKey(e.name);
+        if (k.isEmpty()) continue;
+        if (!volumes.contains(k)) order << k;
+        auto &v = volumes[k];
+        v.first = e.name.trimmed();
+        v.second += e.volume;
+        for (auto &s : e.sets) {
+            if (s.reps <= 0) continue;
+            f(k, v.first, Kind::Heaviest, PrMark{s.weight, w.date}, s.weight);
+            f(k, v.first, Kind::Epley, PrMark{PersonalRecords::epley(s.weight, s.reps), w.date}, s.weight);
+            if (s.reps <= 36) f(k, v.first, Kind::Brzycki, PrMark{PersonalRecords::brzycki(s.weight, s.reps), w.date}, s.weight);
+            f(k, v.first, Kind::Reps, PrMark{double(s.reps), w.date}, s.weight);
+        }
+    }
+    for (const QString &k : order) {
+        const auto &v = volumes[k];
+        f(k, v.first, Kind::Volume, PrMark{v.second, w.date}, 0.0);
+    }
+}
+
+std::multiset<PrMark> &marksFor(ExerciseRecords &r, Kind kind, double weight)
+{
+    switch (kind) {
+    case Kind::Heaviest: return r.heaviest;
+    case Kind::Epley: return r.epley;
+    case Kind::Brzycki: return r.brzycki;
+    case Kind::Reps: return r.repsAtWeight[weight];
+    case Kind::Volume: break;
+    }
+    return r.sessionVolume;
+}
+
+bool beats(const std::multiset<PrMark> &s, double v)
+{
+    const PrMark *b = ExerciseRecords::best(s);
+    return b && v > b->value + 1e-9;
+}
+
+} // namespace
+
+const PrMark *ExerciseRecords::bestRepsMark(double weight) const
+{
+    auto it = repsAtWeight.find(weight);
+    return it == repsAtWeight.end() ? nullptr : best(it->second);
+}
+
+double PersonalRecords::epley(double weight, int reps)
+{
+    return reps <= 1 ? weight : weight * (1.0 + reps / 30.0);
+}
+
+double PersonalRecords::brzycki(double weight, int reps)
+{
+    if (reps < 1 || reps > 36) return 0.0;
+    return weight * 36.0 / (37.0 - reps);
+}
+
+void PersonalRecords::rebuild(const PersistentVector<StrengthWorkout> &workouts)
+{
+    FT_TRACE_SCOPE("PersonalRecords::rebuild");
+    index.clear();
+    for (auto &w : workouts) add(w);
+}
+
+void PersonalRecords::add(const StrengthWorkout &w)
+{
+    forEachMark(w, [this](const QString &k, const QString &name, Kind kind, const PrMark &m, double weight) {
+        ExerciseRecords &r = index[k];
+        r.name = name;
+        marksFor(r, kind, weight).insert(m);
+    });
+}
+
+void PersonalRecords::remove(const StrengthWorkout &w)
+{
+    forEachMark(w, [this](const QString &k, const QString &, Kind kind, const PrMark &m, double weight) {
+        auto it = index.find(k);
+        if (it == index.end()) return;
+        ExerciseRecords &r = *it;
+        if (kind == Kind::Reps) {
+            auto rw = r.repsAtWeight.find(weight);
+            if (rw == r.repsAtWeight.end()) return;
+            auto one = rw->second.find(m);
+            if (one != rw->second.end()) rw->second.erase(one);
+            if (rw->second.empty()) r.repsAtWeight.erase(rw);
+            return;
+        }
+        std::multiset<PrMark> &s = marksFor(r, kind, weight);
+        auto one = s.find(m); // erase a single equal mark: another workout may hold the same value
+        if (one != s.end()) s.erase(one);
+        if (r.sessionVolume.empty()) index.erase(it);
+    });
+}
+
+QStringList PersonalRecords::newRecords(const StrengthWorkout &w) const
+{
+    struct Candidate {
+        QString name;
+        double heaviest = 0, epley = 0, brzycki = 0, volume = 0;
+        std::map<double, int> reps;
+    };
+    QHash<QString, Candidate> cands;
+    QStringList order;
+    forEachMark(w, [&](const QString &k, const QString &name, Kind kind, const PrMark &m, double weight) {
+        if (!cands.contains(k)) order << k;
+        Candidate &c = cands[k];
+        c.name = name;
+        switch (kind) {
+        case Kind::Heaviest: c.heaviest = qMax(c.heaviest, m.value); break;
+        case Kind::Epley: c.epley = qMax(c.epley, m.value); break;
+        case Kind::Brzycki: c.brzycki = qMax(c.brzycki, m.value); break;
+        case Kind::Reps: c.reps[weight] = qMax(c.reps[weight], (int)m.value); break;
+        case Kind::Volume: c.volume = m.value; break;
+        }
+    });
+
+    QStringList out;
+    for (const QString &k : order) {
+        auto it = index.constFind(k);
+        if (it == index.cend()) continue; // first time logged: nothing to beat
+        const ExerciseRecords &r = *it;
+        const Candidate &c = cands[k];
+        if (beats(r.heaviest, c.heaviest)) out << QString("%1: heaviest %2 kg").arg(c.name).arg(c.heaviest);
+        if (beats(r.epley, c.epley)) out << QString("%1: est. 1RM %2 kg").arg(c.name).arg(c.epley, 0, 'f', 1);
+        else if (beats(r.brzycki, c.brzycki)) out << QString("%1: est. 1RM %2 kg").arg(c.name).arg(c.brzycki, 0, 'f', 1);
+        // rep PRs only count at weights lifted before; report the heaviest one
+        for (auto rw = c.reps.rbegin(); rw != c.reps.rend(); ++rw) {
+            const int prev = r.bestRepsAt(rw->first);
+            if (prev > 0 && rw->second > prev) { out << QString("%1: %2 reps @ %3 kg").arg(c.name).arg(rw->second).arg(rw->first); break; }
+        }
+        if (beats(r.sessionVolume, c.volume)) out << QString("%1: session volume %2 kg").arg(c.name).arg((int)c.volume);
+    }
+    return out;
+}
+
+const ExerciseRecords *PersonalRecords::find(const QString &exercise) const
+{
+    auto it = index.constFind(exerciseKey(exercise));
+    return it == index.cend() ? nullptr : &*it;
+}
+
+std::vector<const ExerciseRecords*> PersonalRecords::all() const
+{
+    std::vector<const ExerciseRecords*> out;
+    out.reserve(index.size());
+    for (const ExerciseRecords &r : index) out.push_back(&r);
+    std::sort(out.begin(), out.end(), [](const ExerciseRecords *a, const ExerciseRecords *b) {
+        return a->name.compare(b->name, Qt::CaseInsensitive) < 0;
+    });
+    return out;
+}
@@ -0,0 +1,55 @@
+#ifndef RECORDS_H
+#define RECORDS_H
+
+// FitTrack Pro - per-exercise personal-record index
+// Every qualifying set/session contributes one mark to an ordered multiset, so add() and remove()
+// are exact inverses (deleting a workout rolls its records back) and the current best is rbegin().
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <map>
+#include <set>
+#include "models.h"
+
+struct PrMark {
+    double value;
+    QString date;
+    // ascending by value; among equal values the earliest date sorts last, so rbegin() is the first time it was hit
+    bool operator<(const PrMark &o) const { return value != o.value ? value < o.value : date > o.date; }
+};
+
+struct ExerciseRecords {
+    QString name; // display name as last logged
+    std::multiset<PrMark> heaviest;      // set weight
+    std::multiset<PrMark> epley;         // estimated 1RM, weight * (1 + reps / 30)
+    std::multiset<PrMark> brzycki;       // estimated 1RM, weight * 36 / (37 - reps)
+    std::multiset<PrMark> sessionVolume; // reps * weight summed per workout
+    std::map<double, std::multiset<PrMark>> repsAtWeight; // weight -> reps marks
+
+    static const PrMark *best(const std::multiset<PrMark> &s) { return s.empty() ? nullptr : &*s.rbegin(); }
+    const PrMark *bestRepsMark(double weight) const;
+    int bestRepsAt(double weight) const { const PrMark *m = bestRepsMark(weight); return m ? (int)m->value : 0; }
+};
+
+class PersonalRecords {
+public:
+    void clear() { index.clear(); }
+    void rebuild(const PersistentVector<StrengthWorkout> &workouts);
+    void add(const StrengthWorkout &w);
+    void remove(const StrengthWorkout &w);
+
+    // Records `w` would set if added, e.g. "Bench Press: heaviest 100 kg"; exercises logged for the first time are not flagged
+    QStringList newRecords(const StrengthWorkout &w) const;
+
+    const ExerciseRecords *find(const QString &exercise) const;
+    std::vector<const ExerciseRecords*> all() const; // sorted by name
+    bool isEmpty() const { return index.isEmpty(); }
+
+    static double epley(double weight, int reps);
+    static double brzycki(double weight, int reps); // 0 when reps is outside 1..36
+
+private:
+    QHash<QString, ExerciseRecords> index;
+};
+
+#endif // RECORDS_H
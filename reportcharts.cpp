@@ -0,0 +1,145 @@
+// reportcharts.cpp
+#include "reportcharts.h"
+#include "tracing.h"
+
+#include <QPainter>
+
+namespace {
+
+const QColor Palette[] = {QColor("#FF5F1F"), QColor("#FFB86B"), QColor("#3FA7D6"), QColor("#59CD90"),
+                          QColor("#FAC05E"), QColor("#EE6352"), QColor("#9B5DE5"), QColor("#7BDFF2")};
+constexpr int PaletteSize = int(sizeof(Palette) / sizeof(Palette[0]));
+
+void drawEmpty(QPainter &p, const QRectF &r, const QString &text, const ReportCharts::Theme &theme)
+{
+    p.setPen(theme.muted);
+    p.drawText(r, Qt::AlignCenter, text);
+}
+
+} // namespace
+
+namespace ReportCharts {
+
+Theme Theme::screen() { return {QColor(5, 18, 27), QColor("#ffffff"), QColor("#b8c8d8")}; }
+Theme Theme::print() { return {QColor("#ffffff"), QColor("#1a1a1a"), QColor("#666666")}; }
+
+void drawShare(QPainter &p, const QRectF &r, const QStringList &labels, const QVector<double> &values,
+               const QString &unit, const Theme &theme)
+{
+    p.save();
+    p.setRenderHint(QPainter::Antialiasing);
+    p.fillRect(r, theme.background);
+    double total = 0;
+    for (double v : values) total += v;
+    if (total <= 0) { drawEmpty(p, r, "No cardio in this range", theme); p.restore(); return; }
+
+    const double side = qMin(r.height() - 24, r.width() / 2 - 24);
+    const QRectF pie(r.left() + 12, r.top() + (r.height() - side) / 2.0, side, side);
+    double angle = 90 * 16; // start at 12 o'clock, clockwise
+    for (int i = 0; i < values.size(); ++i) {
+        const double span = -values[i] / total * 360 * 16;
+        p.setPen(QPen(theme.background, 2));
+        p.setBrush(Palette[i % PaletteSize]);
+        p.drawPie(pie, int(angle), int(span));
+        angle += span;
+    }
+    // donut hole
+    p.setPen(Qt::NoPen);
+    p.setBrush(theme.background);
+    p.drawEllipse(pie.center(), side * 0.3, side * 0.3);
+
+    const double lx = pie.right() + 20, lineH = p.fontMetrics().height() * 1.4;
+    for (int i = 0; i < values.size(); ++i) {
+        const double y = r.top() + 16 + i * lineH;
+        if (y + lineH > r.bottom()) break;
+        const double box = p.fontMetrics().height() * 0.7;
+        p.setPen(Qt::NoPen);
+        p.setBrush(Palette[i % PaletteSize]);
+        p.drawRoundedRect(QRectF(lx, y + (lineH - box) / 2, box, box), 3, 3);
+        p.setPen(theme.text);
+        p.drawText(QRectF(lx + box + 6, y, r.right() - lx - box - 8, lineH), Qt::AlignLeft | Qt::AlignVCenter,
+                   QString("%1  %2% (%3 %4)").arg(labels.value(i)).arg(values[i] / total * 100, 0, 'f', 0).arg(values[i], 0, 'f', 0).arg(unit));
+    }
+    p.restore();
+}
+
+void drawRankedBars(QPainter &p, const QRectF &r, const QStringList &labels, const QVector<double> &values,
+                    const QString &unit, const Theme &theme)
+{
+    p.save();
+    p.setRenderHint(QPainter::Antialiasing);
+    p.fillRect(r, theme.background);
+    if (values.isEmpty()) { drawEmpty(p, r, "No strength workouts in this range", theme); p.restore(); return; }
+
+    double hi = 0;
+    for (double v : values) hi = qMax(hi, v);
+    const double labelW = qMin(r.width() / 3, p.fontMetrics().averageCharWidth() * 20.0);
+    const double valueW = p.fontMetrics().averageCharWidth() * 11.0;
+    const double rowH = qMin(p.fontMetrics().height() * 1.6, (r.height() - 12.0) / values.size());
+    const double barMax = qMax(10.0, r.width() - labelW - valueW - 24);
+    for (int i = 0; i < values.size(); ++i) {
+        const double y = r.top() + 6 + i * rowH;
+        p.setPen(theme.text);
+        p.drawText(QRectF(r.left() + 6, y, labelW - 8, rowH), Qt::AlignRight | Qt::AlignVCenter,
+                   p.fontMetrics().elidedText(labels.value(i), Qt::ElideRight, int(labelW - 8)));
+        const double w = hi > 0 ? values[i] / hi * barMax : 0;
+        p.setPen(Qt::NoPen);
+        p.setBrush(labels.value(i) == "Other" ? QColor(60, 90, 110) : Palette[0]);
+        p.drawRoundedRect(QRectF(r.left() + labelW + 4, y + rowH * 0.2, qMax(2.0, w), rowH * 0.6), 3, 3);
+        p.setPen(theme.muted);
+        p.drawText(QRectF(r.left() + labelW + 10 + w, y, valueW, rowH), Qt::AlignLeft | Qt::AlignVCenter,
+                   QString("%1 %2").arg(values[i], 0, 'f', 0).arg(unit));
+    }
+    p.restore();
+}
+
+void foldTail(QStringList &labels, QVector<double> &values, int maxBars)
+{
+    if (values.size() <= maxBars) return;
+    double other = 0;
+    for (int i = maxBars - 1; i < values.size(); ++i) other += values[i];
+    labels = labels.mid(0, maxBars - 1);
+    values.resize(maxBars - 1);
+    labels << "Other"; values << other;
+}
+
+} // namespace ReportCharts
+
+ShareChart::ShareChart(QWidget *parent) : QWidget(parent)
+{
+    setMinimumHeight(200);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+void ShareChart::setData(const QStringList &labels, const QVector<double> &values, const QString &unit)
+{
+    names = labels; vals = values; units = unit;
+    update();
+}
+
+void ShareChart::paintEvent(QPaintEvent *)
+{
+    FT_TRACE_SCOPE("ShareChart::paint");
+    QPainter p(this);
+    ReportCharts::drawShare(p, rect(), names, vals, units, ReportCharts::Theme::screen());
+}
+
+RankedBarChart::RankedBarChart(QWidget *parent) : QWidget(parent)
+{
+    setMinimumHeight(200);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+void RankedBarChart::setData(const QStringList &labels, const QVector<double> &values, const QString &unit)
+{
+    names = labels; vals = values; units = unit;
+    ReportCharts::foldTail(names, vals, maxBars);
+    update();
+}
+
+void RankedBarChart::paintEvent(QPaintEvent *)
+{
+    FT_TRACE_SCOPE("RankedBarChart::paint");
+    QPainter p(this);
+    ReportCharts::drawRankedBars(p, rect(), names, vals, units, ReportCharts::Theme::screen());
+}
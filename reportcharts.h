@@ -0,0 +1,64 @@
+#ifndef REPORTCHARTS_H
+#define REPORTCHARTS_H
+
+// FitTrack Pro - charts for the Reports tab and the PDF report; they only draw datasets computed elsewhere
+#include <QColor>
+#include <QRectF>
+#include <QStringList>
+#include <QVector>
+#include <QWidget>
+
+class QPainter;
+
+namespace ReportCharts {
+
+struct Theme {
+    QColor background, text, muted;
+    static Theme screen(); // the app's dark cards
+    static Theme print();  // white paper
+};
+
+// Plain painting, usable from any thread on a QImage or QPdfWriter
+void drawShare(QPainter &p, const QRectF &r, const QStringList &labels, const QVector<double> &values,
+               const QString &unit, const Theme &theme);
+void drawRankedBars(QPainter &p, const QRectF &r, const QStringList &labels, const QVector<double> &values,
+                    const QString &unit, const Theme &theme);
+
+// Keeps the first maxBars - 1 entries (values largest first) and sums the rest into "Other"
+void foldTail(QStringList &labels, QVector<double> &values, int maxBars);
+
+} // namespace ReportCharts
+
+// Donut of shares with a legend (activity distribution)
+class ShareChart : public QWidget {
+public:
+    explicit ShareChart(QWidget *parent = nullptr);
+    void setData(const QStringList &labels, const QVector<double> &values, const QString &unit);
+
+protected:
+    void paintEvent(QPaintEvent *) override;
+
+private:
+    QStringList names;
+    QVector<double> vals;
+    QString units;
+};
+
+// Horizontal bars, largest first (volume by exercise); everything past maxBars is folded into "Other"
+class RankedBarChart : public QWidget {
+public:
+    explicit RankedBarChart(QWidget *parent = nullptr);
+    void setData(const QStringList &labels, const QVector<double> &values, const QString &unit);
+
+    static constexpr int maxBars = 10;
+
+protected:
+    void paintEvent(QPaintEvent *) override;
+
+private:
+    QStringList names;
+    QVector<double> vals;
+    QString units;
+};
+
+#endif // REPORTCHARTS_H
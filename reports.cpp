@@ -0,0 +1,113 @@
+// reports.cpp
+#include "reports.h"
+#include "tracing.h"
+
+#include <QHash>
+#include <algorithm>
+
+namespace {
+
+constexpr int CancelStride = 4096; // records between cancellation checks
+constexpr int WeightAvgWindow = 7;
+
+int monthIndex(const QDate &d) { return d.year() * 12 + d.month() - 1; }
+
+} // namespace
+
+namespace Reports {
+
+QDate rangeStart(Range r, const ReportSnapshot &s, const QDate &today)
+{
+    const QDate thisMonth(today.year(), today.month(), 1);
+    switch (r) {
+    case Range::Months3: return thisMonth.addMonths(-2);
+    case Range::Months6: return thisMonth.addMonths(-5);
+    case Range::Months12: return thisMonth.addMonths(-11);
+    case Range::AllTime: break;
+    }
+    QDate first = thisMonth;
+    auto consider = [&](const QString &date) {
+        const QDate d = QDate::fromString(date, "yyyy-MM-dd");
+        if (d.isValid() && d < first) first = d;
+    };
+    for (auto &w : s.cardio) consider(w.date);
+    for (auto &w : s.strength) consider(w.date);
+    for (auto &b : s.weightLogs) consider(b.date);
+    return QDate(first.year(), first.month(), 1);
+}
+
+bool compute(const ReportSnapshot &s, const QDate &from, const QDate &to, ReportData &out,
+             const std::function<bool()> &cancelled)
+{
+    FT_TRACE_SCOPE("Reports::compute");
+    auto stop = [&](size_t i) { return cancelled && i % CancelStride == 0 && cancelled(); };
+
+    out = ReportData();
+    out.from = from; out.to = to;
+    const int m0 = monthIndex(from), m1 = monthIndex(to);
+    if (m1 < m0) return true;
+    out.months.resize(size_t(m1 - m0 + 1));
+    for (int m = 0; m <= m1 - m0; ++m) out.months[size_t(m)].month = QDate(from.year(), from.month(), 1).addMonths(m);
+
+    // parse each date once; records outside the range map to nullptr
+    auto bucket = [&](const QString &date) -> MonthSummary * {
+        const QDate d = QDate::fromString(date, "yyyy-MM-dd");
+        if (!d.isValid() || d < from || d > to) return nullptr;
+        return &out.months[size_t(monthIndex(d) - m0)];
+    };
+
+    QHash<QString, size_t> typeIdx;
+    size_t i = 0;
+    for (const CardioWorkout &w : s.cardio) {
+        if (stop(i++)) return false;
+        MonthSummary *m = bucket(w.date);
+        if (!m) continue;
+        m->cardioSessions++; m->cardioMinutes += w.duration; m->cardioKm += w.distance; m->cardioKcal += w.calories;
+        auto it = typeIdx.find(w.type);
+        if (it == typeIdx.end()) { it = typeIdx.insert(w.type, out.activities.size()); out.activities.push_back({w.type}); }
+        ActivityShare &a = out.activities[*it];
+        a.sessions++; a.minutes += w.duration; a.km += w.distance;
+    }
+
+    QHash<QString, size_t> exIdx; // case-insensitive, first spelling wins (as in the Progress tab)
+    i = 0;
+    for (const StrengthWorkout &w : s.strength) {
+        if (stop(i++)) return false;
+        MonthSummary *m = bucket(w.date);
+        if (!m) continue;
+        m->strengthWorkouts++; m->strengthVolume += w.totalVolume; m->strengthKcal += w.calories;
+        for (const Exercise &e : w.exercises) {
+            const QString key = e.name.toLower();
+            auto it = exIdx.find(key);
+            if (it == exIdx.end()) { it = exIdx.insert(key, out.exercises.size()); out.exercises.push_back({e.name}); }
+            out.exercises[*it].volume += e.volume;
+            out.exercises[*it].sessions++;
+        }
+    }
+
+    std::vector<std::pair<qint64, double>> weighIns;
+    i = 0;
+    for (const BodyweightLog &b : s.weightLogs) {
+        if (stop(i++)) return false;
+        const QDate d = QDate::fromString(b.date, "yyyy-MM-dd");
+        if (!d.isValid() || d < from || d > to) continue;
+        MonthSummary &m = out.months[size_t(monthIndex(d) - m0)];
+        m.avgWeight += b.weight; m.weighIns++;
+        weighIns.emplace_back(d.toJulianDay(), b.weight);
+    }
+    for (MonthSummary &m : out.months) if (m.weighIns) m.avgWeight /= m.weighIns;
+    if (cancelled && cancelled()) return false;
+
+    std::sort(out.activities.begin(), out.activities.end(), [](const ActivityShare &a, const ActivityShare &b) { return a.minutes > b.minutes; });
+    std::sort(out.exercises.begin(), out.exercises.end(), [](const ExerciseVolume &a, const ExerciseVolume &b) { return a.volume > b.volume; });
+
+    std::stable_sort(weighIns.begin(), weighIns.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    out.weightDay.reserve(weighIns.size()); out.weight.reserve(weighIns.size());
+    for (const auto &e : weighIns) { out.weightDay.push_back(double(e.first)); out.weight.push_back(e.second); }
+    out.weightAvg.resize(out.weight.size());
+    Progress::movingAverage(out.weight.data(), (int)out.weight.size(), WeightAvgWindow, out.weightAvg.data());
+    out.weightFit = Progress::linearFit(out.weightDay.data(), out.weight.data(), (int)out.weight.size());
+    return true;
+}
+
+} // namespace Reports
@@ -0,0 +1,56 @@
+#ifndef REPORTS_H
+#define REPORTS_H
+
+// FitTrack Pro - report datasets (monthly summary, activity mix, volume by exercise, bodyweight)
+// compute() runs on a worker thread over an immutable snapshot of one member's data and polls
+// `cancelled` so a newer request (e.g. a range change) can abandon it early.
+#include <QDate>
+#include <QString>
+#include <functional>
+#include <vector>
+#include "models.h"
+#include "progress.h"
+
+struct MonthSummary {
+    QDate month; // first day of the month
+    int cardioSessions = 0;
+    int cardioMinutes = 0;
+    double cardioKm = 0, cardioKcal = 0;
+    int strengthWorkouts = 0;
+    double strengthVolume = 0, strengthKcal = 0;
+    int weighIns = 0;
+    double avgWeight = 0; // 0 if no weigh-in that month
+};
+
+struct ActivityShare { QString type; int sessions = 0; int minutes = 0; double km = 0; };
+struct ExerciseVolume { QString name; double volume = 0; int sessions = 0; };
+
+struct ReportData {
+    QDate from, to;
+    std::vector<MonthSummary> months;        // every month of the range, oldest first
+    std::vector<ActivityShare> activities;   // by minutes, largest first
+    std::vector<ExerciseVolume> exercises;   // by volume, largest first
+    std::vector<double> weightDay, weight, weightAvg; // weigh-ins in range by date, 7-entry moving average
+    LinearFit weightFit;
+};
+
+// What the worker reads: snapshots of the member's lists, taken on the GUI thread in O(1)
+struct ReportSnapshot {
+    PersistentVector<CardioWorkout> cardio;
+    PersistentVector<StrengthWorkout> strength;
+    PersistentVector<BodyweightLog> weightLogs;
+};
+
+namespace Reports {
+
+enum class Range { Months3, Months6, Months12, AllTime };
+
+QDate rangeStart(Range r, const ReportSnapshot &s, const QDate &today);
+
+// Returns false (and a partial `out`) if `cancelled` reported true part-way through
+bool compute(const ReportSnapshot &s, const QDate &from, const QDate &to, ReportData &out,
+             const std::function<bool()> &cancelled = {});
+
+} // namespace Reports
+
+#endif // REPORTS_H
@@ -0,0 +1,415 @@
+// routeimport.cpp
+#include "routeimport.h"
+#include "fitfile.h"
+#include "geo.h"
+#include "tracing.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTimeZone>
+#include <QXmlStreamReader>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+int digits(QStringView s, qsizetype at, int n)
+{
+    int v = 0;
+    for (int i = 0; i < n; ++i) {
+        const QChar c = s.at(at + i);
+        if (!c.isDigit()) return -1;
+        v = v * 10 + c.digitValue();
+    }
+    return v;
+}
+
+// Milliseconds since the epoch of an xsd:dateTime. Trackpoint times are almost always
+// "yyyy-MM-ddTHH:mm:ss[.fff](Z|+hh:mm)", parsed here without building a QDateTime per point;
+// anything else goes through QDateTime. Returns false if the text is no date at all.
+bool parseTime(QStringView s, qint64 *ms)
+{
+    s = s.trimmed();
+    if (s.size() >= 19 && s[4] == u'-' && s[7] == u'-' && (s[10] == u'T' || s[10] == u' ') && s[13] == u':' && s[16] == u':') {
+        const int y = digits(s, 0, 4), mo = digits(s, 5, 2), d = digits(s, 8, 2);
+        const int h = digits(s, 11, 2), mi = digits(s, 14, 2), sec = digits(s, 17, 2);
+        qsizetype i = 19;
+        int frac = 0;
+        if (i < s.size() && s[i] == u'.') {
+            int scale = 100;
+            for (++i; i < s.size() && s[i].isDigit(); ++i, scale /= 10) frac += s[i].digitValue() * scale;
+        }
+        int offset = 0; // minutes east of UTC
+        bool zoned = true;
+        if (i < s.size() && s[i] == u'Z') ++i;
+        else if (i + 6 == s.size() && (s[i] == u'+' || s[i] == u'-') && s[i + 3] == u':') {
+            const int oh = digits(s, i + 1, 2), om = digits(s, i + 4, 2);
+            zoned = oh >= 0 && om >= 0;
+            offset = (s[i] == u'-' ? -1 : 1) * (oh * 60 + om);
+            i = s.size();
+        }
+        if (zoned && i == s.size() && y >= 0 && mo >= 1 && mo <= 12 && d >= 1 && d <= 31 && h >= 0 && h < 24 && mi >= 0 && mi < 60 && sec >= 0 && sec < 61) {
+            // days from 1970-01-01 in the proleptic Gregorian calendar
+            const int yy = y - (mo <= 2);
+            const int era = (yy >= 0 ? yy : yy - 399) / 400;
+            const int yoe = yy - era * 400;
+            const int doy = (153 * (mo + (mo > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+            const qint64 days = qint64(era) * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+            *ms = ((days * 24 + h) * 60 + mi - offset) * 60000 + sec * 1000 + frac;
+            return true;
+        }
+    }
+    const QDateTime dt = QDateTime::fromString(s.toString(), Qt::ISODateWithMs);
+    if (!dt.isValid()) return false;
+    *ms = dt.toMSecsSinceEpoch();
+    return true;
+}
+
+// One point while its element is open
+struct Pending {
+    double lat = NaN, lon = NaN, ele = NaN, hr = NaN, cadence = NaN, distance = NaN;
+    qint64 ms = 0;
+    bool timed = false;
+};
+
+void push(Track &t, const Pending &p, qint64 *baseMs)
+{
+    const bool placed = !std::isnan(p.lat) && !std::isnan(p.lon);
+    if (!placed && std::isnan(p.distance)) return; // pauses in a TCX lap: a time and nothing else
+    if (p.timed && !t.start.isValid()) {
+        *baseMs = p.ms;
+        t.start = QDateTime::fromMSecsSinceEpoch(p.ms, QTimeZone::utc());
+    }
+    t.lat.push_back(placed ? p.lat : NaN);
+    t.lon.push_back(placed ? p.lon : NaN);
+    t.ele.push_back(p.ele);
+    t.hr.push_back(p.hr);
+    t.cadence.push_back(p.cadence);
+    t.distance.push_back(p.distance);
+    t.time.push_back(p.timed && t.start.isValid() ? (p.ms - *baseMs) / 1000.0 : NaN);
+}
+
+// NaN when the text or attribute is missing or malformed: a point at 0,0 would add a bogus segment
+double number(QStringView text)
+{
+    bool ok = false;
+    const double v = text.toDouble(&ok);
+    return ok ? v : NaN;
+}
+
+// The FIT sport enum as a name cardioType() understands
+QString fitSport(int sport)
+{
+    switch (sport) {
+    case 1: return "running";
+    case 2: return "cycling";
+    case 5: return "swimming";
+    case 11: return "walking";
+    case 17: return "hiking";
+    }
+    return QString();
+}
+
+constexpr int FitTransition = 3; // the changeover between multisport legs: not a workout of its own
+
+// What a FIT file holds as sessions: its session messages, else the sum of its laps (a watch that
+// stopped before writing the session), else just its records
+std::vector<Fit::Session> fitSessions(const Fit::Activity &a)
+{
+    std::vector<Fit::Session> out = a.sessions;
+    if (out.empty() && !a.laps.empty()) {
+        Fit::Session total;
+        total.start = a.laps.front().start;
+        total.elapsed = total.timer = total.distance = 0;
+        for (const Fit::Lap &l : a.laps) {
+            if (l.elapsed > 0) total.elapsed += l.elapsed;
+            if (l.timer > 0) total.timer += l.timer;
+            if (l.distance > 0) total.distance += l.distance;
+        }
+        out.push_back(total);
+    }
+    if (out.empty() && a.records.size()) {
+        out.emplace_back();
+        out.back().start = a.records.time.front();
+    }
+    std::stable_sort(out.begin(), out.end(), [](const Fit::Session &x, const Fit::Session &y) { return x.start < y.start; });
+    return out;
+}
+
+// Records [from, to) as a Track with times relative to the session start
+void fitTrack(const Fit::Records &r, size_t from, size_t to, int64_t start, Track &t)
+{
+    t.start = QDateTime::fromSecsSinceEpoch(start, QTimeZone::utc());
+    auto slice = [&](const std::vector<double> &v, std::vector<double> &dst) { dst.assign(v.begin() + from, v.begin() + to); };
+    slice(r.lat, t.lat);
+    slice(r.lon, t.lon);
+    slice(r.altitude, t.ele);
+    slice(r.heartRate, t.hr);
+    slice(r.cadence, t.cadence);
+    slice(r.distance, t.distance);
+    t.time.resize(to - from);
+    for (size_t i = from; i < to; ++i) t.time[i - from] = double(r.time[i] - start);
+}
+
+// The device's totals win over what the records add up to: it measured distance with a footpod or
+// wheel sensor where there was no GPS, and its timer knows when auto-pause stopped the clock
+void applySession(const Fit::Session &s, const QString &sport, RouteSummary &out)
+{
+    CardioWorkout &w = out.workout;
+    if (s.elapsed > 0) out.elapsedSeconds = s.elapsed;
+    if (s.timer > 0) out.movingSeconds = s.timer;
+    if (s.distance > 0) w.distance = s.distance / 1000.0;
+    if (s.ascent >= 0) w.elevationGain = s.ascent;
+    if (!w.heartRate.average && s.avgHeartRate) {
+        w.heartRate.average = s.avgHeartRate;
+        w.heartRate.maximum = s.maxHeartRate;
+    }
+    const double active = out.movingSeconds > 0 ? out.movingSeconds : out.elapsedSeconds;
+    w.duration = std::max(1, int(std::lround(active / 60.0)));
+    w.avgSpeed = active > 0 ? w.distance / (active / 3600.0) : 0;
+    w.type = RouteImport::cardioType(sport, w.avgSpeed);
+}
+
+// Encodes the samples under the activity's start time (one activity per id) and drops the arrays:
+// a few KB encoded against ~100 KB decoded, times thousands of files
+void keepSamples(RouteImport::FileResult::Activity &a, const QDateTime &start)
+{
+    if (a.summary.samples.isEmpty()) return;
+    a.summary.workout.samples = QString::number(start.toMSecsSinceEpoch());
+    a.sampleData = SampleStore::encode(a.summary.samples);
+    a.summary.samples = SampleSeries();
+}
+
+// One activity per session, each taking the records from its start to the next session's
+void importFit(QFile &f, int maxHr, RouteImport::FileResult &r)
+{
+    const qint64 size = f.size();
+    uchar *mapped = size > 0 ? f.map(0, size) : nullptr;
+    QByteArray copy;
+    if (!mapped) copy = f.readAll(); // a file system that cannot map
+    Fit::Activity a;
+    const Fit::Status status = mapped ? Fit::decode(mapped, size_t(size), a)
+                                      : Fit::decode(reinterpret_cast<const uint8_t *>(copy.constData()), size_t(copy.size()), a);
+    if (mapped) f.unmap(mapped);
+    if (status != Fit::Status::Ok && status != Fit::Status::Truncated) { r.error = Fit::statusText(status); return; }
+
+    const std::vector<Fit::Session> sessions = fitSessions(a);
+    const std::vector<int64_t> &times = a.records.time;
+    QString error = "no activity in the file";
+    for (size_t k = 0; k < sessions.size(); ++k) {
+        const Fit::Session &s = sessions[k];
+        if (s.sport == FitTransition) continue;
+        const size_t from = k == 0 ? 0 : size_t(std::lower_bound(times.begin(), times.end(), s.start) - times.begin());
+        const size_t to = k + 1 == sessions.size() ? times.size()
+                                                   : size_t(std::lower_bound(times.begin(), times.end(), sessions[k + 1].start) - times.begin());
+        Track t;
+        fitTrack(a.records, from, std::max(from, to), s.start, t);
+        t.sport = fitSport(s.sport);
+        RouteImport::FileResult::Activity act;
+        if (!RouteImport::analyze(t, act.summary, &error, maxHr)) {
+            if (!(s.timer > 0 || s.elapsed > 0)) continue; // neither records nor totals
+            act.summary = RouteSummary(); // a pool swim or a treadmill without a footpod: totals only
+            act.summary.workout.date = t.start.toLocalTime().date().toString("yyyy-MM-dd");
+        }
+        applySession(s, t.sport, act.summary);
+        keepSamples(act, t.start);
+        r.activities.push_back(std::move(act));
+    }
+    if (r.activities.empty()) r.error = error;
+}
+
+} // namespace
+
+namespace RouteImport {
+
+bool parse(QIODevice *dev, Track &out, QString *error)
+{
+    FT_TRACE_SCOPE("RouteImport::parse");
+    enum class Format { Unknown, Gpx, Tcx } format = Format::Unknown;
+    out = Track();
+    QXmlStreamReader xml(dev);
+    Pending p;
+    bool inPoint = false, inTrack = false, inHeartRate = false;
+    qint64 baseMs = 0;
+    while (!xml.atEnd()) {
+        const QXmlStreamReader::TokenType token = xml.readNext();
+        if (token == QXmlStreamReader::StartElement) {
+            const QStringView name = xml.name();
+            if (format == Format::Unknown) {
+                if (name == QLatin1String("gpx")) format = Format::Gpx;
+                else if (name == QLatin1String("TrainingCenterDatabase")) format = Format::Tcx;
+                else { if (error) *error = "not a GPX or TCX file"; return false; }
+                continue;
+            }
+            if (format == Format::Gpx) {
+                if (name == QLatin1String("trkpt") || name == QLatin1String("rtept")) {
+                    p = Pending();
+                    p.lat = number(xml.attributes().value(QLatin1String("lat")));
+                    p.lon = number(xml.attributes().value(QLatin1String("lon")));
+                    inPoint = true;
+                } else if (name == QLatin1String("trk")) {
+                    inTrack = true;
+                } else if (inPoint && name == QLatin1String("ele")) {
+                    p.ele = number(xml.readElementText());
+                } else if (inPoint && name == QLatin1String("time")) {
+                    p.timed = parseTime(xml.readElementText(), &p.ms);
+                } else if (inPoint && (name == QLatin1String("hr") || name == QLatin1String("heartrate"))) {
+                    p.hr = number(xml.readElementText()); // Garmin's TrackPointExtension and most others
+                } else if (inPoint && (name == QLatin1String("cad") || name == QLatin1String("cadence"))) {
+                    p.cadence = number(xml.readElementText());
+                } else if (inTrack && !inPoint && name == QLatin1String("type") && out.sport.isEmpty()) {
+                    out.sport = xml.readElementText().trimmed();
+                }
+            } else {
+                if (name == QLatin1String("Trackpoint")) {
+                    p = Pending();
+                    inPoint = true;
+                } else if (name == QLatin1String("Activity") && out.sport.isEmpty()) {
+                    out.sport = xml.attributes().value(QLatin1String("Sport")).toString();
+                } else if (inPoint && name == QLatin1String("Time")) {
+                    p.timed = parseTime(xml.readElementText(), &p.ms);
+                } else if (inPoint && name == QLatin1String("LatitudeDegrees")) {
+                    p.lat = number(xml.readElementText());
+                } else if (inPoint && name == QLatin1String("LongitudeDegrees")) {
+                    p.lon = number(xml.readElementText());
+                } else if (inPoint && name == QLatin1String("AltitudeMeters")) {
+                    p.ele = number(xml.readElementText());
+                } else if (inPoint && name == QLatin1String("DistanceMeters")) {
+                    p.distance = number(xml.readElementText());
+                } else if (inPoint && name == QLatin1String("HeartRateBpm")) {
+                    inHeartRate = true;
+                } else if (inHeartRate && name == QLatin1String("Value")) {
+                    p.hr = number(xml.readElementText());
+                } else if (inPoint && (name == QLatin1String("Cadence") || name == QLatin1String("RunCadence"))) {
+                    p.cadence = number(xml.readElementText());
+                }
+            }
+        } else if (token == QXmlStreamReader::EndElement) {
+            const QStringView name = xml.name();
+            if (name == QLatin1String("trkpt") || name == QLatin1String("rtept") || name == QLatin1String("Trackpoint")) {
+                if (inPoint) push(out, p, &baseMs);
+                inPoint = false;
+            } else if (name == QLatin1String("trk")) {
+                inTrack = false;
+            } else if (name == QLatin1String("HeartRateBpm")) {
+                inHeartRate = false;
+            }
+        }
+    }
+    if (xml.hasError()) {
+        if (error) *error = QString("line %1: %2").arg(xml.lineNumber()).arg(xml.errorString());
+        return false;
+    }
+    if (format == Format::Unknown) {
+        if (error) *error = "empty file";
+        return false;
+    }
+    return true;
+}
+
+bool analyze(const Track &t, RouteSummary &out, QString *error, int maxHr)
+{
+    FT_TRACE_SCOPE("RouteImport::analyze");
+    const size_t n = t.lat.size();
+    out = RouteSummary();
+    out.points = int(n);
+    if (n < 2) { if (error) *error = "fewer than two track points"; return false; }
+    if (!t.start.isValid()) { if (error) *error = "the track has no timestamps"; return false; }
+
+    std::vector<double> seg(n - 1);
+    Geo::segmentDistances(t.lat.data(), t.lon.data(), n, seg.data());
+    for (size_t i = 0; i + 1 < n; ++i) {
+        if (seg[i] >= 0) continue;
+        const double d = t.distance[i + 1] - t.distance[i]; // no position at either end: the device's own count
+        seg[i] = d > 0 ? d : 0;
+    }
+
+    double metres = 0, lastTime = 0, lastSplit = 0;
+    for (size_t i = 0; i + 1 < n; ++i) {
+        const double t0 = t.time[i], t1 = t.time[i + 1], dt = t1 - t0; // NaN if either is untimed
+        if (dt > 0 && seg[i] >= MinMovingSpeed * dt) out.movingSeconds += dt;
+        if (!std::isnan(t1)) lastTime = std::max(lastTime, t1);
+        // a km mark inside this segment: its time by linear interpolation
+        const double next = metres + seg[i];
+        for (double mark = (double(out.workout.splits.size()) + 1) * 1000; mark <= next; mark += 1000) {
+            if (!(dt > 0)) { out.workout.splits.push_back(0); continue; } // unknown time for this km
+            const double at = t0 + dt * (mark - metres) / seg[i];
+            out.workout.splits.push_back(int(std::lround(at - lastSplit)));
+            lastSplit = at;
+        }
+        metres = next;
+    }
+    out.elapsedSeconds = lastTime;
+
+    // sensor samples: every timed point, speed over the segment that ends there
+    SampleSeries &ss = out.samples;
+    auto any = [](const std::vector<double> &v) { return std::any_of(v.begin(), v.end(), [](double x) { return !std::isnan(x); }); };
+    const bool hasHr = any(t.hr), hasCadence = any(t.cadence), hasEle = any(t.ele);
+    double prevTime = NaN;
+    for (size_t i = 0; i < n; ++i) {
+        if (std::isnan(t.time[i]) || t.time[i] < prevTime) continue; // untimed, or out of order
+        const double dt = t.time[i] - prevTime;
+        ss.time.push_back(std::llround(t.time[i] * 1000));
+        ss.values[SampleSeries::Speed].push_back(i > 0 && dt > 0 && !std::isnan(t.time[i - 1]) ? seg[i - 1] / dt : NaN);
+        if (hasHr) ss.values[SampleSeries::HeartRate].push_back(t.hr[i]);
+        if (hasCadence) ss.values[SampleSeries::Cadence].push_back(t.cadence[i]);
+        if (hasEle) ss.values[SampleSeries::Altitude].push_back(t.ele[i]);
+        prevTime = t.time[i];
+    }
+
+    // hysteresis: a climb counts once it exceeds the threshold over the lowest point since the last one
+    double gain = 0, ref = NaN;
+    for (double e : t.ele) {
+        if (std::isnan(e)) continue;
+        if (std::isnan(ref) || e < ref) ref = e;
+        else if (e - ref >= ElevationThreshold) { gain += e - ref; ref = e; }
+    }
+
+    const double active = out.movingSeconds > 0 ? out.movingSeconds : out.elapsedSeconds;
+    if (active <= 0) { if (error) *error = "the track has no elapsed time"; return false; }
+    CardioWorkout &w = out.workout;
+    w.date = t.start.toLocalTime().date().toString("yyyy-MM-dd");
+    w.distance = metres / 1000.0;
+    w.duration = std::max(1, int(std::lround(active / 60.0)));
+    w.avgSpeed = w.distance / (active / 3600.0);
+    w.type = cardioType(t.sport, w.avgSpeed);
+    w.elevationGain = std::round(gain);
+    w.heartRate = SampleStore::heartRate(ss, maxHr);
+    return true;
+}
+
+QString cardioType(const QString &sport, double kmh)
+{
+    const QString s = sport.toLower();
+    if (s.contains("run")) return "Running";
+    if (s.contains("bik") || s.contains("cycl") || s.contains("ride")) return "Cycling";
+    if (s.contains("swim")) return "Swimming";
+    if (s.contains("walk") || s.contains("hik")) return "Walking";
+    return kmh >= 15 ? "Cycling" : kmh >= 7 ? "Running" : "Walking";
+}
+
+FileResult importFile(const QString &path, int maxHr)
+{
+    FT_TRACE_SCOPE("RouteImport::importFile");
+    FileResult r;
+    r.path = path;
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) { r.error = f.errorString(); return r; }
+    if (QFileInfo(path).suffix().compare(QLatin1String("fit"), Qt::CaseInsensitive) == 0) {
+        importFit(f, maxHr, r);
+    } else {
+        Track t;
+        FileResult::Activity act;
+        if (parse(&f, t, &r.error) && analyze(t, act.summary, &r.error, maxHr)) {
+            keepSamples(act, t.start);
+            r.activities.push_back(std::move(act));
+        }
+    }
+    if (!r.error.isEmpty()) r.error = QFileInfo(path).fileName() + ": " + r.error;
+    return r;
+}
+
+} // namespace RouteImport
@@ -0,0 +1,66 @@
+#ifndef ROUTEIMPORT_H
+#define ROUTEIMPORT_H
+
+// FitTrack Pro - GPX / TCX / FIT activity import
+// A file is streamed through QXmlStreamReader (or, for FIT, decoded from the mapped file by
+// fitfile.h) into a Track (one array per field), then analyze() derives what the Cardio tab
+// stores: distance, moving time, average speed, per-km splits and elevation gain, plus the sensor
+// samples (samplestore.h) and heart-rate zones. importFile() does all of it and is safe to map
+// over many files on the thread pool.
+#include <QDateTime>
+#include <QString>
+#include <vector>
+#include "models.h"
+#include "samplestore.h"
+
+class QIODevice;
+
+struct Track {
+    QString sport;               // as the file names it ("running", "Biking", ...), may be empty
+    QDateTime start;             // first timestamp (UTC), invalid if the file has none
+    std::vector<double> lat, lon; // degrees, NaN where missing (indoor points that only have distance)
+    std::vector<double> ele;      // metres, NaN where missing
+    std::vector<double> time;     // seconds since `start`, NaN where missing
+    std::vector<double> hr, cadence; // bpm / rpm, NaN where missing
+    std::vector<double> distance; // cumulative metres as the device measured them, NaN where missing
+};
+
+struct RouteSummary {
+    CardioWorkout workout{};     // calories left at 0: they depend on the account's bodyweight
+    double elapsedSeconds = 0;
+    double movingSeconds = 0;
+    int points = 0;
+    SampleSeries samples; // the timed points; speed is derived per segment
+};
+
+namespace RouteImport {
+
+constexpr double MinMovingSpeed = 0.5;     // m/s; slower segments count as stopped
+constexpr double ElevationThreshold = 3.0; // m climbed before it counts, to ride out GPS altitude noise
+
+// GPX 1.0/1.1 (track and route points) or TCX, told apart by the root element
+bool parse(QIODevice *dev, Track &out, QString *error);
+// false without two timed points; heart-rate zones are taken against maxHr. Distance comes from
+// the positions, or from the device's distance for segments without them
+bool analyze(const Track &t, RouteSummary &out, QString *error, int maxHr = 0);
+
+// The app's cardio type for a file's sport name; unknown names go by average speed
+QString cardioType(const QString &sport, double kmh);
+
+// summary.workout.samples names the sample file; writing sampleData there is left to the caller,
+// which knows the account (and its key)
+struct FileResult {
+    struct Activity {
+        RouteSummary summary;
+        QByteArray sampleData; // SampleStore::encode(summary.samples); summary.samples itself is dropped
+    };
+    QString path;
+    std::vector<Activity> activities; // one per GPX / TCX file, one per session of a FIT file
+    QString error;                    // empty on success
+};
+// The format goes by the suffix: .fit is decoded in place from the mapped file, anything else is XML
+FileResult importFile(const QString &path, int maxHr);
+
+} // namespace RouteImport
+
+#endif // ROUTEIMPORT_H
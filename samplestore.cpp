@@ -0,0 +1,204 @@
+// samplestore.cpp
+#include "samplestore.h"
+#include "tracing.h"
+
+#include <QDir>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr char Magic[4] = {'F', 'T', 'S', '1'};
+constexpr int HeaderSize = 9; // magic, sample count, channel mask
+
+// Stored resolution per channel: bpm, 0.01 m/s, rpm, 0.1 m
+constexpr double Scale[SampleSeries::ChannelCount] = {1, 100, 1, 10};
+constexpr int64_t Missing = std::numeric_limits<int64_t>::min() / 4; // far from any real value, deltas still fit
+
+// MSB-first bit packing into 64-bit words
+class BitWriter {
+public:
+    explicit BitWriter(QByteArray &out) : out(out) {}
+
+    void put(uint64_t bits, int n) {
+        if (n < 64) bits &= (uint64_t(1) << n) - 1;
+        const int room = 64 - used;
+        if (n < room) {
+            acc |= bits << (room - n);
+            used += n;
+            return;
+        }
+        acc |= bits >> (n - room); // fills the word exactly
+        flushWord();
+        used = n - room;
+        acc = used ? bits << (64 - used) : 0;
+    }
+
+    void finish() {
+        for (int i = 0; i < (used + 7) / 8; ++i) out.append(char(acc >> (56 - 8 * i)));
+        acc = 0; used = 0;
+    }
+
+private:
+    void flushWord() {
+        char b[8];
+        for (int i = 0; i < 8; ++i) b[i] = char(acc >> (56 - 8 * i));
+        out.append(b, 8);
+        acc = 0;
+    }
+
+    QByteArray &out;
+    uint64_t acc = 0;
+    int used = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t *p, size_t size) : p(p), end(p + size) {}
+
+    uint64_t get(int n) {
+        if (n > 56) { const uint64_t hi = get(32); return hi << (n - 32) | get(n - 32); }
+        while (avail < n && p < end) { acc |= uint64_t(*p++) << (56 - avail); avail += 8; }
+        if (avail < n) { overrun = true; return 0; }
+        const uint64_t v = acc >> (64 - n);
+        acc <<= n;
+        avail -= n;
+        return v;
+    }
+
+    bool overrun = false;
+
+private:
+    const uint8_t *p, *end;
+    uint64_t acc = 0;
+    int avail = 0;
+};
+
+// '0' for zero, then '10' + 7 bits, '110' + 9, '1110' + 12, '1111' + 64 (Gorilla's timestamp buckets)
+void putSigned(BitWriter &w, int64_t v)
+{
+    if (v == 0) w.put(0, 1);
+    else if (v >= -64 && v < 64) { w.put(0b10, 2); w.put(uint64_t(v), 7); }
+    else if (v >= -256 && v < 256) { w.put(0b110, 3); w.put(uint64_t(v), 9); }
+    else if (v >= -2048 && v < 2048) { w.put(0b1110, 4); w.put(uint64_t(v), 12); }
+    else { w.put(0b1111, 4); w.put(uint64_t(v), 64); }
+}
+
+int64_t getSigned(BitReader &r)
+{
+    if (!r.get(1)) return 0;
+    const int bits = !r.get(1) ? 7 : !r.get(1) ? 9 : !r.get(1) ? 12 : 64;
+    const uint64_t u = r.get(bits);
+    return bits == 64 ? int64_t(u) : int64_t(u << (64 - bits)) >> (64 - bits);
+}
+
+int64_t quantise(double v, double scale) { return std::isnan(v) ? Missing : std::llround(v * scale); }
+
+} // namespace
+
+namespace SampleStore {
+
+QByteArray encode(const SampleSeries &s)
+{
+    FT_TRACE_SCOPE("SampleStore::encode");
+    const uint32_t n = uint32_t(s.time.size());
+    uint8_t mask = 0;
+    for (int c = 0; c < SampleSeries::ChannelCount; ++c)
+        if (s.values[c].size() == n && n) mask |= uint8_t(1 << c);
+
+    QByteArray out(Magic, 4);
+    for (int i = 0; i < 4; ++i) out.append(char(n >> (8 * i)));
+    out.append(char(mask));
+    out.reserve(HeaderSize + n); // about a byte per sample for all channels together
+    BitWriter w(out);
+
+    // timestamps: delta of delta, zero for an evenly spaced stream
+    int64_t prev = 0, prevDelta = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        const int64_t delta = s.time[i] - prev;
+        putSigned(w, delta - prevDelta);
+        prev = s.time[i]; prevDelta = delta;
+    }
+    // channels one after the other, so decoding one is a tight loop: delta of the quantised value
+    for (int c = 0; c < SampleSeries::ChannelCount; ++c) {
+        if (!(mask & (1 << c))) continue;
+        int64_t last = 0;
+        for (uint32_t i = 0; i < n; ++i) {
+            const int64_t q = quantise(s.values[c][i], Scale[c]);
+            putSigned(w, q - last);
+            last = q;
+        }
+    }
+    w.finish();
+    return out;
+}
+
+bool decode(QByteArrayView bytes, SampleSeries &out)
+{
+    FT_TRACE_SCOPE("SampleStore::decode");
+    out = SampleSeries();
+    if (bytes.size() < HeaderSize || std::memcmp(bytes.data(), Magic, 4) != 0) return false;
+    const auto *u = reinterpret_cast<const uint8_t *>(bytes.data());
+    const uint32_t n = uint32_t(u[4]) | uint32_t(u[5]) << 8 | uint32_t(u[6]) << 16 | uint32_t(u[7]) << 24;
+    const uint8_t mask = u[8];
+    if (n > uint64_t(bytes.size()) * 8) return false; // every sample takes at least one bit
+    BitReader r(u + HeaderSize, size_t(bytes.size() - HeaderSize));
+
+    out.time.resize(n);
+    int64_t prev = 0, delta = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        delta += getSigned(r);
+        prev += delta;
+        out.time[i] = prev;
+    }
+    for (int c = 0; c < SampleSeries::ChannelCount; ++c) {
+        if (!(mask & (1 << c))) continue;
+        std::vector<double> &v = out.values[c];
+        v.resize(n);
+        const double inv = 1.0 / Scale[c];
+        int64_t q = 0;
+        for (uint32_t i = 0; i < n; ++i) {
+            q += getSigned(r);
+            v[i] = q == Missing ? std::numeric_limits<double>::quiet_NaN() : double(q) * inv;
+        }
+    }
+    if (r.overrun) { out = SampleSeries(); return false; }
+    return true;
+}
+
+HeartRateSummary heartRate(const SampleSeries &s, int maxHr)
+{
+    HeartRateSummary h;
+    if (!s.has(SampleSeries::HeartRate) || maxHr <= 0) return h;
+    const std::vector<double> &hr = s.values[SampleSeries::HeartRate];
+    const double bounds[4] = {0.6 * maxHr, 0.7 * maxHr, 0.8 * maxHr, 0.9 * maxHr};
+    qint64 zoneMs[5] = {}, totalMs = 0;
+    double weighted = 0, plain = 0;
+    int count = 0;
+    for (size_t i = 0; i < hr.size(); ++i) {
+        if (std::isnan(hr[i]) || hr[i] <= 0) continue;
+        // a sample stands for the time until the next one
+        qint64 dt = i + 1 < s.time.size() ? s.time[i + 1] - s.time[i] : 0;
+        if (dt > MaxGapMs || dt < 0) dt = 0;
+        int z = 0;
+        while (z < 4 && hr[i] >= bounds[z]) ++z;
+        zoneMs[z] += dt;
+        totalMs += dt;
+        weighted += hr[i] * double(dt);
+        plain += hr[i];
+        ++count;
+        h.maximum = std::max(h.maximum, int(std::lround(hr[i])));
+    }
+    if (!count) return h;
+    h.average = int(std::lround(totalMs > 0 ? weighted / double(totalMs) : plain / count));
+    for (int z = 0; z < 5; ++z) h.zoneSeconds[z] = int((zoneMs[z] + 500) / 1000);
+    return h;
+}
+
+QString filePath(const QString &dir, const QString &username, const QString &id)
+{
+    return QDir(dir).filePath("samples_" + username + "/" + id + ".fts");
+}
+
+} // namespace SampleStore
@@ -0,0 +1,38 @@
+#ifndef SAMPLESTORE_H
+#define SAMPLESTORE_H
+
+// FitTrack Pro - per-activity sensor samples (heart rate, speed, cadence, altitude at ~1 Hz)
+// Each imported activity keeps its samples in samples_<user>/<id>.fts, next to the .dat files and
+// loaded only when the activity is opened. Timestamps are delta-of-delta coded and each channel is
+// quantised and delta coded, both with Gorilla-style variable-width buckets, so a steady 1 Hz
+// stream costs a few bits per sample. The file goes through DataFile (CRC32C, or sealed).
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <vector>
+#include "models.h"
+
+struct SampleSeries {
+    enum Channel { HeartRate, Speed, Cadence, Altitude, ChannelCount };
+
+    std::vector<qint64> time;                 // ms since the activity start, ascending
+    std::vector<double> values[ChannelCount]; // one per time, NaN where nothing was recorded; empty if the device had no such sensor
+
+    bool has(Channel c) const { return !values[c].empty(); }
+    bool isEmpty() const { return time.empty(); }
+};
+
+namespace SampleStore {
+
+QByteArray encode(const SampleSeries &s);
+bool decode(QByteArrayView bytes, SampleSeries &out); // false if the data is not a sample stream
+
+// Time in the five zones of maxHr (<60%, 60-70, 70-80, 80-90, >=90%); gaps over MaxGapMs count as stopped
+constexpr qint64 MaxGapMs = 10000;
+HeartRateSummary heartRate(const SampleSeries &s, int maxHr);
+
+QString filePath(const QString &dir, const QString &username, const QString &id); // "" dir = working directory
+
+} // namespace SampleStore
+
+#endif // SAMPLESTORE_H
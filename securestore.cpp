@@ -0,0 +1,238 @@
+// securestore.cpp
+#include "securestore.h"
+#include "cipher.h"
+#include "tracing.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QMessageAuthenticationCode>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QtConcurrent>
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+// 0xff never occurs in UTF-8, so no plaintext .dat file can start with these
+constexpr char FileMagic[4] = {'\xff', 'F', 'T', 'X'};
+constexpr char KeyMagic[4] = {'\xff', 'F', 'T', 'K'};
+constexpr int HeaderSize = 16;      // magic, chunk size, nonce prefix
+constexpr int SaltSize = 16;
+constexpr int ParallelChunks = 4;   // below this, one thread is faster than the pool hand-off
+constexpr char PasswordScheme[] = "pbkdf2-sha256";
+
+const uint8_t *bytes(const QByteArray &b) { return reinterpret_cast<const uint8_t *>(b.constData()); }
+const uint8_t *bytes(QByteArrayView b) { return reinterpret_cast<const uint8_t *>(b.data()); }
+uint8_t *bytes(QByteArray &b) { return reinterpret_cast<uint8_t *>(b.data()); }
+
+quint32 get32(const char *p)
+{
+    const auto *u = reinterpret_cast<const uint8_t *>(p);
+    return quint32(u[0]) | quint32(u[1]) << 8 | quint32(u[2]) << 16 | quint32(u[3]) << 24;
+}
+
+void put32(char *p, quint32 v)
+{
+    for (int i = 0; i < 4; ++i) p[i] = char(v >> (8 * i));
+}
+
+QByteArray randomBytes(int n)
+{
+    QByteArray b(n, Qt::Uninitialized);
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32 *>(b.data()), n / 4);
+    return b;
+}
+
+// Chunk i: nonce = prefix | i, aad = file header | last-chunk flag
+struct ChunkParams {
+    uint8_t nonce[Cipher::NonceSize];
+    uint8_t aad[HeaderSize + 1];
+};
+
+ChunkParams chunkParams(const char *header, quint32 index, bool last)
+{
+    ChunkParams c;
+    std::memcpy(c.nonce, header + 8, 8);
+    put32(reinterpret_cast<char *>(c.nonce) + 8, index);
+    std::memcpy(c.aad, header, HeaderSize);
+    c.aad[HeaderSize] = last ? 1 : 0;
+    return c;
+}
+
+// Runs fn(i) for every chunk, on the global pool once there are enough of them
+template <typename Fn>
+void forEachChunk(int chunks, Fn &&fn)
+{
+    if (chunks < ParallelChunks) { for (int i = 0; i < chunks; ++i) fn(i); return; }
+    QList<int> indices;
+    indices.reserve(chunks);
+    for (int i = 0; i < chunks; ++i) indices << i;
+    QtConcurrent::blockingMap(indices, fn);
+}
+
+// What the key file's check tag seals: nothing, under a nonce no data file uses
+// Equal-length comparison in constant time
+bool sameBytes(const QByteArray &a, const QByteArray &b)
+{
+    if (a.size() != b.size()) return false;
+    char diff = 0;
+    for (int i = 0; i < a.size(); ++i) diff |= char(a[i] ^ b[i]);
+    return diff == 0;
+}
+
+QByteArray checkTag(const QByteArray &key)
+{
+    static const uint8_t nonce[Cipher::NonceSize] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    static const char aad[] = "FitTrack key check";
+    QByteArray tag(int(Cipher::TagSize), Qt::Uninitialized);
+    Cipher::seal(bytes(key), nonce, reinterpret_cast<const uint8_t *>(aad), sizeof(aad) - 1, nullptr, nullptr, 0, bytes(tag));
+    return tag;
+}
+
+} // namespace
+
+namespace SecureStore {
+
+bool isSealed(QByteArrayView file)
+{
+    return file.size() >= HeaderSize && std::memcmp(file.data(), FileMagic, 4) == 0;
+}
+
+QByteArray seal(QByteArrayView plain, const QByteArray &key)
+{
+    FT_TRACE_SCOPE("SecureStore::seal");
+    const qsizetype n = plain.size();
+    const int chunks = n ? int((n + ChunkSize - 1) / ChunkSize) : 1; // empty input still gets a tagged chunk
+    QByteArray out(HeaderSize + n + chunks * qsizetype(Cipher::TagSize), Qt::Uninitialized);
+    char *header = out.data();
+    std::memcpy(header, FileMagic, 4);
+    put32(header + 4, ChunkSize);
+    std::memcpy(header + 8, randomBytes(8).constData(), 8);
+
+    uint8_t *base = bytes(out) + HeaderSize; // detached once, before the workers share it
+    forEachChunk(chunks, [&](int i) {
+        const qsizetype off = qsizetype(i) * ChunkSize;
+        const qsizetype len = qMin<qsizetype>(ChunkSize, n - off);
+        const ChunkParams c = chunkParams(header, quint32(i), i == chunks - 1);
+        uint8_t *dst = base + off + qsizetype(i) * Cipher::TagSize;
+        Cipher::seal(bytes(key), c.nonce, c.aad, sizeof(c.aad), bytes(plain) + off, dst, size_t(len), dst + len);
+    });
+    return out;
+}
+
+bool open(QByteArrayView file, const QByteArray &key, QByteArray &plain)
+{
+    FT_TRACE_SCOPE("SecureStore::open");
+    if (!isSealed(file) || key.size() != int(Cipher::KeySize)) return false;
+    const qsizetype chunkSize = get32(file.data() + 4);
+    const qsizetype stride = chunkSize + Cipher::TagSize;
+    const qsizetype body = file.size() - HeaderSize;
+    if (chunkSize <= 0 || body < qsizetype(Cipher::TagSize)) return false;
+    const int chunks = int((body + stride - 1) / stride);
+    const qsizetype lastLen = body - qsizetype(chunks - 1) * stride - Cipher::TagSize;
+    if (lastLen < 0 || (chunks > 1 && lastLen == 0)) return false; // a non-final chunk cut short
+    plain.resize(qsizetype(chunks - 1) * chunkSize + lastLen);
+
+    uint8_t *dst = bytes(plain);
+    std::atomic<bool> ok{true};
+    forEachChunk(chunks, [&](int i) {
+        const bool last = i == chunks - 1;
+        const qsizetype len = last ? lastLen : chunkSize;
+        const ChunkParams c = chunkParams(file.data(), quint32(i), last);
+        const uint8_t *src = bytes(file) + HeaderSize + qsizetype(i) * stride;
+        if (!Cipher::open(bytes(key), c.nonce, c.aad, sizeof(c.aad), src, dst + qsizetype(i) * chunkSize, size_t(len), src + len))
+            ok = false;
+    });
+    if (!ok) plain.fill('\0');
+    return ok;
+}
+
+QByteArray deriveKey(const QString &password, const QByteArray &salt, int iterations)
+{
+    FT_TRACE_SCOPE("SecureStore::deriveKey");
+    // PBKDF2-HMAC-SHA256, one 32-byte block
+    QMessageAuthenticationCode mac(QCryptographicHash::Sha256, password.toUtf8());
+    mac.addData(salt);
+    mac.addData(QByteArray::fromHex("00000001"));
+    QByteArray u = mac.result(), key = u;
+    for (int i = 1; i < iterations; ++i) {
+        mac.reset();
+        mac.addData(u);
+        u = mac.result();
+        for (int j = 0; j < key.size(); ++j) key[j] = char(key[j] ^ u[j]);
+    }
+    return key;
+}
+
+QString keyFilePath(const QString &dir, const QString &username)
+{
+    return QDir(dir).filePath("key_" + username + ".dat");
+}
+
+bool hasKey(const QString &dir, const QString &username)
+{
+    return QFile::exists(keyFilePath(dir, username));
+}
+
+QByteArray enroll(const QString &dir, const QString &username, const QString &password)
+{
+    const QByteArray salt = randomBytes(SaltSize);
+    const QByteArray key = deriveKey(password, salt, DefaultIterations);
+    QByteArray rec(4 + 4, Qt::Uninitialized);
+    std::memcpy(rec.data(), KeyMagic, 4);
+    put32(rec.data() + 4, DefaultIterations);
+    rec += salt;
+    rec += checkTag(key);
+    QFile f(keyFilePath(dir, username));
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate) || f.write(rec) != rec.size()) return QByteArray();
+    return key;
+}
+
+QByteArray unlock(const QString &dir, const QString &username, const QString &password)
+{
+    QFile f(keyFilePath(dir, username));
+    if (!f.open(QIODevice::ReadOnly)) return QByteArray();
+    const QByteArray rec = f.readAll();
+    if (rec.size() != 8 + SaltSize + int(Cipher::TagSize) || std::memcmp(rec.constData(), KeyMagic, 4) != 0) return QByteArray();
+    const quint32 iterations = get32(rec.constData() + 4);
+    if (iterations < quint32(MinIterations) || iterations > quint32(MaxIterations)) return QByteArray();
+    QByteArray key = deriveKey(password, rec.mid(8, SaltSize), int(iterations));
+    if (!sameBytes(checkTag(key), rec.mid(8 + SaltSize))) { key.fill('\0'); return QByteArray(); }
+    return key;
+}
+
+bool removeKey(const QString &dir, const QString &username)
+{
+    return QFile::remove(keyFilePath(dir, username));
+}
+
+QString hashPassword(const QString &password)
+{
+    const QByteArray salt = randomBytes(SaltSize);
+    const QByteArray hash = deriveKey(password, salt, DefaultIterations);
+    return QString("%1$%2$%3$%4").arg(QLatin1String(PasswordScheme)).arg(DefaultIterations)
+        .arg(QString::fromLatin1(salt.toHex()), QString::fromLatin1(hash.toHex()));
+}
+
+bool verifyPassword(const QString &password, const QString &stored, bool *outdated)
+{
+    if (outdated) *outdated = false;
+    const QStringList p = stored.split('$');
+    if (p.size() == 1) { // accounts created before salted hashes: sha256(password) in hex
+        if (!sameBytes(QCryptographicHash::hash(password.toUtf8(), QCryptographicHash::Sha256).toHex(), stored.toLatin1())) return false;
+        if (outdated) *outdated = true;
+        return true;
+    }
+    bool ok = false;
+    const int iterations = p.value(1).toInt(&ok);
+    if (p.size() != 4 || p[0] != QLatin1String(PasswordScheme) || !ok || iterations < MinIterations || iterations > MaxIterations)
+        return false;
+    const QByteArray salt = QByteArray::fromHex(p[2].toLatin1()), expect = QByteArray::fromHex(p[3].toLatin1());
+    if (salt.size() != SaltSize || expect.isEmpty() || !sameBytes(deriveKey(password, salt, iterations), expect)) return false;
+    if (outdated) *outdated = iterations < DefaultIterations;
+    return true;
+}
+
+} // namespace SecureStore
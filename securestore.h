@@ -0,0 +1,47 @@
+#ifndef SECURESTORE_H
+#define SECURESTORE_H
+
+// FitTrack Pro - encrypted per-user .dat files (opt-in from the Profile tab)
+// A sealed file is 0xff "FTX" | chunk size | 8-byte random nonce prefix, then the plaintext in
+// ChaCha20-Poly1305 chunks, each with its own tag. The chunk index forms the rest of the nonce and
+// the last chunk is flagged in its associated data, so reordering or truncation fails to open.
+// The 32-byte key comes from the login password via PBKDF2-HMAC-SHA256 with a per-user salt
+// kept in key_<user>.dat together with a check tag; the key itself is never stored.
+// users.dat holds a separate PBKDF2 hash of the password, with its own salt.
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+
+namespace SecureStore {
+
+constexpr int ChunkSize = 64 * 1024;
+constexpr int DefaultIterations = 100000;
+// Iteration counts read from disk outside this range are rejected: too few makes the stored hash or
+// key check cheap to brute-force, too many turns a crafted file into a login that never finishes
+constexpr int MinIterations = 10000;
+constexpr int MaxIterations = 10000000;
+
+bool isSealed(QByteArrayView file);
+
+// Chunks are independent, so larger files are sealed/opened on the global pool
+QByteArray seal(QByteArrayView plain, const QByteArray &key);
+bool open(QByteArrayView file, const QByteArray &key, QByteArray &plain);
+
+QByteArray deriveKey(const QString &password, const QByteArray &salt, int iterations);
+
+// key_<user>.dat in `dir`
+QString keyFilePath(const QString &dir, const QString &username);
+bool hasKey(const QString &dir, const QString &username);
+QByteArray enroll(const QString &dir, const QString &username, const QString &password); // new salt; empty on I/O error
+QByteArray unlock(const QString &dir, const QString &username, const QString &password); // empty if the password does not match
+bool removeKey(const QString &dir, const QString &username);
+
+// users.dat password field: "pbkdf2-sha256$<iterations>$<salt hex>$<hash hex>", new salt each time
+QString hashPassword(const QString &password);
+// Also accepts the unsalted SHA-256 hex of older accounts; *outdated is set when the stored hash
+// should be replaced with hashPassword()
+bool verifyPassword(const QString &password, const QString &stored, bool *outdated = nullptr);
+
+} // namespace SecureStore
+
+#endif // SECURESTORE_H
@@ -0,0 +1,105 @@
+// traceoverlay.cpp
+#include "traceoverlay.h"
+#include "tracing.h"
+
+#include <QEvent>
+#include <QFontDatabase>
+#include <QPainter>
+#include <algorithm>
+#include <map>
+#include <string>
+
+namespace {
+
+double percentileUs(std::vector<quint64> &v, double q)
+{
+    if (v.empty()) return 0.0;
+    const size_t idx = std::min(v.size() - 1, size_t(q * (v.size() - 1) + 0.5));
+    std::nth_element(v.begin(), v.begin() + idx, v.end());
+    return v[idx] / 1000.0;
+}
+
+} // namespace
+
+TraceOverlay::TraceOverlay(QWidget *parent) : QWidget(parent)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    hide();
+    timer.setInterval(500);
+    connect(&timer, &QTimer::timeout, this, [this]{ refreshStats(); });
+    if (parent) parent->installEventFilter(this);
+}
+
+void TraceOverlay::toggle()
+{
+    if (isVisible()) { timer.stop(); hide(); return; }
+    refreshStats();
+    show(); raise();
+    timer.start();
+}
+
+void TraceOverlay::refreshStats()
+{
+    const std::vector<Tracing::Event> events = Tracing::snapshot();
+
+    // group by span name (the same literal can live at different addresses per translation unit)
+    std::map<std::string, std::vector<quint64>> byName;
+    for (const auto &e : events) byName[e.name].push_back(e.durNs);
+
+    struct Row { QString name; size_t n; double total, p50, p99; };
+    std::vector<Row> rows;
+    for (auto &kv : byName) {
+        double total = 0; for (quint64 d : kv.second) total += d;
+        rows.push_back(Row{QString::fromStdString(kv.first), kv.second.size(), total,
+                           percentileUs(kv.second, 0.50), percentileUs(kv.second, 0.99)});
+    }
+    std::sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) { return a.total > b.total; });
+
+    lines.clear();
+    lines << QString("%1 %2 %3 %4").arg("span", -24).arg("n", 7).arg("p50 us", 10).arg("p99 us", 10);
+    for (size_t i = 0; i < rows.size() && i < 10; ++i)
+        lines << QString("%1 %2 %3 %4").arg(rows[i].name.left(24), -24).arg(rows[i].n, 7)
+                     .arg(rows[i].p50, 10, 'f', 1).arg(rows[i].p99, 10, 'f', 1);
+
+    lines << "" << QString("last %1 spans").arg(recentCount);
+    for (size_t i = 0; i < events.size() && i < size_t(recentCount); ++i) {
+        const auto &e = events[events.size() - 1 - i];
+        lines << QString("%1 %2 us  %3").arg(QString::fromUtf8(e.name).left(24), -24)
+                     .arg(e.durNs / 1000.0, 10, 'f', 1).arg(Tracing::threadName(e.tid));
+    }
+    lines << "" << "F12 hide - Ctrl+Shift+T save Chrome trace";
+
+    reposition();
+    update();
+}
+
+void TraceOverlay::reposition()
+{
+    if (!parentWidget()) return;
+    const QFontMetrics fm(font());
+    int w = 0;
+    for (const QString &l : lines) w = qMax(w, fm.horizontalAdvance(l));
+    resize(w + 24, lines.size() * fm.lineSpacing() + 16);
+    move(parentWidget()->width() - width() - 12, 12);
+}
+
+void TraceOverlay::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setPen(Qt::NoPen);
+    p.setBrush(QColor(0, 0, 0, 200));
+    p.drawRoundedRect(rect(), 8, 8);
+
+    const QFontMetrics fm(font());
+    p.setPen(QColor(255, 184, 107));
+    int y = 8 + fm.ascent();
+    for (const QString &l : lines) { p.drawText(12, y, l); y += fm.lineSpacing(); }
+}
+
+bool TraceOverlay::eventFilter(QObject *watched, QEvent *ev)
+{
+    if (watched == parentWidget() && ev->type() == QEvent::Resize && isVisible()) reposition();
+    return QWidget::eventFilter(watched, ev);
+}
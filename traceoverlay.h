@@ -0,0 +1,28 @@
+#ifndef TRACEOVERLAY_H
+#define TRACEOVERLAY_H
+
+// FitTrack Pro - in-app perf overlay (F12 in tracing builds)
+// Shows the most recent spans and p50/p99 per span name; pinned to the top-right of its parent.
+#include <QStringList>
+#include <QTimer>
+#include <QWidget>
+
+class TraceOverlay : public QWidget {
+public:
+    explicit TraceOverlay(QWidget *parent);
+    void toggle();
+
+protected:
+    void paintEvent(QPaintEvent *) override;
+    bool eventFilter(QObject *watched, QEvent *ev) override;
+
+private:
+    void refreshStats();
+    void reposition();
+
+    QTimer timer;
+    QStringList lines;
+    static constexpr int recentCount = 12;
+};
+
+#endif // TRACEOVERLAY_H
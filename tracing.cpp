@@ -0,0 +1,138 @@
+// tracing.cpp
+#include "tracing.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Tracing {
+
+namespace {
+
+// Buffers live until exit so spans of finished pool threads can still be dumped
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+// Pairs of (ticks, steady ns) taken at startup and at read time give the tick rate
+struct ClockAnchor { quint64 ticks; quint64 ns; };
+const ClockAnchor startAnchor{nowTicks(), steadyNs()};
+
+double nsPerTick()
+{
+#ifdef FITTRACK_TRACE_TSC
+    if (steadyNs() - startAnchor.ns < 10000000) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    const ClockAnchor now{nowTicks(), steadyNs()};
+    return now.ticks > startAnchor.ticks ? double(now.ns - startAnchor.ns) / double(now.ticks - startAnchor.ticks) : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+// Span names are literals, but thread names come from QThread::objectName() and may hold anything
+QString jsonEscaped(const QString &s)
+{
+    QString out;
+    out.reserve(s.size());
+    for (QChar c : s) {
+        if (c == '\\' || c == '"') { out += '\\'; out += c; }
+        else if (c == '\n') out += "\\n";
+        else if (c == '\t') out += "\\t";
+        else if (c.unicode() < 0x20) out += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+        else out += c;
+    }
+    return out;
+}
+
+} // namespace
+
+ThreadBuffer *registerThread()
+{
+    auto buf = std::make_unique<ThreadBuffer>();
+    QThread *t = QThread::currentThread();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buf->tid = quint32(registry.size() + 1);
+    if (QCoreApplication::instance() && t == QCoreApplication::instance()->thread()) buf->threadName = "GUI";
+    else buf->threadName = t && !t->objectName().isEmpty() ? t->objectName() : QString("worker %1").arg(buf->tid);
+    tlsBuffer = buf.get();
+    registry.push_back(std::move(buf));
+    return tlsBuffer;
+}
+
+std::vector<Event> snapshot()
+{
+    std::vector<ThreadBuffer *> bufs;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (auto &b : registry) bufs.push_back(b.get());
+    }
+
+    const double scale = nsPerTick();
+    auto toNs = [&](quint64 ticks) { return quint64(qint64(startAnchor.ns) + qint64(double(qint64(ticks - startAnchor.ticks)) * scale)); };
+
+    std::vector<Event> out;
+    std::vector<Event> tmp;
+    for (ThreadBuffer *b : bufs) {
+        const quint64 h1 = b->head.load(std::memory_order_acquire);
+        const quint64 first = h1 > ThreadBuffer::Capacity ? h1 - ThreadBuffer::Capacity : 0;
+        tmp.clear();
+        for (quint64 i = first; i < h1; ++i) {
+            const ThreadBuffer::Slot &s = b->slots[i & (ThreadBuffer::Capacity - 1)];
+            tmp.push_back(Event{s.name.load(std::memory_order_relaxed), toNs(s.start.load(std::memory_order_relaxed)),
+                                quint64(s.dur.load(std::memory_order_relaxed) * scale), b->tid});
+        }
+        // the writer may have lapped us while copying: drop slots it could have touched
+        const quint64 h2 = b->head.load(std::memory_order_acquire);
+        const quint64 safe = h2 + 1 > ThreadBuffer::Capacity ? h2 + 1 - ThreadBuffer::Capacity : 0;
+        for (quint64 i = std::max(first, safe); i < h1; ++i) out.push_back(tmp[size_t(i - first)]);
+    }
+    std::sort(out.begin(), out.end(), [](const Event &a, const Event &b) { return a.startNs < b.startNs; });
+    return out;
+}
+
+QString threadName(quint32 tid)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return tid >= 1 && tid <= registry.size() ? registry[tid - 1]->threadName : QString();
+}
+
+bool writeChromeTrace(const QString &path, QString *error)
+{
+    const std::vector<Event> events = snapshot();
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+
+    QTextStream out(&f);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool firstEntry = true;
+    auto sep = [&] { if (!firstEntry) out << ",\n"; firstEntry = false; };
+
+    std::vector<quint32> tids;
+    for (const Event &e : events) if (std::find(tids.begin(), tids.end(), e.tid) == tids.end()) tids.push_back(e.tid);
+    for (quint32 tid : tids) {
+        sep();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+            << ",\"args\":{\"name\":\"" << jsonEscaped(threadName(tid)) << "\"}}";
+    }
+
+    const quint64 origin = events.empty() ? 0 : events.front().startNs;
+    for (const Event &e : events) {
+        sep();
+        out << "{\"name\":\"" << jsonEscaped(QString::fromUtf8(e.name)) << "\",\"cat\":\"fittrack\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.tid
+            << ",\"ts\":" << QString::number((e.startNs - origin) / 1000.0, 'f', 3)
+            << ",\"dur\":" << QString::number(e.durNs / 1000.0, 'f', 3) << "}";
+    }
+    out << "\n]}\n";
+    out.flush();
+    f.close();
+    return true;
+}
+
+} // namespace Tracing
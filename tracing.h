@@ -0,0 +1,106 @@
+#ifndef TRACING_H
+#define TRACING_H
+
+// FitTrack Pro - scoped tracing spans (build with "qmake CONFIG+=tracing")
+// FT_TRACE_SCOPE("name") records [start, end) into a per-thread ring buffer.
+// Writers never lock: each thread owns its buffer and publishes entries with a release store.
+// Spans are stamped with the TSC on x86-64 (steady_clock elsewhere) and converted to
+// nanoseconds when read. Without FITTRACK_TRACING the macro expands to nothing.
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <x86intrin.h>
+#define FITTRACK_TRACE_TSC 1
+#elif defined(_M_X64)
+#include <intrin.h>
+#define FITTRACK_TRACE_TSC 1
+#endif
+
+namespace Tracing {
+
+struct Event {
+    const char *name;
+    quint64 startNs;
+    quint64 durNs;
+    quint32 tid;
+};
+
+inline quint64 steadyNs()
+{
+    return quint64(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Raw timestamp; a clock_gettime per span end would double the span cost on some VMs
+inline quint64 nowTicks()
+{
+#ifdef FITTRACK_TRACE_TSC
+    return __rdtsc();
+#else
+    return steadyNs();
+#endif
+}
+
+// Single-producer ring; readers copy it and drop entries that were overwritten meanwhile
+struct ThreadBuffer {
+    static constexpr quint32 Capacity = 1u << 14;
+    struct Slot { std::atomic<const char *> name{nullptr}; std::atomic<quint64> start{0}; std::atomic<quint64> dur{0}; };
+
+    quint32 tid = 0;
+    QString threadName;
+    std::atomic<quint64> head{0};
+    Slot slots[Capacity];
+
+    void push(const char *n, quint64 s, quint64 d) {
+        const quint64 h = head.load(std::memory_order_relaxed);
+        Slot &e = slots[h & (Capacity - 1)];
+        e.name.store(n, std::memory_order_relaxed);
+        e.start.store(s, std::memory_order_relaxed);
+        e.dur.store(d, std::memory_order_relaxed);
+        head.store(h + 1, std::memory_order_release);
+    }
+};
+
+ThreadBuffer *registerThread(); // first span on a thread only (takes the registry lock)
+inline thread_local ThreadBuffer *tlsBuffer = nullptr;
+
+inline void record(const char *name, quint64 startTicks, quint64 endTicks)
+{
+    ThreadBuffer *b = tlsBuffer ? tlsBuffer : registerThread();
+    b->push(name, startTicks, endTicks - startTicks);
+}
+
+class Span {
+public:
+    explicit Span(const char *n) : name(n), start(nowTicks()) {}
+    ~Span() { record(name, start, nowTicks()); }
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+
+private:
+    const char *name;
+    quint64 start;
+};
+
+// All retained spans of every thread in nanoseconds, oldest first
+std::vector<Event> snapshot();
+QString threadName(quint32 tid);
+
+// Chrome trace_event JSON (open in chrome://tracing or ui.perfetto.dev)
+bool writeChromeTrace(const QString &path, QString *error = nullptr);
+
+} // namespace Tracing
+
+#define FT_TRACE_CONCAT2(a, b) a##b
+#define FT_TRACE_CONCAT(a, b) FT_TRACE_CONCAT2(a, b)
+
+#ifdef FITTRACK_TRACING
+#define FT_TRACE_SCOPE(name) Tracing::Span FT_TRACE_CONCAT(ftTraceSpan_, __LINE__)(name)
+#else
+#define FT_TRACE_SCOPE(name) ((void)0)
+#endif
+
+#endif // TRACING_H
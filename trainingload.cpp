@@ -0,0 +1,132 @@
+// trainingload.cpp
+#include "trainingload.h"
+#include "calories.h"
+#include "tracing.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Per-lane gain g: EWMA lambda 2 / (N + 1) for acute/chronic, 1 - e^(-1/tau) for fitness/fatigue
+const double Gain[4] = {2.0 / (7 + 1), 2.0 / (28 + 1), 1.0 - std::exp(-1.0 / 42.0), 1.0 - std::exp(-1.0 / 7.0)};
+
+} // namespace
+
+double TrainingLoad::cardioLoad(const CardioWorkout &w)
+{
+    return w.duration * Calories::metFor(Calories::activityFromName(w.type)) / 4.0;
+}
+
+double TrainingLoad::strengthLoad(const StrengthWorkout &w)
+{
+    return w.totalVolume / 100.0 + 2.0 * w.setCount;
+}
+
+LoadRisk TrainingLoad::risk(const LoadState &st)
+{
+    if (st.chronic() < 1.0) return LoadRisk::None; // not enough history for a ratio
+    const double r = st.acwr();
+    if (r > HighRiskAcwr) return LoadRisk::High;
+    if (r > CautionAcwr) return LoadRisk::Caution;
+    if (r >= 0.8) return LoadRisk::Optimal;
+    return LoadRisk::Low;
+}
+
+void TrainingLoad::rebuild(const PersistentVector<CardioWorkout> &cardio, const PersistentVector<StrengthWorkout> &strength, const QDate &today)
+{
+    FT_TRACE_SCOPE("TrainingLoad::rebuild");
+    clear();
+    qint64 lo = today.toJulianDay(), hi = lo;
+    bool any = false;
+    auto span = [&](const QString &date) {
+        const QDate d = QDate::fromString(date, "yyyy-MM-dd");
+        if (!d.isValid()) return;
+        lo = std::min(lo, d.toJulianDay()); hi = std::max(hi, d.toJulianDay()); any = true;
+    };
+    for (auto &w : cardio) span(w.date);
+    for (auto &w : strength) span(w.date);
+    if (!any) return;
+
+    first = lo;
+    load.assign(size_t(hi - lo + 1), 0.0);
+    states.resize(load.size());
+    auto bin = [&](const QString &date, double amount) {
+        const QDate d = QDate::fromString(date, "yyyy-MM-dd");
+        if (d.isValid()) load[size_t(d.toJulianDay() - first)] += amount;
+    };
+    for (auto &w : cardio) bin(w.date, cardioLoad(w));
+    for (auto &w : strength) bin(w.date, strengthLoad(w));
+    advanceFrom(0);
+}
+
+void TrainingLoad::advanceFrom(size_t i)
+{
+    LoadState prev = i == 0 ? LoadState() : states[i - 1];
+    for (size_t d = i; d < load.size(); ++d) {
+        const double x = load[d];
+        LoadState &cur = states[d];
+        for (int l = 0; l < 4; ++l) cur.s[l] = prev.s[l] + (x - prev.s[l]) * Gain[l];
+        prev = cur;
+    }
+}
+
+void TrainingLoad::ensureRange(qint64 jd)
+{
+    if (load.empty()) {
+        first = jd;
+        load.assign(1, 0.0);
+        states.assign(1, LoadState());
+        return;
+    }
+    if (jd < first) {
+        const size_t pad = size_t(first - jd);
+        load.insert(load.begin(), pad, 0.0);
+        states.insert(states.begin(), pad, LoadState());
+        first = jd;
+        advanceFrom(0);
+        return;
+    }
+    const size_t need = size_t(jd - first + 1);
+    if (need > load.size()) {
+        const size_t old = load.size();
+        load.resize(need, 0.0);
+        states.resize(need);
+        advanceFrom(old);
+    }
+}
+
+void TrainingLoad::addLoad(const QString &date, double amount)
+{
+    const QDate d = QDate::fromString(date, "yyyy-MM-dd");
+    if (!d.isValid()) return;
+    ensureRange(d.toJulianDay());
+    const size_t i = size_t(d.toJulianDay() - first);
+    load[i] += amount;
+    if (std::abs(load[i]) < 1e-9) load[i] = 0.0;
+    advanceFrom(i);
+}
+
+void TrainingLoad::extendTo(const QDate &day)
+{
+    if (!load.empty() && day.isValid()) ensureRange(day.toJulianDay());
+}
+
+LoadState TrainingLoad::at(const QDate &day) const
+{
+    if (states.empty() || !day.isValid()) return LoadState();
+    const qint64 i = day.toJulianDay() - first;
+    if (i < 0) return LoadState();
+    if (i < (qint64)states.size()) return states[size_t(i)];
+    // past the last stored day: rest days only decay the curves
+    LoadState st = states.back();
+    const double rest = double(i - (qint64)states.size() + 1);
+    for (int l = 0; l < 4; ++l) st.s[l] *= std::pow(1.0 - Gain[l], rest);
+    return st;
+}
+
+double TrainingLoad::loadOn(const QDate &day) const
+{
+    const qint64 i = day.toJulianDay() - first;
+    return (load.empty() || i < 0 || i >= (qint64)load.size()) ? 0.0 : load[size_t(i)];
+}
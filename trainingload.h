@@ -0,0 +1,59 @@
+#ifndef TRAININGLOAD_H
+#define TRAININGLOAD_H
+
+// FitTrack Pro - daily training load, acute:chronic workload ratio and fitness/fatigue (Banister) curve
+// Loads are binned per day; the four exponentially weighted averages share one update rule,
+// s = s * (1 - g) + load * g, and are advanced together as a 4-lane vector per day.
+#include <QDate>
+#include <vector>
+#include "models.h"
+
+struct LoadState {
+    double s[4] = {0, 0, 0, 0}; // acute (7d EWMA), chronic (28d EWMA), fitness (tau 42d), fatigue (tau 7d)
+    double acute() const { return s[0]; }
+    double chronic() const { return s[1]; }
+    double fitness() const { return s[2]; }
+    double fatigue() const { return s[3]; }
+    double form() const { return s[2] - s[3]; }
+    double acwr() const { return s[1] > 1e-6 ? s[0] / s[1] : 0.0; }
+};
+
+enum class LoadRisk { None, Low, Optimal, Caution, High };
+
+class TrainingLoad {
+public:
+    static constexpr double CautionAcwr = 1.3;
+    static constexpr double HighRiskAcwr = 1.5;
+
+    // load units: cardio ~ minutes x MET / 4, strength ~ volume / 100 + 2 per set
+    static double cardioLoad(const CardioWorkout &w);
+    static double strengthLoad(const StrengthWorkout &w);
+    static LoadRisk risk(const LoadState &st);
+
+    void clear() { first = 0; load.clear(); states.clear(); }
+    // Bins the whole history, then runs one pass over the days
+    void rebuild(const PersistentVector<CardioWorkout> &cardio, const PersistentVector<StrengthWorkout> &strength, const QDate &today);
+
+    // Incremental: only days from the workout's date onward are re-advanced (O(1) for today's entries)
+    void add(const CardioWorkout &w) { addLoad(w.date, cardioLoad(w)); }
+    void add(const StrengthWorkout &w) { addLoad(w.date, strengthLoad(w)); }
+    void remove(const CardioWorkout &w) { addLoad(w.date, -cardioLoad(w)); }
+    void remove(const StrengthWorkout &w) { addLoad(w.date, -strengthLoad(w)); }
+    void extendTo(const QDate &day); // carries the curves forward over rest days
+
+    bool isEmpty() const { return states.empty(); }
+    QDate firstDay() const { return QDate::fromJulianDay(first); }
+    LoadState at(const QDate &day) const;
+    double loadOn(const QDate &day) const;
+
+private:
+    void addLoad(const QString &date, double amount);
+    void ensureRange(qint64 jd);
+    void advanceFrom(size_t i);
+
+    qint64 first = 0;
+    std::vector<double> load;       // per day since `first`
+    std::vector<LoadState> states;  // state after each day's load
+};
+
+#endif // TRAININGLOAD_H